@@ -25,8 +25,8 @@ CTEST_INCLUDE_GEN(val)
  *       if no '/' detected, use entire filename. */
 #define currentFilename()                                                      \
     do {                                                                       \
-        char *filenameOnly = strrchr(__FILE__, '/');                           \
-        char *filePos = filenameOnly ? ++filenameOnly : __FILE__;              \
+        const char *filenameOnly = strrchr(__FILE__, '/');                     \
+        const char *filePos = filenameOnly ? ++filenameOnly : __FILE__;        \
         printf("%s:%s:%d\t", filePos, __func__, __LINE__);                     \
     } while (0)
 
@@ -53,6 +53,29 @@ CTEST_INCLUDE_GEN(val)
 #define TEST(name) printf("test — %s\n", name);
 #define TEST_DESC(name, ...) printf("test — " name "\n", __VA_ARGS__);
 
+/* Deterministic pseudo-random test data (splitmix64).  Each test picks its
+ * own sequence with ctestSeed(). */
+static inline uint64_t *ctestRandomState_(void) {
+    static uint64_t state = 0;
+    return &state;
+}
+
+static inline void ctestSeed(uint64_t seed) {
+    *ctestRandomState_() = seed;
+}
+
+static inline uint64_t ctestRandom(void) {
+    uint64_t z = (*ctestRandomState_() += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Random value of random bit length, so every varint width is common */
+static inline uint64_t ctestRandomWidth(void) {
+    return ctestRandom() >> (ctestRandom() % 64);
+}
+
 #define TEST_FINAL_RESULT                                                      \
     do {                                                                       \
         if (!err)                                                              \
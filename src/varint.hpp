@@ -0,0 +1,653 @@
+#pragma once
+
+/* ====================================================================
+ * Header-only C++ interface
+ * ==================================================================== */
+/* varint::codec<Encoding> encodes and decodes the same bytes as the C
+ * functions and macros for each encoding, but everything here is inline
+ * (and constexpr where the language allows), so call sites specialize on
+ * the encoding at compile time instead of calling into varint-static.
+ *
+ * Encodings:
+ *   varint::tagged          varintTaggedPut64() / varintTaggedGet64()
+ *   varint::chained         varintChainedPutVarint() / GetVarint()
+ *   varint::chained_simple  varintChainedSimpleEncode64() / Decode64()
+ *   varint::split_full      varintSplitFullPut_() / varintSplitFullGet_()
+ *   varint::external<W>     varintExternalPutFixedWidth() / Get() with
+ *                           a fixed width W (1 to 8 bytes, little endian)
+ *
+ * Every codec<E> provides:
+ *   max_length                  largest encoding in bytes
+ *   length(v)                   bytes needed to encode 'v'
+ *   length_of(src)              bytes used by the varint at 'src'
+ *   length_of(src, avail)       same, or 0 if the varint is invalid or
+ *                               doesn't end inside 'avail' bytes
+ *   encode(dst, v)              write 'v', return bytes written
+ *   decode(src, v)              read into 'v', return bytes read
+ *
+ * Bulk encode/decode take pointer + count, or std::span under C++20.
+ * decode_iterator and encode_iterator adapt a byte buffer to standard
+ * algorithms and range-for, decoding each value only when dereferenced. */
+
+#if __cplusplus < 201703L
+#error "varint.hpp requires C++17 or newer"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define VARINT_HPP_SPAN 1
+#endif
+
+namespace varint {
+
+struct tagged {};
+struct chained {};
+struct chained_simple {};
+struct split_full {};
+template <std::size_t Width>
+struct external {
+    static_assert(Width >= 1 && Width <= 8, "external width is 1 to 8 bytes");
+};
+
+template <typename Encoding>
+struct codec;
+
+namespace detail {
+/* Smallest number of bytes holding 'v' (at least 1) */
+constexpr std::size_t bytesFor(std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    while (v >>= 8) {
+        n++;
+    }
+
+    return n;
+}
+
+/* Smallest number of 7-bit groups holding 'v' (at least 1) */
+constexpr std::size_t groupsFor(std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    while (v >>= 7) {
+        n++;
+    }
+
+    return n;
+}
+
+/* Both chained formats end at the first byte without its high bit set,
+ * or at the 9th byte regardless. */
+constexpr std::size_t chainedLengthOf(const std::uint8_t *src,
+                                      std::size_t avail) noexcept {
+    const std::size_t limit = avail < 9 ? avail : 9;
+    for (std::size_t i = 0; i < limit; i++) {
+        if (!(src[i] & 0x80) || i == 8) {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+constexpr std::array<std::uint8_t, 256> taggedLengths() noexcept {
+    std::array<std::uint8_t, 256> t{};
+    for (std::size_t b = 0; b < 256; b++) {
+        t[b] = b <= 240 ? 1 : b <= 248 ? 2 : std::uint8_t(b - 246);
+    }
+
+    return t;
+}
+
+constexpr std::array<std::uint8_t, 256> splitFullLengths() noexcept {
+    std::array<std::uint8_t, 256> t{};
+    for (std::size_t b = 0; b < 0xc0; b++) {
+        t[b] = std::uint8_t(1 + (b >> 6));
+    }
+
+    /* 0xC0 and 0xC9 onward are unused */
+    for (std::size_t w = 1; w <= 8; w++) {
+        t[0xc0 + w] = std::uint8_t(1 + w);
+    }
+
+    return t;
+}
+} // namespace detail
+
+/* ====================================================================
+ * Tagged
+ * ==================================================================== */
+template <>
+struct codec<tagged> {
+    static constexpr std::size_t max_length = 9;
+
+    /* Encoded length indexed by first byte */
+    static constexpr std::array<std::uint8_t, 256> first_byte_length =
+        detail::taggedLengths();
+
+    static constexpr std::size_t length(std::uint64_t v) noexcept {
+        return v <= 240 ? 1
+                        : v <= 2287 ? 2
+                                    : v <= 67823 ? 3 : 1 + detail::bytesFor(v);
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src) noexcept {
+        return first_byte_length[src[0]];
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src,
+                                           std::size_t avail) noexcept {
+        if (!avail) {
+            return 0;
+        }
+
+        const std::size_t len = first_byte_length[src[0]];
+        return len <= avail ? len : 0;
+    }
+
+    static constexpr std::size_t encode(std::uint8_t *dst,
+                                        std::uint64_t v) noexcept {
+        if (v <= 240) {
+            dst[0] = std::uint8_t(v);
+            return 1;
+        }
+
+        if (v <= 2287) {
+            const std::uint64_t y = v - 240;
+            dst[0] = std::uint8_t(y / 256 + 241);
+            dst[1] = std::uint8_t(y % 256);
+            return 2;
+        }
+
+        if (v <= 67823) {
+            const std::uint64_t y = v - 2288;
+            dst[0] = 249;
+            dst[1] = std::uint8_t(y / 256);
+            dst[2] = std::uint8_t(y % 256);
+            return 3;
+        }
+
+        /* 250 through 255 prefix 3 through 8 big endian bytes */
+        const std::size_t n = detail::bytesFor(v);
+        dst[0] = std::uint8_t(247 + n);
+        for (std::size_t i = n; i > 0; i--) {
+            dst[i] = std::uint8_t(v);
+            v >>= 8;
+        }
+
+        return 1 + n;
+    }
+
+    static constexpr std::size_t decode(const std::uint8_t *src,
+                                        std::uint64_t &v) noexcept {
+        const std::uint8_t a0 = src[0];
+        if (a0 <= 240) {
+            v = a0;
+            return 1;
+        }
+
+        if (a0 <= 248) {
+            v = (a0 - 241U) * 256 + src[1] + 240;
+            return 2;
+        }
+
+        if (a0 == 249) {
+            v = 2288U + 256U * src[1] + src[2];
+            return 3;
+        }
+
+        const std::size_t n = a0 - 247U;
+        std::uint64_t result = 0;
+        for (std::size_t i = 1; i <= n; i++) {
+            result = (result << 8) | src[i];
+        }
+
+        v = result;
+        return 1 + n;
+    }
+};
+
+/* ====================================================================
+ * Chained (big endian groups, sqlite3 layout)
+ * ==================================================================== */
+template <>
+struct codec<chained> {
+    static constexpr std::size_t max_length = 9;
+
+    static constexpr std::size_t length(std::uint64_t v) noexcept {
+        const std::size_t n = detail::groupsFor(v);
+        return n > 9 ? 9 : n;
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src) noexcept {
+        return detail::chainedLengthOf(src, 9);
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src,
+                                           std::size_t avail) noexcept {
+        return detail::chainedLengthOf(src, avail);
+    }
+
+    static constexpr std::size_t encode(std::uint8_t *dst,
+                                        std::uint64_t v) noexcept {
+        if (v >> 56) {
+            /* 8 groups of 7 bits then a full final byte */
+            dst[8] = std::uint8_t(v);
+            v >>= 8;
+            for (std::size_t i = 8; i > 0; i--) {
+                dst[i - 1] = std::uint8_t((v & 0x7f) | 0x80);
+                v >>= 7;
+            }
+
+            return 9;
+        }
+
+        const std::size_t n = detail::groupsFor(v);
+        dst[n - 1] = std::uint8_t(v & 0x7f);
+        for (std::size_t i = n - 1; i > 0; i--) {
+            v >>= 7;
+            dst[i - 1] = std::uint8_t((v & 0x7f) | 0x80);
+        }
+
+        return n;
+    }
+
+    static constexpr std::size_t decode(const std::uint8_t *src,
+                                        std::uint64_t &v) noexcept {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            result = (result << 7) | (src[i] & 0x7f);
+            if (!(src[i] & 0x80)) {
+                v = result;
+                return i + 1;
+            }
+        }
+
+        v = (result << 8) | src[8];
+        return 9;
+    }
+};
+
+/* ====================================================================
+ * Chained Simple (little endian groups)
+ * ==================================================================== */
+template <>
+struct codec<chained_simple> {
+    static constexpr std::size_t max_length = 9;
+
+    static constexpr std::size_t length(std::uint64_t v) noexcept {
+        const std::size_t n = detail::groupsFor(v);
+        return n > 9 ? 9 : n;
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src) noexcept {
+        return detail::chainedLengthOf(src, 9);
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src,
+                                           std::size_t avail) noexcept {
+        return detail::chainedLengthOf(src, avail);
+    }
+
+    static constexpr std::size_t encode(std::uint8_t *dst,
+                                        std::uint64_t v) noexcept {
+        std::size_t i = 0;
+        for (; v >= 0x80 && i < 8; i++) {
+            dst[i] = std::uint8_t((v & 0x7f) | 0x80);
+            v >>= 7;
+        }
+
+        dst[i] = std::uint8_t(v);
+        return i + 1;
+    }
+
+    static constexpr std::size_t decode(const std::uint8_t *src,
+                                        std::uint64_t &v) noexcept {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            result |= std::uint64_t(src[i] & 0x7f) << (7 * i);
+            if (!(src[i] & 0x80)) {
+                v = result;
+                return i + 1;
+            }
+        }
+
+        v = result | (std::uint64_t(src[8]) << 56);
+        return 9;
+    }
+};
+
+/* ====================================================================
+ * SplitFull
+ * ==================================================================== */
+template <>
+struct codec<split_full> {
+    static constexpr std::size_t max_length = 9;
+    static constexpr std::uint64_t max_6 = 63;
+    static constexpr std::uint64_t max_14 = max_6 + 0x3fff;
+    static constexpr std::uint64_t max_22 = max_14 + 0x3fffff;
+
+    /* Encoded length indexed by first byte; 0 for unused type bytes */
+    static constexpr std::array<std::uint8_t, 256> first_byte_length =
+        detail::splitFullLengths();
+
+    /* External width of the value above max_22.  One byte widths are
+     * stored as two bytes so lengths only grow with the value, matching
+     * varintSplitFullLengthVAR_() without
+     * VARINT_SPLIT_FULL_USE_MAXIMUM_RANGE. */
+    static constexpr std::size_t externalWidth(std::uint64_t y) noexcept {
+        const std::size_t n = detail::bytesFor(y);
+        return n == 1 ? 2 : n;
+    }
+
+    static constexpr std::size_t length(std::uint64_t v) noexcept {
+        return v <= max_6    ? 1
+               : v <= max_14 ? 2
+               : v <= max_22 ? 3
+                             : 1 + externalWidth(v - max_22);
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src) noexcept {
+        return first_byte_length[src[0]];
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *src,
+                                           std::size_t avail) noexcept {
+        if (!avail) {
+            return 0;
+        }
+
+        const std::size_t len = first_byte_length[src[0]];
+        return len <= avail ? len : 0;
+    }
+
+    static constexpr std::size_t encode(std::uint8_t *dst,
+                                        std::uint64_t v) noexcept {
+        if (v <= max_6) {
+            dst[0] = std::uint8_t(v);
+            return 1;
+        }
+
+        if (v <= max_14) {
+            const std::uint64_t y = v - max_6;
+            dst[0] = std::uint8_t(0x40 | (y >> 8));
+            dst[1] = std::uint8_t(y);
+            return 2;
+        }
+
+        if (v <= max_22) {
+            const std::uint64_t y = v - max_14;
+            dst[0] = std::uint8_t(0x80 | (y >> 16));
+            dst[1] = std::uint8_t(y >> 8);
+            dst[2] = std::uint8_t(y);
+            return 3;
+        }
+
+        std::uint64_t y = v - max_22;
+        const std::size_t w = externalWidth(y);
+        dst[0] = std::uint8_t(0xc0 | w);
+        for (std::size_t i = 1; i <= w; i++) {
+            dst[i] = std::uint8_t(y);
+            y >>= 8;
+        }
+
+        return 1 + w;
+    }
+
+    static constexpr std::size_t decode(const std::uint8_t *src,
+                                        std::uint64_t &v) noexcept {
+        switch (src[0] >> 6) {
+        case 0:
+            v = src[0];
+            return 1;
+        case 1:
+            v = ((std::uint64_t(src[0] & 0x3f) << 8) | src[1]) + max_6;
+            return 2;
+        case 2:
+            v = ((std::uint64_t(src[0] & 0x3f) << 16) |
+                 (std::uint64_t(src[1]) << 8) | src[2]) +
+                max_14;
+            return 3;
+        default: {
+            const std::size_t w = src[0] & 0x0f;
+            std::uint64_t y = 0;
+            for (std::size_t i = w; i > 0; i--) {
+                y = (y << 8) | src[i];
+            }
+
+            v = y + max_22;
+            return 1 + w;
+        }
+        }
+    }
+};
+
+/* ====================================================================
+ * External (fixed width, little endian)
+ * ==================================================================== */
+template <std::size_t Width>
+struct codec<external<Width>> {
+    static_assert(Width >= 1 && Width <= 8, "external width is 1 to 8 bytes");
+    static constexpr std::size_t max_length = Width;
+
+    static constexpr std::size_t length(std::uint64_t) noexcept {
+        return Width;
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *) noexcept {
+        return Width;
+    }
+
+    static constexpr std::size_t length_of(const std::uint8_t *,
+                                           std::size_t avail) noexcept {
+        return avail >= Width ? Width : 0;
+    }
+
+    static constexpr std::size_t encode(std::uint8_t *dst,
+                                        std::uint64_t v) noexcept {
+        for (std::size_t i = 0; i < Width; i++) {
+            dst[i] = std::uint8_t(v >> (8 * i));
+        }
+
+        return Width;
+    }
+
+    static constexpr std::size_t decode(const std::uint8_t *src,
+                                        std::uint64_t &v) noexcept {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < Width; i++) {
+            result |= std::uint64_t(src[i]) << (8 * i);
+        }
+
+        v = result;
+        return Width;
+    }
+};
+
+/* ====================================================================
+ * Bulk encode and decode
+ * ==================================================================== */
+/* Bytes 'count' values may need at most. */
+template <typename E>
+constexpr std::size_t max_encoded_size(std::size_t count) noexcept {
+    return count * codec<E>::max_length;
+}
+
+/* Encode 'count' values back to back into 'dst' (which must hold
+ * max_encoded_size<E>(count) bytes).  Returns bytes written. */
+template <typename E>
+constexpr std::size_t encode(const std::uint64_t *values, std::size_t count,
+                             std::uint8_t *dst) noexcept {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        offset += codec<E>::encode(dst + offset, values[i]);
+    }
+
+    return offset;
+}
+
+struct decode_result {
+    std::size_t values; /* values decoded */
+    std::size_t bytes;  /* bytes consumed */
+};
+
+/* Decode up to 'count' values from 'len' bytes of 'src'.  Never reads
+ * past 'len': decoding stops early at a truncated or invalid varint. */
+template <typename E>
+constexpr decode_result decode(const std::uint8_t *src, std::size_t len,
+                               std::uint64_t *values,
+                               std::size_t count) noexcept {
+    std::size_t offset = 0;
+    std::size_t i = 0;
+    for (; i < count; i++) {
+        if (!codec<E>::length_of(src + offset, len - offset)) {
+            break;
+        }
+
+        offset += codec<E>::decode(src + offset, values[i]);
+    }
+
+    return {i, offset};
+}
+
+#ifdef VARINT_HPP_SPAN
+/* 'out' must hold max_encoded_size<E>(values.size()) bytes. */
+template <typename E>
+constexpr std::size_t encode(std::span<const std::uint64_t> values,
+                             std::span<std::uint8_t> out) noexcept {
+    return encode<E>(values.data(), values.size(), out.data());
+}
+
+template <typename E>
+constexpr decode_result decode(std::span<const std::uint8_t> in,
+                               std::span<std::uint64_t> values) noexcept {
+    return decode<E>(in.data(), in.size(), values.data(), values.size());
+}
+#endif
+
+/* ====================================================================
+ * Iterators
+ * ==================================================================== */
+/* Input iterator over encoded values.  Each value is decoded when
+ * dereferenced, so skipping with ++ only reads lengths.  The buffer must
+ * hold whole varints (check untrusted input with varintScanValidate()). */
+template <typename E>
+class decode_iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::uint64_t *;
+    using reference = std::uint64_t;
+
+    constexpr decode_iterator() noexcept = default;
+    constexpr explicit decode_iterator(const std::uint8_t *pos) noexcept
+        : pos_(pos) {
+    }
+
+    constexpr std::uint64_t operator*() const noexcept {
+        std::uint64_t v = 0;
+        codec<E>::decode(pos_, v);
+        return v;
+    }
+
+    constexpr decode_iterator &operator++() noexcept {
+        pos_ += codec<E>::length_of(pos_);
+        return *this;
+    }
+
+    constexpr decode_iterator operator++(int) noexcept {
+        decode_iterator prev = *this;
+        ++*this;
+        return prev;
+    }
+
+    constexpr const std::uint8_t *position() const noexcept {
+        return pos_;
+    }
+
+    friend constexpr bool operator==(const decode_iterator &a,
+                                     const decode_iterator &b) noexcept {
+        return a.pos_ == b.pos_;
+    }
+
+    friend constexpr bool operator!=(const decode_iterator &a,
+                                     const decode_iterator &b) noexcept {
+        return a.pos_ != b.pos_;
+    }
+
+  private:
+    const std::uint8_t *pos_ = nullptr;
+};
+
+/* Range of the values encoded in [begin, end) for range-for. */
+template <typename E>
+class decode_view {
+  public:
+    constexpr decode_view(const std::uint8_t *src, std::size_t len) noexcept
+        : begin_(src), end_(src + len) {
+    }
+
+#ifdef VARINT_HPP_SPAN
+    constexpr explicit decode_view(std::span<const std::uint8_t> in) noexcept
+        : decode_view(in.data(), in.size()) {
+    }
+#endif
+
+    constexpr decode_iterator<E> begin() const noexcept {
+        return decode_iterator<E>(begin_);
+    }
+
+    constexpr decode_iterator<E> end() const noexcept {
+        return decode_iterator<E>(end_);
+    }
+
+  private:
+    const std::uint8_t *begin_;
+    const std::uint8_t *end_;
+};
+
+/* Output iterator encoding each assigned value at the current position,
+ * e.g. std::copy(v.begin(), v.end(), encode_iterator<tagged>(buf)). */
+template <typename E>
+class encode_iterator {
+  public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    constexpr explicit encode_iterator(std::uint8_t *pos) noexcept
+        : pos_(pos) {
+    }
+
+    constexpr encode_iterator &operator=(std::uint64_t v) noexcept {
+        pos_ += codec<E>::encode(pos_, v);
+        return *this;
+    }
+
+    constexpr encode_iterator &operator*() noexcept {
+        return *this;
+    }
+
+    constexpr encode_iterator &operator++() noexcept {
+        return *this;
+    }
+
+    constexpr encode_iterator &operator++(int) noexcept {
+        return *this;
+    }
+
+    /* One past the last byte written */
+    constexpr std::uint8_t *position() const noexcept {
+        return pos_;
+    }
+
+  private:
+    std::uint8_t *pos_;
+};
+
+} // namespace varint
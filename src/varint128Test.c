@@ -0,0 +1,132 @@
+#include "varintChainedSimple.h"
+#include "varintSplitFull.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#define COUNT 20000
+
+/* Random value of random bit width (0 to 128 bits) */
+static __uint128_t randomValue(void) {
+    const __uint128_t v = ((__uint128_t)ctestRandom() << 64) | ctestRandom();
+    const uint32_t bits = ctestRandom() % 129;
+    return bits == 128 ? v : v & ((((__uint128_t)1) << bits) - 1);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(13);
+
+    static __uint128_t vals[COUNT];
+    static __uint128_t decoded[COUNT];
+    static uint8_t buf[COUNT * 19];
+    for (size_t i = 0; i < COUNT; i++) {
+        vals[i] = randomValue();
+    }
+
+    /* Boundaries of every width */
+    vals[0] = 0;
+    vals[1] = VARINT_TAGGED128_MAX_1;
+    vals[2] = VARINT_TAGGED128_MAX_1 + 1;
+    vals[3] = VARINT_TAGGED128_MAX_2;
+    vals[4] = VARINT_TAGGED128_MAX_2 + 1;
+    vals[5] = VARINT_TAGGED128_MAX_3;
+    vals[6] = VARINT_TAGGED128_MAX_3 + 1;
+    vals[7] = UINT64_MAX;
+    vals[8] = (__uint128_t)UINT64_MAX + 1;
+    vals[9] = ~(__uint128_t)0;
+
+    TEST("Tagged128 round trips and sorts by memcmp") {
+        uint8_t prev[17] = {0};
+        __uint128_t prevVal = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            uint8_t z[17];
+            const varintWidth len = varintTaggedPut128(z, vals[i]);
+            __uint128_t out;
+            if (len != varintTaggedLen128(vals[i]) ||
+                len != (varintWidth)varintTaggedGetLen128Quick_(z) ||
+                varintTaggedGet128(z, &out) != len || out != vals[i]) {
+                ERR("Tagged128 value %zu failed round trip!", i);
+            }
+
+            /* Different lengths always differ in the first byte */
+            const int cmp = memcmp(z, prev, len);
+            if (i && ((vals[i] < prevVal && cmp >= 0) ||
+                      (vals[i] > prevVal && cmp <= 0))) {
+                ERR("Tagged128 value %zu sorts out of order!", i);
+            }
+
+            memcpy(prev, z, len);
+            prevVal = vals[i];
+        }
+
+        const size_t len = varintTaggedPut128Array(buf, vals, COUNT);
+        if (varintTaggedGet128Array(buf, decoded, COUNT) != len ||
+            memcmp(decoded, vals, sizeof(vals))) {
+            ERRR("Tagged128 bulk round trip failed!");
+        }
+    }
+
+    TEST("ChainedSimple128 round trips and matches the 64-bit form") {
+        for (size_t i = 0; i < COUNT; i++) {
+            uint8_t z[19];
+            const varintWidth len = varintChainedSimpleEncode128(z, vals[i]);
+            __uint128_t out;
+            if (len != varintChainedSimpleLength128(vals[i]) ||
+                varintChainedSimpleDecode128(z, &out) != len ||
+                out != vals[i]) {
+                ERR("ChainedSimple128 value %zu failed round trip!", i);
+            }
+
+            if (vals[i] < ((uint64_t)1 << 63)) {
+                uint8_t z64[9];
+                uint64_t out64;
+                if (varintChainedSimpleEncode64(z64, (uint64_t)vals[i]) !=
+                        len ||
+                    memcmp(z, z64, len) ||
+                    varintChainedSimpleDecode64(z, &out64) != len ||
+                    out64 != vals[i]) {
+                    ERR("ChainedSimple128 value %zu differs from 64-bit!",
+                        i);
+                }
+            }
+        }
+
+        const size_t len = varintChainedSimpleEncode128Array(buf, vals, COUNT);
+        if (varintChainedSimpleDecode128Array(buf, decoded, COUNT) != len ||
+            memcmp(decoded, vals, sizeof(vals))) {
+            ERRR("ChainedSimple128 bulk round trip failed!");
+        }
+    }
+
+    TEST("SplitFull128 round trips and extends SplitFull") {
+        for (size_t i = 0; i < COUNT; i++) {
+            uint8_t z[17];
+            varintWidth len = 0;
+            varintWidth expectLen = 0;
+            varintWidth gotLen = 0;
+            __uint128_t out = 0;
+            varintSplitFull128Put_(z, len, vals[i]);
+            varintSplitFull128Length_(expectLen, vals[i]);
+            varintSplitFull128Get_(z, gotLen, out);
+            if (len != expectLen || gotLen != len ||
+                varintSplitFull128GetLenQuick_(z) != len || out != vals[i]) {
+                ERR("SplitFull128 value %zu failed round trip!", i);
+            }
+
+            if (vals[i] <= UINT64_MAX) {
+                uint8_t z64[9];
+                varintWidth len64 = 0;
+                varintSplitFullPut_(z64, len64, (uint64_t)vals[i]);
+                if (len64 != len || memcmp(z, z64, len)) {
+                    ERR("SplitFull128 value %zu differs from SplitFull!", i);
+                }
+            }
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,290 @@
+#include "varintAggregate.h"
+#include "varintTagged.h"
+
+/* ====================================================================
+ * Inline single value decoders
+ * ==================================================================== */
+/* Tagged decoding uses the varintTagged.h quick macros; the Chained
+ * decoders mirror varintChainedGetVarint() and varintChainedSimpleDecode64(),
+ * but live here as static inline functions so each kernel loop inlines them
+ * and the decoded value never leaves a register. */
+static inline size_t varintAggregateDecodeTagged_(const uint8_t *p,
+                                                  uint64_t *v) {
+    *v = varintTaggedGet64Quick_(p);
+    return varintTaggedGetLenQuick_(p);
+}
+
+/* Chained: big endian 7 bit groups; a 9th byte holds a full 8 bits. */
+static inline size_t varintAggregateDecodeChained_(const uint8_t *p,
+                                                   uint64_t *v) {
+    uint64_t x = 0;
+    for (size_t i = 0; i < 8; i++) {
+        x = (x << 7) | (p[i] & 0x7f);
+        if (!(p[i] & 0x80)) {
+            *v = x;
+            return i + 1;
+        }
+    }
+
+    *v = (x << 8) | p[8];
+    return 9;
+}
+
+/* ChainedSimple: little endian 7 bit groups; a 9th byte holds 8 bits. */
+static inline size_t varintAggregateDecodeChainedSimple_(const uint8_t *p,
+                                                         uint64_t *v) {
+    uint64_t x = 0;
+    for (size_t i = 0; i < 8; i++) {
+        x |= (uint64_t)(p[i] & 0x7f) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            *v = x;
+            return i + 1;
+        }
+    }
+
+    *v = x | ((uint64_t)p[8] << 56);
+    return 9;
+}
+
+/* Both chained formats end at the first byte without its high bit set,
+ * or after 9 bytes. */
+static inline size_t varintAggregateLenChained_(const uint8_t *p) {
+    for (size_t i = 0; i < 8; i++) {
+        if (!(p[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+
+    return 9;
+}
+
+/* External decoders are generated per width so the byte count is a
+ * compile-time constant and the loads merge into one or two loads. */
+#define VARINT_AGGREGATE_EXTERNAL_DECODE_(w)                                   \
+    static inline size_t varintAggregateDecodeExternal##w##_(                  \
+        const uint8_t *p, uint64_t *v) {                                       \
+        uint64_t x = 0;                                                        \
+        for (size_t i = 0; i < (w); i++) {                                     \
+            x |= (uint64_t)p[i] << (8 * i);                                    \
+        }                                                                      \
+                                                                               \
+        *v = x;                                                                \
+        return (w);                                                            \
+    }
+
+VARINT_AGGREGATE_EXTERNAL_DECODE_(1)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(2)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(3)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(4)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(5)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(6)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(7)
+VARINT_AGGREGATE_EXTERNAL_DECODE_(8)
+
+/* ====================================================================
+ * Kernel generator
+ * ==================================================================== */
+/* Range tests use one unsigned comparison: (v - lo) <= (hi - lo).
+ * Filter builds each bitmap word in a register and stores it once. */
+#define VARINT_AGGREGATE_KERNELS_(linkage, name, decode)                       \
+    linkage uint64_t varintAggregateSum##name(const uint8_t *src,              \
+                                              size_t count) {                  \
+        uint64_t sum = 0;                                                      \
+        for (size_t i = 0; i < count; i++) {                                   \
+            uint64_t v;                                                        \
+            src += decode(src, &v);                                            \
+            sum += v;                                                          \
+        }                                                                      \
+                                                                               \
+        return sum;                                                            \
+    }                                                                          \
+                                                                               \
+    linkage void varintAggregateMinMax##name(const uint8_t *src,               \
+                                             size_t count, uint64_t *min,      \
+                                             uint64_t *max) {                  \
+        uint64_t lowest = UINT64_MAX;                                          \
+        uint64_t highest = 0;                                                  \
+        for (size_t i = 0; i < count; i++) {                                   \
+            uint64_t v;                                                        \
+            src += decode(src, &v);                                            \
+            lowest = v < lowest ? v : lowest;                                  \
+            highest = v > highest ? v : highest;                               \
+        }                                                                      \
+                                                                               \
+        *min = lowest;                                                         \
+        *max = highest;                                                        \
+    }                                                                          \
+                                                                               \
+    linkage size_t varintAggregateCountRange##name(                            \
+        const uint8_t *src, size_t count, uint64_t lo, uint64_t hi) {          \
+        const uint64_t span = hi - lo;                                         \
+        size_t matches = 0;                                                    \
+        if (hi < lo) {                                                         \
+            return 0;                                                          \
+        }                                                                      \
+                                                                               \
+        for (size_t i = 0; i < count; i++) {                                   \
+            uint64_t v;                                                        \
+            src += decode(src, &v);                                            \
+            matches += (v - lo) <= span;                                       \
+        }                                                                      \
+                                                                               \
+        return matches;                                                        \
+    }                                                                          \
+                                                                               \
+    linkage size_t varintAggregateFilter##name(                                \
+        const uint8_t *src, size_t count, uint64_t lo, uint64_t hi,            \
+        uint64_t *bitmap) {                                                    \
+        const uint64_t span = hi - lo;                                         \
+        const bool empty = hi < lo;                                            \
+        size_t matches = 0;                                                    \
+        for (size_t base = 0; base < count; base += 64) {                      \
+            const size_t n = count - base < 64 ? count - base : 64;            \
+            uint64_t word = 0;                                                 \
+            for (size_t i = 0; i < n; i++) {                                   \
+                uint64_t v;                                                    \
+                src += decode(src, &v);                                        \
+                word |= (uint64_t)((v - lo) <= span) << i;                     \
+            }                                                                  \
+                                                                               \
+            word = empty ? 0 : word;                                           \
+            bitmap[base / 64] = word;                                          \
+            matches += __builtin_popcountll(word);                             \
+        }                                                                      \
+                                                                               \
+        return matches;                                                        \
+    }
+
+VARINT_AGGREGATE_KERNELS_(, Tagged, varintAggregateDecodeTagged_)
+VARINT_AGGREGATE_KERNELS_(, Chained, varintAggregateDecodeChained_)
+VARINT_AGGREGATE_KERNELS_(, ChainedSimple,
+                          varintAggregateDecodeChainedSimple_)
+
+size_t varintAggregateCountTagged(const uint8_t *src, size_t len) {
+    const uint8_t *end = src + len;
+    size_t count = 0;
+    while (src < end) {
+        src += varintTaggedGetLenQuick_(src);
+        count++;
+    }
+
+    return count;
+}
+
+size_t varintAggregateCountChained(const uint8_t *src, size_t len) {
+    const uint8_t *end = src + len;
+    size_t count = 0;
+    while (src < end) {
+        src += varintAggregateLenChained_(src);
+        count++;
+    }
+
+    return count;
+}
+
+size_t varintAggregateCountChainedSimple(const uint8_t *src, size_t len) {
+    return varintAggregateCountChained(src, len);
+}
+
+/* ====================================================================
+ * External (fixed width) kernels
+ * ==================================================================== */
+VARINT_AGGREGATE_KERNELS_(static, External1_,
+                          varintAggregateDecodeExternal1_)
+VARINT_AGGREGATE_KERNELS_(static, External2_,
+                          varintAggregateDecodeExternal2_)
+VARINT_AGGREGATE_KERNELS_(static, External3_,
+                          varintAggregateDecodeExternal3_)
+VARINT_AGGREGATE_KERNELS_(static, External4_,
+                          varintAggregateDecodeExternal4_)
+VARINT_AGGREGATE_KERNELS_(static, External5_,
+                          varintAggregateDecodeExternal5_)
+VARINT_AGGREGATE_KERNELS_(static, External6_,
+                          varintAggregateDecodeExternal6_)
+VARINT_AGGREGATE_KERNELS_(static, External7_,
+                          varintAggregateDecodeExternal7_)
+VARINT_AGGREGATE_KERNELS_(static, External8_,
+                          varintAggregateDecodeExternal8_)
+
+/* Dispatch once on 'width' to the kernel specialized for that width.
+ * 'CALL_(w)' is defined by each caller; an invalid width calls nothing, so
+ * the caller's initial result is returned. */
+#define VARINT_AGGREGATE_EXTERNAL_SWITCH_(width)                               \
+    do {                                                                       \
+        switch (width) {                                                       \
+        case VARINT_WIDTH_8B:                                                  \
+            CALL_(1);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_16B:                                                 \
+            CALL_(2);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_24B:                                                 \
+            CALL_(3);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_32B:                                                 \
+            CALL_(4);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_40B:                                                 \
+            CALL_(5);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_48B:                                                 \
+            CALL_(6);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_56B:                                                 \
+            CALL_(7);                                                          \
+            break;                                                             \
+        case VARINT_WIDTH_64B:                                                 \
+            CALL_(8);                                                          \
+            break;                                                             \
+        default:                                                               \
+            break;                                                             \
+        }                                                                      \
+    } while (0)
+
+uint64_t varintAggregateSumExternal(const uint8_t *src, varintWidth width,
+                                    size_t count) {
+    uint64_t sum = 0;
+#define CALL_(w) sum = varintAggregateSumExternal##w##_(src, count)
+    VARINT_AGGREGATE_EXTERNAL_SWITCH_(width);
+#undef CALL_
+    return sum;
+}
+
+void varintAggregateMinMaxExternal(const uint8_t *src, varintWidth width,
+                                   size_t count, uint64_t *min,
+                                   uint64_t *max) {
+    *min = UINT64_MAX;
+    *max = 0;
+#define CALL_(w) varintAggregateMinMaxExternal##w##_(src, count, min, max)
+    VARINT_AGGREGATE_EXTERNAL_SWITCH_(width);
+#undef CALL_
+}
+
+size_t varintAggregateCountExternal(const uint8_t *src, varintWidth width,
+                                    size_t len) {
+    (void)src;
+    return width >= VARINT_WIDTH_8B && width <= VARINT_WIDTH_64B ? len / width
+                                                                 : 0;
+}
+
+size_t varintAggregateCountRangeExternal(const uint8_t *src,
+                                         varintWidth width, size_t count,
+                                         uint64_t lo, uint64_t hi) {
+    size_t matches = 0;
+#define CALL_(w)                                                               \
+    matches = varintAggregateCountRangeExternal##w##_(src, count, lo, hi)
+    VARINT_AGGREGATE_EXTERNAL_SWITCH_(width);
+#undef CALL_
+    return matches;
+}
+
+size_t varintAggregateFilterExternal(const uint8_t *src, varintWidth width,
+                                     size_t count, uint64_t lo, uint64_t hi,
+                                     uint64_t *bitmap) {
+    size_t matches = 0;
+#define CALL_(w)                                                               \
+    matches = varintAggregateFilterExternal##w##_(src, count, lo, hi, bitmap)
+    VARINT_AGGREGATE_EXTERNAL_SWITCH_(width);
+#undef CALL_
+    return matches;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Fused decode-and-aggregate kernels
+ * ==================================================================== */
+/* Each kernel walks an encoded stream of 'count' back-to-back varints and
+ * aggregates values as they are decoded, so no intermediate uint64_t array
+ * is ever written.
+ *
+ * Streams are: Tagged (varintTaggedPut64), Chained (varintChainedPutVarint),
+ * ChainedSimple (varintChainedSimpleEncode64), or External where every
+ * value uses the same 'width' (varintExternalPutFixedWidth).
+ *
+ * Sum wraps modulo 2^64.
+ * MinMax of an empty stream sets 'min' to UINT64_MAX and 'max' to 0.
+ * Count returns the number of varints stored in 'len' bytes.
+ * CountRange and Filter match values in the closed range [lo, hi].
+ * Filter sets bit (i % 64) of bitmap[i / 64] for each matching value i;
+ * bitmap must hold (count + 63) / 64 words and every word is written.
+ * External kernels given a width outside 1 to 8 bytes aggregate nothing:
+ * they return 0 (MinMax reports an empty stream, Filter writes no words). */
+
+#define VARINT_AGGREGATE_BITMAP_WORDS(count) (((count) + 63) / 64)
+
+uint64_t varintAggregateSumTagged(const uint8_t *src, size_t count);
+void varintAggregateMinMaxTagged(const uint8_t *src, size_t count,
+                                 uint64_t *min, uint64_t *max);
+size_t varintAggregateCountTagged(const uint8_t *src, size_t len);
+size_t varintAggregateCountRangeTagged(const uint8_t *src, size_t count,
+                                       uint64_t lo, uint64_t hi);
+size_t varintAggregateFilterTagged(const uint8_t *src, size_t count,
+                                   uint64_t lo, uint64_t hi,
+                                   uint64_t *bitmap);
+
+uint64_t varintAggregateSumChained(const uint8_t *src, size_t count);
+void varintAggregateMinMaxChained(const uint8_t *src, size_t count,
+                                  uint64_t *min, uint64_t *max);
+size_t varintAggregateCountChained(const uint8_t *src, size_t len);
+size_t varintAggregateCountRangeChained(const uint8_t *src, size_t count,
+                                        uint64_t lo, uint64_t hi);
+size_t varintAggregateFilterChained(const uint8_t *src, size_t count,
+                                    uint64_t lo, uint64_t hi,
+                                    uint64_t *bitmap);
+
+uint64_t varintAggregateSumChainedSimple(const uint8_t *src, size_t count);
+void varintAggregateMinMaxChainedSimple(const uint8_t *src, size_t count,
+                                        uint64_t *min, uint64_t *max);
+size_t varintAggregateCountChainedSimple(const uint8_t *src, size_t len);
+size_t varintAggregateCountRangeChainedSimple(const uint8_t *src,
+                                              size_t count, uint64_t lo,
+                                              uint64_t hi);
+size_t varintAggregateFilterChainedSimple(const uint8_t *src, size_t count,
+                                          uint64_t lo, uint64_t hi,
+                                          uint64_t *bitmap);
+
+uint64_t varintAggregateSumExternal(const uint8_t *src, varintWidth width,
+                                    size_t count);
+void varintAggregateMinMaxExternal(const uint8_t *src, varintWidth width,
+                                   size_t count, uint64_t *min,
+                                   uint64_t *max);
+size_t varintAggregateCountExternal(const uint8_t *src, varintWidth width,
+                                    size_t len);
+size_t varintAggregateCountRangeExternal(const uint8_t *src,
+                                         varintWidth width, size_t count,
+                                         uint64_t lo, uint64_t hi);
+size_t varintAggregateFilterExternal(const uint8_t *src, varintWidth width,
+                                     size_t count, uint64_t lo, uint64_t hi,
+                                     uint64_t *bitmap);
+
+__END_DECLS
@@ -0,0 +1,196 @@
+#include "varintAggregate.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintExternal.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 1000
+
+typedef struct reference {
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    size_t inRange;
+    uint64_t bitmap[VARINT_AGGREGATE_BITMAP_WORDS(COUNT)];
+} reference;
+
+static void buildReference(const uint64_t *vals, size_t count, uint64_t lo,
+                           uint64_t hi, reference *ref) {
+    memset(ref, 0, sizeof(*ref));
+    ref->min = UINT64_MAX;
+    for (size_t i = 0; i < count; i++) {
+        ref->sum += vals[i];
+        ref->min = vals[i] < ref->min ? vals[i] : ref->min;
+        ref->max = vals[i] > ref->max ? vals[i] : ref->max;
+        if (vals[i] >= lo && vals[i] <= hi) {
+            ref->inRange++;
+            ref->bitmap[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+
+    static uint64_t vals[COUNT];
+    static uint8_t stream[COUNT * 9];
+    uint64_t bitmap[VARINT_AGGREGATE_BITMAP_WORDS(COUNT)];
+    ctestSeed(3);
+    for (size_t i = 0; i < COUNT; i++) {
+        /* Spread values over every encoded width */
+        vals[i] = ctestRandomWidth();
+    }
+
+    const uint64_t lo = 200;
+    const uint64_t hi = 5000000;
+    reference ref;
+    buildReference(vals, COUNT, lo, hi, &ref);
+
+    TEST("tagged kernels match decoded values") {
+        size_t len = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            len += varintTaggedPut64(stream + len, vals[i]);
+        }
+
+        uint64_t min;
+        uint64_t max;
+        varintAggregateMinMaxTagged(stream, COUNT, &min, &max);
+        if (varintAggregateSumTagged(stream, COUNT) != ref.sum ||
+            min != ref.min || max != ref.max) {
+            ERRR("Tagged sum/min/max mismatch!");
+        }
+
+        if (varintAggregateCountTagged(stream, len) != COUNT) {
+            ERRR("Tagged count mismatch!");
+        }
+
+        if (varintAggregateCountRangeTagged(stream, COUNT, lo, hi) !=
+                ref.inRange ||
+            varintAggregateFilterTagged(stream, COUNT, lo, hi, bitmap) !=
+                ref.inRange ||
+            memcmp(bitmap, ref.bitmap, sizeof(bitmap))) {
+            ERRR("Tagged range/filter mismatch!");
+        }
+    }
+
+    TEST("chained kernels match decoded values") {
+        size_t len = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            len += varintChainedPutVarint(stream + len, vals[i]);
+        }
+
+        uint64_t min;
+        uint64_t max;
+        varintAggregateMinMaxChained(stream, COUNT, &min, &max);
+        if (varintAggregateSumChained(stream, COUNT) != ref.sum ||
+            min != ref.min || max != ref.max) {
+            ERRR("Chained sum/min/max mismatch!");
+        }
+
+        if (varintAggregateCountChained(stream, len) != COUNT) {
+            ERRR("Chained count mismatch!");
+        }
+
+        if (varintAggregateCountRangeChained(stream, COUNT, lo, hi) !=
+                ref.inRange ||
+            varintAggregateFilterChained(stream, COUNT, lo, hi, bitmap) !=
+                ref.inRange ||
+            memcmp(bitmap, ref.bitmap, sizeof(bitmap))) {
+            ERRR("Chained range/filter mismatch!");
+        }
+    }
+
+    TEST("chained simple kernels match decoded values") {
+        size_t len = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            len += varintChainedSimpleEncode64(stream + len, vals[i]);
+        }
+
+        uint64_t min;
+        uint64_t max;
+        varintAggregateMinMaxChainedSimple(stream, COUNT, &min, &max);
+        if (varintAggregateSumChainedSimple(stream, COUNT) != ref.sum ||
+            min != ref.min || max != ref.max) {
+            ERRR("ChainedSimple sum/min/max mismatch!");
+        }
+
+        if (varintAggregateCountChainedSimple(stream, len) != COUNT) {
+            ERRR("ChainedSimple count mismatch!");
+        }
+
+        if (varintAggregateCountRangeChainedSimple(stream, COUNT, lo, hi) !=
+                ref.inRange ||
+            varintAggregateFilterChainedSimple(stream, COUNT, lo, hi,
+                                               bitmap) != ref.inRange ||
+            memcmp(bitmap, ref.bitmap, sizeof(bitmap))) {
+            ERRR("ChainedSimple range/filter mismatch!");
+        }
+    }
+
+    TEST("external kernels match decoded values at every width") {
+        static uint64_t truncated[COUNT];
+        for (varintWidth w = VARINT_WIDTH_8B; w <= VARINT_WIDTH_64B; w++) {
+            const uint64_t mask = w == 8 ? UINT64_MAX : (1ULL << (8 * w)) - 1;
+            for (size_t i = 0; i < COUNT; i++) {
+                truncated[i] = vals[i] & mask;
+                varintExternalPutFixedWidth(stream + i * w, truncated[i], w);
+            }
+
+            reference wref;
+            buildReference(truncated, COUNT, lo, hi, &wref);
+
+            uint64_t min;
+            uint64_t max;
+            varintAggregateMinMaxExternal(stream, w, COUNT, &min, &max);
+            if (varintAggregateSumExternal(stream, w, COUNT) != wref.sum ||
+                min != wref.min || max != wref.max) {
+                ERR("External width %d sum/min/max mismatch!", w);
+            }
+
+            if (varintAggregateCountExternal(stream, w, COUNT * w) != COUNT) {
+                ERR("External width %d count mismatch!", w);
+            }
+
+            if (varintAggregateCountRangeExternal(stream, w, COUNT, lo, hi) !=
+                    wref.inRange ||
+                varintAggregateFilterExternal(stream, w, COUNT, lo, hi,
+                                              bitmap) != wref.inRange ||
+                memcmp(bitmap, wref.bitmap, sizeof(bitmap))) {
+                ERR("External width %d range/filter mismatch!", w);
+            }
+        }
+    }
+
+    TEST("empty inputs and empty ranges") {
+        uint64_t min;
+        uint64_t max;
+        varintAggregateMinMaxTagged(stream, 0, &min, &max);
+        if (min != UINT64_MAX || max != 0 ||
+            varintAggregateSumTagged(stream, 0) != 0) {
+            ERRR("Empty stream aggregates are wrong!");
+        }
+
+        if (varintAggregateCountRangeChained(stream, COUNT, 10, 5) ||
+            varintAggregateFilterChained(stream, COUNT, 10, 5, bitmap)) {
+            ERRR("Inverted range matched values!");
+        }
+
+        if (varintAggregateSumExternal(stream, 0, COUNT) ||
+            varintAggregateCountExternal(stream, 9, COUNT) ||
+            varintAggregateCountRangeExternal(stream, 9, COUNT, 0,
+                                              UINT64_MAX) ||
+            varintAggregateFilterExternal(stream, 0, COUNT, 0, UINT64_MAX,
+                                          bitmap)) {
+            ERRR("Invalid External width aggregated values!");
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,154 @@
+#include "varintBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_CAPACITY 64
+
+void varintBufferInit(varintBuffer *b, const varintBufferAllocator *allocator) {
+    memset(b, 0, sizeof(*b));
+    b->allocator = allocator;
+}
+
+static void varintBufferRelease_(varintBuffer *b) {
+    if (!b->allocator) {
+        free(b->data);
+    } else if (b->allocator->release && b->data) {
+        b->allocator->release(b->allocator->ctx, b->data, b->capacity);
+    }
+}
+
+void varintBufferFree(varintBuffer *b) {
+    varintBufferRelease_(b);
+    b->data = NULL;
+    b->len = 0;
+    b->capacity = 0;
+}
+
+bool varintBufferGrow_(varintBuffer *b, size_t extra) {
+    if (extra > SIZE_MAX - b->len) {
+        return false;
+    }
+
+    /* Double so appending n bytes costs O(n) copying in total */
+    const size_t needed = b->len + extra;
+    size_t capacity = b->capacity ? b->capacity : MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity = capacity > SIZE_MAX / 2 ? needed : capacity * 2;
+    }
+
+    uint8_t *data;
+    if (!b->allocator) {
+        data = realloc(b->data, capacity);
+        if (!data) {
+            return false;
+        }
+    } else {
+        data = b->allocator->alloc(b->allocator->ctx, capacity);
+        if (!data) {
+            return false;
+        }
+
+        if (b->len) {
+            memcpy(data, b->data, b->len);
+        }
+
+        varintBufferRelease_(b);
+    }
+
+    b->data = data;
+    b->capacity = capacity;
+    return true;
+}
+
+size_t varintBufferEncodedBytes(varintBufferFormat format,
+                                const uint64_t *values, size_t count) {
+    size_t bytes = 0;
+    switch (format) {
+    case VARINT_BUFFER_TAGGED:
+        for (size_t i = 0; i < count; i++) {
+            bytes += varintTaggedLenQuick(values[i]);
+        }
+        break;
+    case VARINT_BUFFER_CHAINED:
+        for (size_t i = 0; i < count; i++) {
+            bytes += varintChainedVarintLen(values[i]);
+        }
+        break;
+    case VARINT_BUFFER_CHAINED_SIMPLE:
+        for (size_t i = 0; i < count; i++) {
+            bytes += varintChainedSimpleLength(values[i]);
+        }
+        break;
+    case VARINT_BUFFER_SPLIT_FULL:
+        for (size_t i = 0; i < count; i++) {
+            varintWidth width;
+            varintSplitFullLength_(width, values[i]);
+            bytes += width;
+        }
+        break;
+    case VARINT_BUFFER_PREFIX:
+        for (size_t i = 0; i < count; i++) {
+            bytes += varintPrefixLen(values[i]);
+        }
+        break;
+    }
+
+    return bytes;
+}
+
+bool varintBufferPutArray(varintBuffer *b, varintBufferFormat format,
+                          const uint64_t *values, size_t count) {
+    /* Size exactly only when the worst case doesn't already fit, so
+     * appends into a warm buffer never pay for the extra pass */
+    const bool fits = count <= (SIZE_MAX - b->len) / VARINT_BUFFER_PUT_MAX &&
+                      b->capacity - b->len >= count * VARINT_BUFFER_PUT_MAX;
+    if (!fits && !varintBufferReserve(
+                     b, varintBufferEncodedBytes(format, values, count))) {
+        return false;
+    }
+
+    /* One loop per format so the format switch isn't in the loop */
+    switch (format) {
+    case VARINT_BUFFER_TAGGED:
+        for (size_t i = 0; i < count; i++) {
+            varintBufferPutQuick_(b, VARINT_BUFFER_TAGGED, values[i]);
+        }
+        break;
+    case VARINT_BUFFER_CHAINED:
+        for (size_t i = 0; i < count; i++) {
+            varintBufferPutQuick_(b, VARINT_BUFFER_CHAINED, values[i]);
+        }
+        break;
+    case VARINT_BUFFER_CHAINED_SIMPLE:
+        for (size_t i = 0; i < count; i++) {
+            varintBufferPutQuick_(b, VARINT_BUFFER_CHAINED_SIMPLE, values[i]);
+        }
+        break;
+    case VARINT_BUFFER_SPLIT_FULL:
+        for (size_t i = 0; i < count; i++) {
+            varintBufferPutQuick_(b, VARINT_BUFFER_SPLIT_FULL, values[i]);
+        }
+        break;
+    case VARINT_BUFFER_PREFIX:
+        for (size_t i = 0; i < count; i++) {
+            varintBufferPutQuick_(b, VARINT_BUFFER_PREFIX, values[i]);
+        }
+        break;
+    }
+
+    return true;
+}
+
+bool varintBufferAppend(varintBuffer *b, const void *p, size_t len) {
+    if (!varintBufferReserve(b, len)) {
+        return false;
+    }
+
+    if (len) {
+        memcpy(b->data + b->len, p, len);
+        b->len += len;
+    }
+
+    return true;
+}
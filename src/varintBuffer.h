@@ -0,0 +1,123 @@
+#pragma once
+
+#include "varint.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintPrefix.h"
+#include "varintSplitFull.h"
+#include "varintTagged.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Growable output buffers
+ * ==================================================================== */
+/* Put functions write to a raw pointer with no capacity, so callers
+ * either over-allocate or check for room before every value.  A
+ * varintBuffer tracks capacity and grows geometrically, and splits
+ * appending into:
+ *   - varintBufferReserve(): one capacity check (growing if needed)
+ *   - varintBufferPutQuick_(): unchecked append of one value, valid for
+ *     as many values as reserved room for (VARINT_BUFFER_PUT_MAX each)
+ *   - varintBufferPut() / varintBufferPutArray(): checked appends; an
+ *     array is checked once, not per value, and sized exactly when it
+ *     doesn't already fit in the worst case.
+ *
+ * Storage comes from malloc() unless the buffer is given an allocator
+ * (for example an arena), which only needs to allocate: the buffer moves
+ * its own bytes when it grows. */
+
+typedef enum varintBufferFormat {
+    VARINT_BUFFER_TAGGED = 0,     /* varintTaggedPut64() */
+    VARINT_BUFFER_CHAINED,        /* varintChainedPutVarint() */
+    VARINT_BUFFER_CHAINED_SIMPLE, /* varintChainedSimpleEncode64() */
+    VARINT_BUFFER_SPLIT_FULL,     /* varintSplitFullPut_() */
+    VARINT_BUFFER_PREFIX,         /* varintPrefixPut() */
+} varintBufferFormat;
+
+/* Largest single value in any format (Chained needs 9 bytes too) */
+#define VARINT_BUFFER_PUT_MAX 9
+
+/* Return 'size' bytes or NULL.  'release' may be NULL (arenas usually
+ * free everything at once); otherwise it's given back each block the
+ * buffer no longer uses, with the size it was allocated with. */
+typedef void *varintBufferAllocFn(void *ctx, size_t size);
+typedef void varintBufferReleaseFn(void *ctx, void *p, size_t size);
+
+typedef struct varintBufferAllocator {
+    varintBufferAllocFn *alloc;
+    varintBufferReleaseFn *release;
+    void *ctx;
+} varintBufferAllocator;
+
+typedef struct varintBuffer {
+    uint8_t *data;
+    size_t len;
+    size_t capacity;
+    const varintBufferAllocator *allocator; /* NULL for malloc() */
+} varintBuffer;
+
+/* 'allocator' (if not NULL) must outlive the buffer. */
+void varintBufferInit(varintBuffer *b, const varintBufferAllocator *allocator);
+void varintBufferFree(varintBuffer *b);
+
+#define varintBufferClear(b) ((b)->len = 0)
+
+/* Slow path of varintBufferReserve() */
+bool varintBufferGrow_(varintBuffer *b, size_t extra);
+
+/* Make room for 'extra' more bytes.  Returns false (leaving the buffer
+ * as it was) if allocation fails. */
+static inline bool varintBufferReserve(varintBuffer *b, size_t extra) {
+    return b->capacity - b->len >= extra || varintBufferGrow_(b, extra);
+}
+
+/* Exact bytes 'count' values take in 'format' */
+size_t varintBufferEncodedBytes(varintBufferFormat format,
+                                const uint64_t *values, size_t count);
+
+/* Unchecked append: room must already be reserved. */
+static inline void varintBufferPutQuick_(varintBuffer *b,
+                                         varintBufferFormat format,
+                                         uint64_t v) {
+    uint8_t *dst = b->data + b->len;
+    varintWidth width = 0;
+    switch (format) {
+    case VARINT_BUFFER_TAGGED:
+        width = varintTaggedPut64(dst, v);
+        break;
+    case VARINT_BUFFER_CHAINED:
+        width = varintChainedPutVarint(dst, v);
+        break;
+    case VARINT_BUFFER_CHAINED_SIMPLE:
+        width = varintChainedSimpleEncode64(dst, v);
+        break;
+    case VARINT_BUFFER_SPLIT_FULL:
+        varintSplitFullPut_(dst, width, v);
+        break;
+    case VARINT_BUFFER_PREFIX:
+        width = varintPrefixPut(dst, v);
+        break;
+    }
+
+    b->len += width;
+}
+
+static inline bool varintBufferPut(varintBuffer *b, varintBufferFormat format,
+                                   uint64_t v) {
+    if (!varintBufferReserve(b, VARINT_BUFFER_PUT_MAX)) {
+        return false;
+    }
+
+    varintBufferPutQuick_(b, format, v);
+    return true;
+}
+
+/* Append 'count' values with one capacity check.  Returns false (having
+ * appended nothing) if allocation fails. */
+bool varintBufferPutArray(varintBuffer *b, varintBufferFormat format,
+                          const uint64_t *values, size_t count);
+
+/* Append raw bytes */
+bool varintBufferAppend(varintBuffer *b, const void *p, size_t len);
+
+__END_DECLS
@@ -0,0 +1,198 @@
+#include "varintBuffer.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 10000
+
+/* Bump allocator over one fixed block, never freeing */
+typedef struct arena {
+    uint8_t *base;
+    size_t used;
+    size_t size;
+    size_t allocs;
+    size_t releases;
+} arena;
+
+static void *arenaAlloc(void *ctx, size_t size) {
+    arena *a = ctx;
+    if (size > a->size - a->used) {
+        return NULL;
+    }
+
+    void *p = a->base + a->used;
+    a->used += (size + 15) & ~(size_t)15;
+    a->allocs++;
+    return p;
+}
+
+static void arenaRelease(void *ctx, void *p, size_t size) {
+    arena *a = ctx;
+    (void)p;
+    (void)size;
+    a->releases++;
+}
+
+/* Reference encoding of 'values' with the raw Put functions */
+static size_t encodeRaw(uint8_t *dst, varintBufferFormat format,
+                        const uint64_t *values, size_t count) {
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        varintWidth width = 0;
+        switch (format) {
+        case VARINT_BUFFER_TAGGED:
+            width = varintTaggedPut64(dst + len, values[i]);
+            break;
+        case VARINT_BUFFER_CHAINED:
+            width = varintChainedPutVarint(dst + len, values[i]);
+            break;
+        case VARINT_BUFFER_CHAINED_SIMPLE:
+            width = varintChainedSimpleEncode64(dst + len, values[i]);
+            break;
+        case VARINT_BUFFER_SPLIT_FULL:
+            varintSplitFullPut_(dst + len, width, values[i]);
+            break;
+        case VARINT_BUFFER_PREFIX:
+            width = varintPrefixPut(dst + len, values[i]);
+            break;
+        }
+
+        len += width;
+    }
+
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(73);
+
+    uint64_t *values = malloc(COUNT * sizeof(*values));
+    uint8_t *raw = malloc(COUNT * VARINT_BUFFER_PUT_MAX);
+    for (size_t i = 0; i < COUNT; i++) {
+        /* Every width */
+        values[i] = ctestRandomWidth();
+    }
+
+    TEST("appends match the raw encoders in every format") {
+        for (varintBufferFormat format = VARINT_BUFFER_TAGGED;
+             format <= VARINT_BUFFER_PREFIX; format++) {
+            const size_t rawLen = encodeRaw(raw, format, values, COUNT);
+            if (varintBufferEncodedBytes(format, values, COUNT) != rawLen) {
+                ERR("Format %d encoded size wrong!", format);
+            }
+
+            varintBuffer single;
+            varintBufferInit(&single, NULL);
+            for (size_t i = 0; i < COUNT; i++) {
+                varintBufferPut(&single, format, values[i]);
+            }
+
+            /* Arrays in uneven pieces */
+            varintBuffer batch;
+            varintBufferInit(&batch, NULL);
+            for (size_t i = 0; i < COUNT;) {
+                const size_t n = (i % 7) * 31 + 1;
+                const size_t take = n < COUNT - i ? n : COUNT - i;
+                varintBufferPutArray(&batch, format, values + i, take);
+                i += take;
+            }
+
+            if (single.len != rawLen || memcmp(single.data, raw, rawLen)) {
+                ERR("Format %d single puts differ!", format);
+            }
+
+            if (batch.len != rawLen || memcmp(batch.data, raw, rawLen)) {
+                ERR("Format %d array puts differ!", format);
+            }
+
+            varintBufferFree(&single);
+            varintBufferFree(&batch);
+        }
+    }
+
+    TEST("reserve then unchecked appends never grow") {
+        varintBuffer b;
+        varintBufferInit(&b, NULL);
+        const size_t exact =
+            varintBufferEncodedBytes(VARINT_BUFFER_TAGGED, values, COUNT);
+        if (!varintBufferReserve(&b, exact)) {
+            ERRR("Reserve failed!");
+        }
+
+        uint8_t *const data = b.data;
+        const size_t capacity = b.capacity;
+        for (size_t i = 0; i < COUNT; i++) {
+            varintBufferPutQuick_(&b, VARINT_BUFFER_TAGGED, values[i]);
+        }
+
+        if (b.data != data || b.capacity != capacity || b.len != exact) {
+            ERRR("Reserved buffer moved!");
+        }
+
+        /* Exactly sized arrays don't round up to the worst case */
+        varintBufferClear(&b);
+        varintBuffer fresh;
+        varintBufferInit(&fresh, NULL);
+        varintBufferPutArray(&fresh, VARINT_BUFFER_TAGGED, values, COUNT);
+        if (fresh.capacity >= COUNT * VARINT_BUFFER_PUT_MAX) {
+            ERR("Array reserved %zu bytes for %zu!", fresh.capacity, exact);
+        }
+
+        varintBufferFree(&b);
+        varintBufferFree(&fresh);
+    }
+
+    TEST("arena allocators") {
+        arena a = {.size = 1 << 20};
+        a.base = malloc(a.size);
+        const varintBufferAllocator allocator = {arenaAlloc, arenaRelease,
+                                                 &a};
+
+        varintBuffer b;
+        varintBufferInit(&b, &allocator);
+        for (size_t i = 0; i < COUNT; i++) {
+            if (!varintBufferPut(&b, VARINT_BUFFER_CHAINED, values[i])) {
+                ERR("Arena put %zu failed!", i);
+                break;
+            }
+        }
+
+        const size_t rawLen =
+            encodeRaw(raw, VARINT_BUFFER_CHAINED, values, COUNT);
+        if (b.len != rawLen || memcmp(b.data, raw, rawLen)) {
+            ERRR("Arena buffer differs!");
+        }
+
+        /* Geometric growth: a handful of allocations, not one per put */
+        if (a.allocs > 16 || a.releases != a.allocs - 1) {
+            ERR("%zu allocations and %zu releases!", a.allocs, a.releases);
+        }
+
+        /* Exhausting the arena fails without losing what's there */
+        const size_t len = b.len;
+        uint8_t big[4096] = {0};
+        while (varintBufferAppend(&b, big, sizeof(big))) {
+        }
+
+        if (b.len < len || memcmp(b.data, raw, rawLen)) {
+            ERRR("Failed growth damaged the buffer!");
+        }
+
+        varintBufferFree(&b);
+        if (a.releases != a.allocs) {
+            ERRR("Free didn't release the last block!");
+        }
+
+        free(a.base);
+    }
+
+    free(values);
+    free(raw);
+
+    TEST_FINAL_RESULT;
+}
@@ -411,3 +411,38 @@ varintWidth varintChainedVarintLen(uint64_t v) {
      * calculations are actually 9 byte varints. */
     return i > 9 ? 9 : i;
 }
+
+static varintWidth varintChainedVarintAdd(uint8_t *p, int64_t add,
+                                          bool force) {
+    /* we're pulling the value out as just an 'int64_t' because we want to
+     * allow signed math. */
+    uint64_t retrieve = 0;
+    varintWidth origEncoding = varintChainedGetVarint(p, &retrieve);
+    int64_t updatingVal = (int64_t)retrieve;
+    long long newVal;
+
+    VARINT_ADD_OR_ABORT_OVERFLOW_(updatingVal, add, newVal);
+
+    varintWidth newEncoding = varintChainedVarintLen(newVal);
+
+    /* If new encoding is larger than current encoding, we don't
+     * want to overwrite memory beyond our current varint.
+     * Bail out unless this was requested as "safe to grow" addition. */
+    if (newEncoding > origEncoding && !force) {
+        return newEncoding;
+    }
+
+    varintChainedPutVarint(p, newVal);
+    return newEncoding;
+}
+
+/* If math can't fit into current encoding, fail the write and return
+ * the new encoding length we need for this math to complete.
+ * (Then the user can manually run the add to update.) */
+varintWidth varintChainedVarintAddNoGrow(uint8_t *p, int64_t add) {
+    return varintChainedVarintAdd(p, add, false);
+}
+
+varintWidth varintChainedVarintAddGrow(uint8_t *p, int64_t add) {
+    return varintChainedVarintAdd(p, add, true);
+}
@@ -25,6 +25,7 @@ varintWidth varintChainedPutVarint(uint8_t *p, uint64_t v);
 varintWidth varintChainedGetVarint(const uint8_t *p, uint64_t *v);
 varintWidth varintChainedGetVarint32(const uint8_t *p, uint32_t *v);
 varintWidth varintChainedVarintLen(uint64_t v);
+/* Grow overwrites bytes after 'z'; see varintTaggedAddGrow() */
 varintWidth varintChainedVarintAddNoGrow(uint8_t *z, int64_t add);
 varintWidth varintChainedVarintAddGrow(uint8_t *z, int64_t add);
 
@@ -125,3 +125,77 @@ varintWidth varintChainedSimpleDecode32(const uint8_t *p, uint32_t *value) {
 
     return varintChainedSimpleDecode32Fallback(p, value);
 }
+
+/* 18 bytes of 7 bits hold 126 bits, so a 128-bit value needs a 19th byte,
+ * which (like the 9th byte of the 64-bit form) has no continuation bit. */
+#define notAtMaximumWidth128(mover, orig) (((mover) - (orig)) < 18)
+
+varintWidth varintChainedSimpleEncode128(uint8_t *p, __uint128_t v) {
+    /* Both forms are identical until the 64-bit form's full 9th byte */
+    if (v < ((uint64_t)1 << 56)) {
+        return varintChainedSimpleEncode64(p, (uint64_t)v);
+    }
+
+    uint8_t *writeP = p;
+    for (; v >= extent && notAtMaximumWidth128(writeP, p); writeP++) {
+        *writeP = (v & (extent - 1)) | extent;
+        v >>= 7;
+    }
+
+    *writeP = (uint8_t)v;
+    return 1 + writeP - p;
+}
+
+varintWidth varintChainedSimpleLength128(__uint128_t v) {
+    varintWidth i = VARINT_WIDTH_8B;
+    while (v >>= 7) {
+        i++;
+    }
+
+    /* 128-bit varintChainedSimple is capped at 19 bytes */
+    return i > 19 ? 19 : i;
+}
+
+varintWidth varintChainedSimpleDecode128(const uint8_t *p, __uint128_t *v) {
+    /* Decode the low 64 bits (at most 8 bytes of 7 bits) as one word */
+    uint64_t low = 0;
+    const uint8_t *mover = p;
+    for (uint8_t shift = 0; shift < 56; shift += 7, mover++) {
+        low |= (uint64_t)(*mover & (extent - 1)) << shift;
+        if (!(*mover & extent)) {
+            *v = low;
+            return 1 + mover - p;
+        }
+    }
+
+    __uint128_t result = low;
+    for (uint8_t shift = 56;; shift += 7, mover++) {
+        if ((*mover & extent) && notAtMaximumWidth128(mover, p)) {
+            result |= (__uint128_t)(*mover & (extent - 1)) << shift;
+        } else {
+            result |= (__uint128_t)*mover << shift;
+            *v = result;
+            return 1 + mover - p;
+        }
+    }
+}
+
+size_t varintChainedSimpleEncode128Array(uint8_t *p, const __uint128_t *vals,
+                                         size_t count) {
+    uint8_t *start = p;
+    for (size_t i = 0; i < count; i++) {
+        p += varintChainedSimpleEncode128(p, vals[i]);
+    }
+
+    return p - start;
+}
+
+size_t varintChainedSimpleDecode128Array(const uint8_t *p, __uint128_t *vals,
+                                         size_t count) {
+    const uint8_t *start = p;
+    for (size_t i = 0; i < count; i++) {
+        p += varintChainedSimpleDecode128(p, &vals[i]);
+    }
+
+    return p - start;
+}
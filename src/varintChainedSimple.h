@@ -1,5 +1,6 @@
 #pragma once
 
+#include "varint.h"
 __BEGIN_DECLS
 
 /* ====================================================================
@@ -27,4 +28,20 @@ varintWidth varintChainedSimpleDecode32Fallback(const uint8_t *p,
                                                 uint32_t *value);
 varintWidth varintChainedSimpleDecode32(const uint8_t *p, uint32_t *value);
 
+/* 128-bit Chained Simple varints continue for up to 18 bytes of 7 bits
+ * each, and a 19th byte (if reached) holds the final 2 bits.  Values below
+ * 2^63 encode identically to varintChainedSimpleEncode64(); larger values
+ * do not, since the 64-bit form stores 8 bits in its 9th byte while this
+ * form stores 7 and a continuation bit. */
+varintWidth varintChainedSimpleEncode128(uint8_t *p, __uint128_t v);
+varintWidth varintChainedSimpleLength128(__uint128_t v);
+varintWidth varintChainedSimpleDecode128(const uint8_t *p, __uint128_t *v);
+
+/* Bulk encode and decode of 'count' values back to back.
+ * Each returns the number of bytes written or read. */
+size_t varintChainedSimpleEncode128Array(uint8_t *p, const __uint128_t *vals,
+                                         size_t count);
+size_t varintChainedSimpleDecode128Array(const uint8_t *p, __uint128_t *vals,
+                                         size_t count);
+
 __END_DECLS
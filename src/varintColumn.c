@@ -0,0 +1,443 @@
+#include "varintColumn.h"
+#include "varintBitstream.h"
+#include "varintExternal.h"
+#include "varintTagged.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ====================================================================
+ * Header and zone map fields
+ * ==================================================================== */
+static const uint8_t varintColumnMagic_[4] = {'V', 'C', 'L', '1'};
+
+/* Offsets inside a zone map entry */
+#define ZONE_MIN 0
+#define ZONE_MAX 8
+#define ZONE_OFFSET 16
+#define ZONE_LENGTH 24
+#define ZONE_COUNT 28
+#define ZONE_NULLS 32
+#define ZONE_ENCODING 36
+#define ZONE_BITS 37
+
+#define varintColumnPut64_(p, v)                                               \
+    varintExternalPutFixedWidth((p), (v), VARINT_WIDTH_64B)
+#define varintColumnPut32_(p, v)                                               \
+    varintExternalPutFixedWidth((p), (v), VARINT_WIDTH_32B)
+#define varintColumnGet64_(p) varintExternalGet((p), VARINT_WIDTH_64B)
+#define varintColumnGet32_(p)                                                  \
+    ((uint32_t)varintExternalGet((p), VARINT_WIDTH_32B))
+
+static const uint8_t *varintColumnZoneAt_(const varintColumn *c,
+                                          uint32_t block) {
+    return c->data + VARINT_COLUMN_HEADER_BYTES +
+           (size_t)block * VARINT_COLUMN_ZONE_BYTES;
+}
+
+static const uint8_t *varintColumnPayload_(const varintColumn *c) {
+    return varintColumnZoneAt_(c, c->blocks);
+}
+
+#define varintColumnAlign8_(n) (((n) + 7) & ~(size_t)7)
+#define varintColumnBitmapBytes_(count) (((size_t)(count) + 7) / 8)
+
+/* ====================================================================
+ * Encoding
+ * ==================================================================== */
+size_t varintColumnEncodeBound(size_t count, uint32_t blockValues) {
+    const size_t blocks = (count + blockValues - 1) / blockValues;
+
+    /* Per block: worst case Tagged payload, bitmap, and alignment */
+    return VARINT_COLUMN_HEADER_BYTES + blocks * VARINT_COLUMN_ZONE_BYTES +
+           count * 9 + varintColumnBitmapBytes_(count) + blocks * 16;
+}
+
+/* PACKED payload bytes: whole 64 bit words of 'bits' wide offsets */
+static size_t varintColumnPackedBytes_(size_t count, uint32_t bits) {
+    return varintColumnAlign8_(((uint64_t)count * bits + 7) / 8);
+}
+
+size_t varintColumnEncode(uint8_t *dst, size_t dstCapacity,
+                          const uint64_t *values, const uint8_t *nulls,
+                          size_t count, uint32_t blockValues) {
+    if (!blockValues || dstCapacity < VARINT_COLUMN_HEADER_BYTES) {
+        return 0;
+    }
+
+    const size_t blocks = (count + blockValues - 1) / blockValues;
+    const size_t payloadStart =
+        VARINT_COLUMN_HEADER_BYTES + blocks * VARINT_COLUMN_ZONE_BYTES;
+    if (blocks > UINT32_MAX || payloadStart > dstCapacity) {
+        return 0;
+    }
+
+    size_t offset = 0; /* from payloadStart, kept 8 byte aligned */
+    for (size_t b = 0; b < blocks; b++) {
+        const size_t first = b * blockValues;
+        const size_t n =
+            count - first < blockValues ? count - first : blockValues;
+        const uint64_t *v = values + first;
+        const uint8_t *isNull = nulls ? nulls + first : NULL;
+
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint32_t nullCount = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (isNull && isNull[i]) {
+                nullCount++;
+                continue;
+            }
+
+            min = v[i] < min ? v[i] : min;
+            max = v[i] > max ? v[i] : max;
+        }
+
+        if (nullCount == n) {
+            min = max = 0;
+        }
+
+        /* Pick the smallest encoding of the offsets from 'min' */
+        const uint64_t range = max - min;
+        const uint32_t bits = range ? 64 - __builtin_clzll(range) : 0;
+        varintColumnEncoding encoding = VARINT_COLUMN_CONSTANT;
+        size_t dataBytes = 0;
+        if (range) {
+            size_t taggedBytes = 0;
+            for (size_t i = 0; i < n; i++) {
+                const bool null = isNull && isNull[i];
+                taggedBytes += null ? 1 : varintTaggedLen(v[i] - min);
+            }
+
+            const size_t packedBytes = varintColumnPackedBytes_(n, bits);
+            encoding = packedBytes <= taggedBytes ? VARINT_COLUMN_PACKED
+                                                  : VARINT_COLUMN_TAGGED;
+            dataBytes = encoding == VARINT_COLUMN_PACKED ? packedBytes
+                                                         : taggedBytes;
+        }
+
+        const size_t bitmapBytes =
+            nullCount ? varintColumnAlign8_(varintColumnBitmapBytes_(n)) : 0;
+        const size_t length = bitmapBytes + dataBytes;
+        if (payloadStart + offset + varintColumnAlign8_(length) >
+            dstCapacity) {
+            return 0;
+        }
+
+        uint8_t *out = dst + payloadStart + offset;
+        memset(out, 0, varintColumnAlign8_(length));
+        if (nullCount) {
+            for (size_t i = 0; i < n; i++) {
+                out[i / 8] |= (uint8_t)((isNull[i] ? 1 : 0) << (i % 8));
+            }
+        }
+
+        uint8_t *data = out + bitmapBytes;
+        if (encoding == VARINT_COLUMN_PACKED) {
+            for (size_t i = 0; i < n; i++) {
+                const bool null = isNull && isNull[i];
+                varintBitstreamSet((vbits *)data, i * bits, bits,
+                                   null ? 0 : v[i] - min);
+            }
+        } else if (encoding == VARINT_COLUMN_TAGGED) {
+            for (size_t i = 0; i < n; i++) {
+                const bool null = isNull && isNull[i];
+                data += varintTaggedPut64(data, null ? 0 : v[i] - min);
+            }
+        }
+
+        uint8_t *zone = dst + VARINT_COLUMN_HEADER_BYTES +
+                        b * VARINT_COLUMN_ZONE_BYTES;
+        memset(zone, 0, VARINT_COLUMN_ZONE_BYTES);
+        varintColumnPut64_(zone + ZONE_MIN, min);
+        varintColumnPut64_(zone + ZONE_MAX, max);
+        varintColumnPut64_(zone + ZONE_OFFSET, offset);
+        varintColumnPut32_(zone + ZONE_LENGTH, length);
+        varintColumnPut32_(zone + ZONE_COUNT, n);
+        varintColumnPut32_(zone + ZONE_NULLS, nullCount);
+        zone[ZONE_ENCODING] = (uint8_t)encoding;
+        zone[ZONE_BITS] = (uint8_t)bits;
+
+        offset += varintColumnAlign8_(length);
+    }
+
+    memcpy(dst, varintColumnMagic_, sizeof(varintColumnMagic_));
+    varintColumnPut32_(dst + 4, blockValues);
+    varintColumnPut64_(dst + 8, count);
+    varintColumnPut32_(dst + 16, blocks);
+    varintColumnPut32_(dst + 20, 0);
+    varintColumnPut64_(dst + 24, offset);
+    return payloadStart + offset;
+}
+
+/* ====================================================================
+ * Opening
+ * ==================================================================== */
+bool varintColumnOpen(varintColumn *c, const uint8_t *data, size_t len) {
+    memset(c, 0, sizeof(*c));
+    if (len < VARINT_COLUMN_HEADER_BYTES || ((uintptr_t)data & 7) ||
+        memcmp(data, varintColumnMagic_, sizeof(varintColumnMagic_))) {
+        return false;
+    }
+
+    c->data = data;
+    c->len = len;
+    c->blockValues = varintColumnGet32_(data + 4);
+    c->count = varintColumnGet64_(data + 8);
+    c->blocks = varintColumnGet32_(data + 16);
+    const uint64_t payloadBytes = varintColumnGet64_(data + 24);
+
+    const uint64_t payloadStart =
+        VARINT_COLUMN_HEADER_BYTES +
+        (uint64_t)c->blocks * VARINT_COLUMN_ZONE_BYTES;
+    if (!c->blockValues || payloadStart > len ||
+        payloadBytes > len - payloadStart ||
+        c->count > (uint64_t)c->blocks * c->blockValues) {
+        return false;
+    }
+
+    /* Every zone must describe a block inside the payload */
+    uint64_t rows = 0;
+    for (uint32_t b = 0; b < c->blocks; b++) {
+        varintColumnZone zone;
+        varintColumnZoneGet(c, b, &zone);
+        const uint8_t *z = varintColumnZoneAt_(c, b);
+        const uint64_t offset = varintColumnGet64_(z + ZONE_OFFSET);
+        const uint32_t length = varintColumnGet32_(z + ZONE_LENGTH);
+        if ((offset & 7) || offset > payloadBytes ||
+            length > payloadBytes - offset || !zone.count ||
+            zone.count > c->blockValues || zone.nullCount > zone.count ||
+            zone.min > zone.max || zone.encoding > VARINT_COLUMN_TAGGED ||
+            zone.bits > 64) {
+            return false;
+        }
+
+        rows += zone.count;
+    }
+
+    return rows == c->count;
+}
+
+bool varintColumnOpenFile(varintColumn *c, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        memset(c, 0, sizeof(*c));
+        return false;
+    }
+
+    const size_t len = (size_t)st.st_size;
+    void *map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        memset(c, 0, sizeof(*c));
+        return false;
+    }
+
+    if (!varintColumnOpen(c, map, len)) {
+        munmap(map, len);
+        return false;
+    }
+
+    c->map = map;
+    c->mapLen = len;
+    return true;
+}
+
+void varintColumnClose(varintColumn *c) {
+    if (c->map) {
+        munmap(c->map, c->mapLen);
+    }
+
+    memset(c, 0, sizeof(*c));
+}
+
+void varintColumnZoneGet(const varintColumn *c, uint32_t block,
+                         varintColumnZone *zone) {
+    const uint8_t *z = varintColumnZoneAt_(c, block);
+    zone->min = varintColumnGet64_(z + ZONE_MIN);
+    zone->max = varintColumnGet64_(z + ZONE_MAX);
+    zone->count = varintColumnGet32_(z + ZONE_COUNT);
+    zone->nullCount = varintColumnGet32_(z + ZONE_NULLS);
+    zone->encoding = (varintColumnEncoding)z[ZONE_ENCODING];
+    zone->bits = z[ZONE_BITS];
+}
+
+/* ====================================================================
+ * Decoding
+ * ==================================================================== */
+bool varintColumnBlockDecode(const varintColumn *c, uint32_t block,
+                             uint64_t *values, uint8_t *nulls) {
+    varintColumnZone zone;
+    varintColumnZoneGet(c, block, &zone);
+    const uint8_t *z = varintColumnZoneAt_(c, block);
+    const uint8_t *p =
+        varintColumnPayload_(c) + varintColumnGet64_(z + ZONE_OFFSET);
+    const uint8_t *const end = p + varintColumnGet32_(z + ZONE_LENGTH);
+    const uint32_t n = zone.count;
+
+    if (zone.nullCount) {
+        const size_t bitmapBytes =
+            varintColumnAlign8_(varintColumnBitmapBytes_(n));
+        if ((size_t)(end - p) < bitmapBytes) {
+            return false;
+        }
+
+        if (nulls) {
+            for (uint32_t i = 0; i < n; i++) {
+                nulls[i] = (p[i / 8] >> (i % 8)) & 1;
+            }
+        }
+
+        p += bitmapBytes;
+    } else if (nulls) {
+        memset(nulls, 0, n);
+    }
+
+    switch (zone.encoding) {
+    case VARINT_COLUMN_CONSTANT:
+        for (uint32_t i = 0; i < n; i++) {
+            values[i] = zone.min;
+        }
+        break;
+    case VARINT_COLUMN_PACKED:
+        if ((size_t)(end - p) < varintColumnPackedBytes_(n, zone.bits) ||
+            !zone.bits) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            values[i] = zone.min + varintBitstreamGet((const vbits *)p,
+                                                      (size_t)i * zone.bits,
+                                                      zone.bits);
+        }
+        break;
+    case VARINT_COLUMN_TAGGED:
+        for (uint32_t i = 0; i < n; i++) {
+            const size_t left = (size_t)(end - p);
+            uint64_t offset;
+            const varintWidth width =
+                varintTaggedGet(p, left > 9 ? 9 : (int32_t)left, &offset);
+            if (!width) {
+                return false;
+            }
+
+            values[i] = zone.min + offset;
+            p += width;
+        }
+        break;
+    }
+
+    return true;
+}
+
+/* ====================================================================
+ * Range scans
+ * ==================================================================== */
+/* Zone map can't hold a match: skip the block unread */
+#define varintColumnZoneExcludes_(zone, lo, hi)                                \
+    ((zone).nullCount == (zone).count || (zone).max < (lo) ||                  \
+     (zone).min > (hi))
+
+#define varintColumnZoneCovers_(zone, lo, hi)                                  \
+    ((lo) <= (zone).min && (zone).max <= (hi))
+
+bool varintColumnScan(const varintColumn *c, uint64_t lo, uint64_t hi,
+                      varintColumnMatchFn *fn, void *ctx,
+                      varintColumnScanStats *stats) {
+    varintColumnScanStats local = {0};
+    uint64_t *values = malloc(c->blockValues * sizeof(*values));
+    uint64_t *matchRows = malloc(c->blockValues * sizeof(*matchRows));
+    uint64_t *matchValues = malloc(c->blockValues * sizeof(*matchValues));
+    uint8_t *nulls = malloc(c->blockValues);
+    bool ok = values && matchRows && matchValues && nulls;
+
+    for (uint32_t b = 0; ok && b < c->blocks; b++) {
+        varintColumnZone zone;
+        varintColumnZoneGet(c, b, &zone);
+        if (varintColumnZoneExcludes_(zone, lo, hi)) {
+            local.blocksSkipped++;
+            continue;
+        }
+
+        local.blocksRead++;
+        if (!varintColumnBlockDecode(c, b, values, nulls)) {
+            ok = false;
+            break;
+        }
+
+        /* Covered blocks without nulls match every row uncompared */
+        const uint64_t firstRow = (uint64_t)b * c->blockValues;
+        const bool all =
+            !zone.nullCount && varintColumnZoneCovers_(zone, lo, hi);
+        size_t matched = 0;
+        for (uint32_t i = 0; i < zone.count; i++) {
+            matchRows[matched] = firstRow + i;
+            matchValues[matched] = values[i];
+            matched += all || (!nulls[i] && values[i] >= lo && values[i] <= hi);
+        }
+
+        local.rows += matched;
+        if (matched && !fn(ctx, matchRows, matchValues, matched)) {
+            ok = false;
+        }
+    }
+
+    free(values);
+    free(matchRows);
+    free(matchValues);
+    free(nulls);
+    if (stats) {
+        *stats = local;
+    }
+
+    return ok;
+}
+
+bool varintColumnCount(const varintColumn *c, uint64_t lo, uint64_t hi,
+                       uint64_t *count, varintColumnScanStats *stats) {
+    varintColumnScanStats local = {0};
+    uint64_t *values = NULL;
+    uint8_t *nulls = NULL;
+    bool ok = true;
+
+    for (uint32_t b = 0; b < c->blocks; b++) {
+        varintColumnZone zone;
+        varintColumnZoneGet(c, b, &zone);
+        if (varintColumnZoneExcludes_(zone, lo, hi)) {
+            local.blocksSkipped++;
+            continue;
+        }
+
+        if (varintColumnZoneCovers_(zone, lo, hi)) {
+            local.blocksSkipped++;
+            local.rows += zone.count - zone.nullCount;
+            continue;
+        }
+
+        if (!values) {
+            values = malloc(c->blockValues * sizeof(*values));
+            nulls = malloc(c->blockValues);
+        }
+
+        local.blocksRead++;
+        if (!values || !nulls ||
+            !varintColumnBlockDecode(c, b, values, nulls)) {
+            ok = false;
+            break;
+        }
+
+        for (uint32_t i = 0; i < zone.count; i++) {
+            local.rows += !nulls[i] && values[i] >= lo && values[i] <= hi;
+        }
+    }
+
+    free(values);
+    free(nulls);
+    *count = local.rows;
+    if (stats) {
+        *stats = local;
+    }
+
+    return ok;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Column segments with zone maps
+ * ==================================================================== */
+/* A segment holds one column of uint64_t values (some possibly null) cut
+ * into blocks of up to 'blockValues' values.  Each block is stored as its
+ * offsets from the block minimum (frame of reference) using whichever of
+ * these is smallest:
+ *   - CONSTANT: every non-null value equals the minimum; no payload
+ *   - PACKED:   offsets bit packed at the width of (max - min)
+ *               (varintBitstream)
+ *   - TAGGED:   offsets as Tagged varints
+ * A block with nulls is preceded by a bitmap of which rows are null;
+ * null rows take an offset of 0 so rows keep their positions.
+ *
+ * Every block has a zone map entry (min, max, count, null count) in one
+ * fixed size array after the segment header, so a scan for values in
+ * [lo, hi] reads only the zone maps of blocks it can rule out and never
+ * touches their payloads.
+ *
+ * A segment is one contiguous buffer which can be written to a file as
+ * is and used in place from memory or from mmap().  Header and zone maps
+ * are little endian; PACKED blocks hold native 64 bit words (aligned to 8
+ * bytes), so segments move only between hosts of the same byte order.
+ *
+ * Layout:
+ *   header  32 bytes: "VCL1", blockValues, count, blocks, payload bytes
+ *   zones   40 bytes per block: min, max, payload offset, payload bytes,
+ *           count, null count, encoding, bit width
+ *   payload each block at its offset (8 byte aligned) */
+
+typedef enum varintColumnEncoding {
+    VARINT_COLUMN_CONSTANT = 0,
+    VARINT_COLUMN_PACKED,
+    VARINT_COLUMN_TAGGED,
+} varintColumnEncoding;
+
+#define VARINT_COLUMN_HEADER_BYTES 32
+#define VARINT_COLUMN_ZONE_BYTES 40
+
+/* Bytes always enough to encode 'count' values in blocks of
+ * 'blockValues'. */
+size_t varintColumnEncodeBound(size_t count, uint32_t blockValues);
+
+/* Encode 'count' 'values' into 'dst' (room for 'dstCapacity' bytes) in
+ * blocks of 'blockValues'.  Row i is null if 'nulls' is not NULL and
+ * nulls[i] is nonzero (its value is ignored).  'dst' must be 8 byte
+ * aligned.  Returns the segment length, or 0 if 'dst' is too small. */
+size_t varintColumnEncode(uint8_t *dst, size_t dstCapacity,
+                          const uint64_t *values, const uint8_t *nulls,
+                          size_t count, uint32_t blockValues);
+
+typedef struct varintColumn {
+    const uint8_t *data;
+    size_t len;
+    uint64_t count;
+    uint32_t blocks;
+    uint32_t blockValues;
+    void *map; /* set by varintColumnOpenFile() */
+    size_t mapLen;
+} varintColumn;
+
+typedef struct varintColumnZone {
+    uint64_t min; /* of non-null values (0 if all are null) */
+    uint64_t max;
+    uint32_t count;
+    uint32_t nullCount;
+    varintColumnEncoding encoding;
+    uint8_t bits; /* PACKED bit width */
+} varintColumnZone;
+
+/* Use the segment in 'data' (8 byte aligned) in place.  Returns false if
+ * the header or zone maps are malformed or point outside 'len' bytes.
+ * Block payloads are checked as they are decoded. */
+bool varintColumnOpen(varintColumn *c, const uint8_t *data, size_t len);
+
+/* mmap() all of 'fd' and open it; release with varintColumnClose(). */
+bool varintColumnOpenFile(varintColumn *c, int fd);
+void varintColumnClose(varintColumn *c);
+
+void varintColumnZoneGet(const varintColumn *c, uint32_t block,
+                         varintColumnZone *zone);
+
+/* Decode block 'block' into 'values' (room for blockValues) and, if
+ * 'nulls' is not NULL, one byte per row (1 for null).  Returns false if
+ * the block's payload is malformed. */
+bool varintColumnBlockDecode(const varintColumn *c, uint32_t block,
+                             uint64_t *values, uint8_t *nulls);
+
+/* ====================================================================
+ * Range scans
+ * ==================================================================== */
+typedef struct varintColumnScanStats {
+    uint64_t blocksRead;    /* payloads decoded */
+    uint64_t blocksSkipped; /* ruled out by zone map alone */
+    uint64_t rows;          /* rows matched */
+} varintColumnScanStats;
+
+/* Called once per block with matches: 'rows' (segment row numbers) and
+ * their 'values'.  Both are only valid during the call.  Return false to
+ * stop the scan. */
+typedef bool varintColumnMatchFn(void *ctx, const uint64_t *rows,
+                                 const uint64_t *values, size_t count);
+
+/* Report every non-null row with lo <= value <= hi to 'fn', in row
+ * order.  Returns false if a block is malformed, 'fn' stopped the scan,
+ * or scratch space can't be allocated.  'stats' may be NULL. */
+bool varintColumnScan(const varintColumn *c, uint64_t lo, uint64_t hi,
+                      varintColumnMatchFn *fn, void *ctx,
+                      varintColumnScanStats *stats);
+
+/* Count non-null rows with lo <= value <= hi.  Blocks whose zone map lies
+ * entirely inside the range are counted from the zone map without being
+ * decoded.  Returns false if a block is malformed. */
+bool varintColumnCount(const varintColumn *c, uint64_t lo, uint64_t hi,
+                       uint64_t *count, varintColumnScanStats *stats);
+
+__END_DECLS
@@ -0,0 +1,272 @@
+#define _GNU_SOURCE
+#include "varintColumn.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#define COUNT 100003
+#define BLOCK 1024
+
+typedef struct scanCheck {
+    const uint64_t *values;
+    const uint8_t *nulls;
+    uint64_t lo;
+    uint64_t hi;
+    uint64_t nextRow; /* rows before this were already checked */
+    uint64_t matched;
+    bool bad;
+} scanCheck;
+
+static bool inRange(const scanCheck *s, uint64_t row) {
+    return !(s->nulls && s->nulls[row]) && s->values[row] >= s->lo &&
+           s->values[row] <= s->hi;
+}
+
+/* Every reported row must match, and no matching row may be skipped */
+static bool checkMatches(void *ctx, const uint64_t *rows,
+                         const uint64_t *values, size_t count) {
+    scanCheck *s = ctx;
+    for (size_t i = 0; i < count; i++) {
+        for (; s->nextRow < rows[i]; s->nextRow++) {
+            s->bad |= inRange(s, s->nextRow);
+        }
+
+        s->bad |= !inRange(s, rows[i]) || values[i] != s->values[rows[i]];
+        s->nextRow = rows[i] + 1;
+        s->matched++;
+    }
+
+    return true;
+}
+
+/* Encode into an 8 byte aligned buffer; returns the segment length */
+static size_t encode(uint64_t **segment, const uint64_t *values,
+                     const uint8_t *nulls, size_t count) {
+    const size_t bound = varintColumnEncodeBound(count, BLOCK);
+    *segment = malloc(bound);
+    return varintColumnEncode((uint8_t *)*segment, bound, values, nulls,
+                              count, BLOCK);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(61);
+
+    uint64_t *values = malloc(COUNT * sizeof(*values));
+    uint8_t *nulls = malloc(COUNT);
+    uint64_t *out = malloc(BLOCK * sizeof(*out));
+    uint8_t *outNulls = malloc(BLOCK);
+
+    /* Clustered timestamps: increasing with jitter, some nulls, plus a
+     * constant run, an all null run, and a block of random 64 bit values
+     * (which needs more than 56 bits, so Tagged). */
+    uint64_t base = 1700000000000ULL;
+    for (size_t i = 0; i < COUNT; i++) {
+        base += ctestRandom() % 1000;
+        values[i] = base;
+        nulls[i] = ctestRandom() % 50 == 0;
+    }
+
+    for (size_t i = 10 * BLOCK; i < 12 * BLOCK; i++) {
+        values[i] = 42;
+        nulls[i] = 0;
+    }
+
+    for (size_t i = 20 * BLOCK; i < 21 * BLOCK; i++) {
+        nulls[i] = 1;
+    }
+
+    for (size_t i = 30 * BLOCK; i < 31 * BLOCK; i++) {
+        values[i] = ctestRandom() % 3 ? ctestRandom() % 100 : ctestRandom();
+    }
+
+    uint64_t *segment;
+    const size_t len = encode(&segment, values, nulls, COUNT);
+    varintColumn c;
+
+    TEST("encode and open") {
+        if (!len) {
+            ERRR("Encode failed!");
+        }
+
+        if (!varintColumnOpen(&c, (uint8_t *)segment, len)) {
+            ERRR("Open failed!");
+        }
+
+        if (c.count != COUNT || c.blocks != (COUNT + BLOCK - 1) / BLOCK) {
+            ERR("Opened %" PRIu64 " rows in %u blocks!", c.count, c.blocks);
+        }
+    }
+
+    TEST("blocks round trip through every encoding") {
+        uint32_t seen[3] = {0};
+        for (uint32_t b = 0; b < c.blocks; b++) {
+            varintColumnZone zone;
+            varintColumnZoneGet(&c, b, &zone);
+            seen[zone.encoding]++;
+
+            if (!varintColumnBlockDecode(&c, b, out, outNulls)) {
+                ERR("Block %u didn't decode!", b);
+                continue;
+            }
+
+            for (uint32_t i = 0; i < zone.count; i++) {
+                const size_t row = (size_t)b * BLOCK + i;
+                if (outNulls[i] != nulls[row] ||
+                    (!nulls[row] && out[i] != values[row])) {
+                    ERR("Block %u row %u failed!", b, i);
+                    break;
+                }
+            }
+        }
+
+        if (!seen[VARINT_COLUMN_CONSTANT] || !seen[VARINT_COLUMN_PACKED] ||
+            !seen[VARINT_COLUMN_TAGGED]) {
+            ERR("Encodings used: %u constant, %u packed, %u tagged!",
+                seen[0], seen[1], seen[2]);
+        }
+    }
+
+    TEST("range scans match brute force and skip blocks") {
+        const uint64_t ranges[][2] = {
+            {0, UINT64_MAX},
+            {42, 42},
+            {values[COUNT / 2], values[COUNT / 2] + 50000},
+            {values[COUNT - 5], UINT64_MAX},
+            {1, 41},
+            {5, 90},
+        };
+
+        for (size_t r = 0; r < sizeof(ranges) / sizeof(*ranges); r++) {
+            scanCheck s = {.values = values,
+                           .nulls = nulls,
+                           .lo = ranges[r][0],
+                           .hi = ranges[r][1]};
+            varintColumnScanStats stats;
+            if (!varintColumnScan(&c, s.lo, s.hi, checkMatches, &s,
+                                  &stats)) {
+                ERR("Scan %zu failed!", r);
+            }
+
+            for (; s.nextRow < COUNT; s.nextRow++) {
+                s.bad |= inRange(&s, s.nextRow);
+            }
+
+            uint64_t expected = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                expected += inRange(&s, i);
+            }
+
+            if (s.bad || s.matched != expected || stats.rows != expected) {
+                ERR("Scan %zu matched %" PRIu64 " of %" PRIu64 "!", r,
+                    s.matched, expected);
+            }
+
+            /* Narrow ranges over clustered data rule out most blocks */
+            if (r > 0 && stats.blocksSkipped < c.blocks / 2) {
+                ERR("Scan %zu skipped only %" PRIu64 " blocks!", r,
+                    stats.blocksSkipped);
+            }
+
+            uint64_t counted;
+            if (!varintColumnCount(&c, s.lo, s.hi, &counted, &stats) ||
+                counted != expected) {
+                ERR("Count %zu got %" PRIu64 " of %" PRIu64 "!", r, counted,
+                    expected);
+            }
+
+            /* Everything in range is counted from zone maps alone */
+            if (r == 0 && stats.blocksRead) {
+                ERR("Full range count decoded %" PRIu64 " blocks!",
+                    stats.blocksRead);
+            }
+        }
+    }
+
+    TEST("segments open from files with mmap") {
+        char path[] = "/tmp/varintColumnTestXXXXXX";
+        const int fd = mkstemp(path);
+        if (fd < 0) {
+            ERRR("Can't create temporary file!");
+        } else {
+            unlink(path);
+            if (write(fd, segment, len) != (ssize_t)len) {
+                ERRR("Short write!");
+            }
+
+            varintColumn mapped;
+            uint64_t counted = 0;
+            uint64_t expected = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                expected += !nulls[i] && values[i] == 42;
+            }
+
+            if (!varintColumnOpenFile(&mapped, fd) ||
+                !varintColumnCount(&mapped, 42, 42, &counted, NULL) ||
+                counted != expected) {
+                ERRR("Mapped segment count failed!");
+            }
+
+            varintColumnClose(&mapped);
+            close(fd);
+        }
+    }
+
+    TEST("malformed segments are rejected") {
+        uint8_t *bytes = (uint8_t *)segment;
+        varintColumn bad;
+        if (varintColumnOpen(&bad, bytes, len - 8) ||
+            varintColumnOpen(&bad, bytes, VARINT_COLUMN_HEADER_BYTES - 1)) {
+            ERRR("Truncated segment opened!");
+        }
+
+        /* Zone count larger than the block size */
+        uint8_t *zone = bytes + VARINT_COLUMN_HEADER_BYTES;
+        zone[28] ^= 0xff;
+        if (varintColumnOpen(&bad, bytes, len)) {
+            ERRR("Bad zone count opened!");
+        }
+
+        zone[28] ^= 0xff;
+
+        /* Truncated Tagged varints fail to decode instead of overrunning */
+        uint64_t *trimmed;
+        uint64_t wide[4] = {0, UINT64_MAX, 1, UINT64_MAX - 1};
+        const size_t trimmedLen = encode(&trimmed, wide, NULL, 4);
+        uint8_t *tz = (uint8_t *)trimmed + VARINT_COLUMN_HEADER_BYTES;
+        if (tz[36] != VARINT_COLUMN_TAGGED) {
+            ERRR("Wide values weren't Tagged!");
+        }
+
+        tz[24] -= 3; /* payload length */
+        if (!varintColumnOpen(&bad, (uint8_t *)trimmed, trimmedLen) ||
+            varintColumnBlockDecode(&bad, 0, out, NULL)) {
+            ERRR("Short Tagged payload decoded!");
+        }
+
+        free(trimmed);
+
+        /* Empty columns are valid */
+        uint64_t *empty;
+        const size_t emptyLen = encode(&empty, NULL, NULL, 0);
+        if (!varintColumnOpen(&bad, (uint8_t *)empty, emptyLen) ||
+            bad.blocks || bad.count) {
+            ERRR("Empty segment failed!");
+        }
+
+        free(empty);
+    }
+
+    free(segment);
+    free(values);
+    free(nulls);
+    free(out);
+    free(outNulls);
+
+    TEST_FINAL_RESULT;
+}
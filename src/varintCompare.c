@@ -3,6 +3,7 @@
 
 #include "varintExternal.h"
 #include "varintExternalBigEndian.h"
+#include "varintPrefix.h"
 #include "varintSplit.h"
 #include "varintSplitFull.h"
 #include "varintSplitFull16.h"
@@ -193,6 +194,24 @@ int32_t main(int argc, char **argv) {
         ACCOUNT_FINAL
     }
 
+    {
+        SETUP("prefix varint", "prefix")
+        for (i = 0; i < maxLoop; i++) {
+            GIVE_XZ;
+
+            int32_t n1 = varintPrefixPut(z, x);
+            assert(n1 >= 1 && n1 <= 9);
+            uint64_t y = 0;
+            int32_t n2 = varintPrefixGetQuick_(z, &y);
+            assert(n1 == n2);
+            assert(x == y);
+
+            ACCOUNT_LOOP;
+        }
+
+        ACCOUNT_FINAL
+    }
+
     {
         SETUP("chained simple varint using smaller numbers",
               "chained simple small")
@@ -0,0 +1,375 @@
+#include "varintCuckoo.h"
+#include "varintBitstream.h"
+#include "varintExternal.h"
+
+#include <string.h>
+
+/* ====================================================================
+ * Buckets
+ * ==================================================================== */
+#define LANES 4
+#define MAX_RELOCATIONS 500
+
+/* Keys hashed and prefetched ahead of each batch probe */
+#define BATCH 16
+
+#define HEADER_BYTES 40
+
+static const uint8_t varintCuckooMagic_[4] = {'V', 'C', 'F', '1'};
+
+/* splitmix64 finalizer */
+static uint64_t varintCuckooMix_(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t varintCuckooAlt_(const varintCuckoo *f, uint64_t index,
+                                 uint32_t fingerprint) {
+    return index ^ (varintCuckooMix_(fingerprint) & (f->bucketCount - 1));
+}
+
+typedef struct varintCuckooProbe_ {
+    uint64_t index;
+    uint64_t alt;
+    uint32_t fingerprint;
+} varintCuckooProbe_;
+
+static void varintCuckooHash_(const varintCuckoo *f, uint64_t key,
+                              varintCuckooProbe_ *probe) {
+    const uint64_t h = varintCuckooMix_(key);
+    const uint64_t fingerprintMax = (1ULL << f->bits) - 1;
+
+    /* Fingerprints are 1 to fingerprintMax; 0 marks an empty lane */
+    probe->fingerprint = (uint32_t)((((h >> 32) * fingerprintMax) >> 32) + 1);
+    probe->index = h & (f->bucketCount - 1);
+    probe->alt = varintCuckooAlt_(f, probe->index, probe->fingerprint);
+}
+
+static size_t varintCuckooSlots_(uint64_t bucketCount, uint8_t bits) {
+    return (bucketCount * LANES * bits + 63) / 64;
+}
+
+static uint64_t varintCuckooBucketGet_(const varintCuckoo *f,
+                                       uint64_t index) {
+    const size_t bucketBits = (size_t)LANES * f->bits;
+    return varintBitstreamGet(f->buckets, index * bucketBits, bucketBits);
+}
+
+static void varintCuckooBucketSet_(varintCuckoo *f, uint64_t index,
+                                   uint64_t bucket) {
+    const size_t bucketBits = (size_t)LANES * f->bits;
+    varintBitstreamSet(f->buckets, index * bucketBits, bucketBits, bucket);
+}
+
+static void varintCuckooPrefetch_(const varintCuckoo *f, uint64_t index) {
+    __builtin_prefetch(&f->buckets[index * LANES * f->bits / 64]);
+}
+
+/* Lowest bit of each lane */
+static uint64_t varintCuckooOnes_(uint8_t bits) {
+    return 1 | 1ULL << bits | 1ULL << (2 * bits) | 1ULL << (3 * bits);
+}
+
+/* Nonzero if any lane of 'bucket' holds 'fingerprint'.  The lowest set
+ * bit is the high bit of the lowest matching lane (higher lanes may
+ * report false matches, but only above a true one). */
+static uint64_t varintCuckooMatch_(uint8_t bits, uint64_t bucket,
+                                   uint32_t fingerprint) {
+    const uint64_t ones = varintCuckooOnes_(bits);
+    const uint64_t x = bucket ^ (fingerprint * ones);
+    return (x - ones) & ~x & (ones << (bits - 1));
+}
+
+static bool varintCuckooPlace_(varintCuckoo *f, uint64_t index,
+                               uint32_t fingerprint) {
+    uint64_t bucket = varintCuckooBucketGet_(f, index);
+    const uint64_t empty = varintCuckooMatch_(f->bits, bucket, 0);
+    if (!empty) {
+        return false;
+    }
+
+    const uint32_t shift = __builtin_ctzll(empty) / f->bits * f->bits;
+    bucket |= (uint64_t)fingerprint << shift;
+    varintCuckooBucketSet_(f, index, bucket);
+    return true;
+}
+
+static bool varintCuckooRemove_(varintCuckoo *f, uint64_t index,
+                                uint32_t fingerprint) {
+    uint64_t bucket = varintCuckooBucketGet_(f, index);
+    const uint64_t match = varintCuckooMatch_(f->bits, bucket, fingerprint);
+    if (!match) {
+        return false;
+    }
+
+    const uint32_t shift = __builtin_ctzll(match) / f->bits * f->bits;
+    bucket &= ~(((1ULL << f->bits) - 1) << shift);
+    varintCuckooBucketSet_(f, index, bucket);
+    return true;
+}
+
+static uint64_t varintCuckooRandom_(varintCuckoo *f) {
+    f->random = f->random * 6364136223846793005ULL + 1442695040888963407ULL;
+    return f->random >> 33;
+}
+
+/* Store 'fingerprint' in bucket 'index' or its alternate, relocating
+ * other fingerprints to their alternates to make room.  If relocation
+ * runs too long, the fingerprint left over becomes the victim. */
+static void varintCuckooStore_(varintCuckoo *f, uint64_t index,
+                               uint32_t fingerprint) {
+    f->count++;
+    if (varintCuckooPlace_(f, index, fingerprint)) {
+        return;
+    }
+
+    index = varintCuckooAlt_(f, index, fingerprint);
+    if (varintCuckooPlace_(f, index, fingerprint)) {
+        return;
+    }
+
+    const uint64_t fingerprintMask = (1ULL << f->bits) - 1;
+    for (uint32_t i = 0; i < MAX_RELOCATIONS; i++) {
+        /* Swap with a random lane, then move its old fingerprint */
+        const uint32_t shift = varintCuckooRandom_(f) % LANES * f->bits;
+        uint64_t bucket = varintCuckooBucketGet_(f, index);
+        const uint32_t evicted = (bucket >> shift) & fingerprintMask;
+        bucket &= ~(fingerprintMask << shift);
+        bucket |= (uint64_t)fingerprint << shift;
+        varintCuckooBucketSet_(f, index, bucket);
+
+        fingerprint = evicted;
+        index = varintCuckooAlt_(f, index, fingerprint);
+        if (varintCuckooPlace_(f, index, fingerprint)) {
+            return;
+        }
+    }
+
+    f->victimIndex = index;
+    f->victimFingerprint = fingerprint;
+}
+
+/* ====================================================================
+ * Filters
+ * ==================================================================== */
+bool varintCuckooInit(varintCuckoo *f, uint64_t capacity, uint8_t bits) {
+    memset(f, 0, sizeof(*f));
+    if (bits < VARINT_CUCKOO_BITS_MIN || bits > VARINT_CUCKOO_BITS_MAX) {
+        return false;
+    }
+
+    /* Enough buckets to hold 'capacity' keys at 95% full */
+    const uint64_t needed = (capacity * 100 + 379) / 380;
+    uint64_t bucketCount = 1;
+    while (bucketCount < needed) {
+        bucketCount <<= 1;
+    }
+
+    f->buckets = calloc(varintCuckooSlots_(bucketCount, bits), 8);
+    if (!f->buckets) {
+        return false;
+    }
+
+    f->bucketCount = bucketCount;
+    f->bits = bits;
+    f->random = 0x2545f4914f6cdd1dULL;
+    return true;
+}
+
+void varintCuckooFree(varintCuckoo *f) {
+    free(f->buckets);
+    memset(f, 0, sizeof(*f));
+}
+
+size_t varintCuckooBytes(const varintCuckoo *f) {
+    return varintCuckooSlots_(f->bucketCount, f->bits) * 8;
+}
+
+static bool varintCuckooInsertProbe_(varintCuckoo *f,
+                                     const varintCuckooProbe_ *probe) {
+    /* A victim means relocation already failed once: we're full */
+    if (f->victimFingerprint) {
+        return false;
+    }
+
+    varintCuckooStore_(f, probe->index, probe->fingerprint);
+    return true;
+}
+
+static bool varintCuckooContainsProbe_(const varintCuckoo *f,
+                                       const varintCuckooProbe_ *probe) {
+    const uint32_t fp = probe->fingerprint;
+    return varintCuckooMatch_(f->bits, varintCuckooBucketGet_(f, probe->index),
+                              fp) ||
+           varintCuckooMatch_(f->bits, varintCuckooBucketGet_(f, probe->alt),
+                              fp) ||
+           (f->victimFingerprint == fp && (f->victimIndex == probe->index ||
+                                           f->victimIndex == probe->alt));
+}
+
+bool varintCuckooInsert(varintCuckoo *f, uint64_t key) {
+    varintCuckooProbe_ probe;
+    varintCuckooHash_(f, key, &probe);
+    return varintCuckooInsertProbe_(f, &probe);
+}
+
+bool varintCuckooContains(const varintCuckoo *f, uint64_t key) {
+    varintCuckooProbe_ probe;
+    varintCuckooHash_(f, key, &probe);
+    return varintCuckooContainsProbe_(f, &probe);
+}
+
+bool varintCuckooDelete(varintCuckoo *f, uint64_t key) {
+    varintCuckooProbe_ probe;
+    varintCuckooHash_(f, key, &probe);
+    const uint32_t fp = probe.fingerprint;
+
+    if (f->victimFingerprint == fp &&
+        (f->victimIndex == probe.index || f->victimIndex == probe.alt)) {
+        f->victimFingerprint = 0;
+        f->count--;
+        return true;
+    }
+
+    if (!varintCuckooRemove_(f, probe.index, fp) &&
+        !varintCuckooRemove_(f, probe.alt, fp)) {
+        return false;
+    }
+
+    f->count--;
+
+    /* A bucket has room again, so the victim may fit now */
+    if (f->victimFingerprint) {
+        const uint32_t victim = f->victimFingerprint;
+        f->victimFingerprint = 0;
+        f->count--;
+        varintCuckooStore_(f, f->victimIndex, victim);
+    }
+
+    return true;
+}
+
+size_t varintCuckooInsertBatch(varintCuckoo *f, const uint64_t *keys,
+                               size_t count) {
+    varintCuckooProbe_ probes[BATCH];
+    for (size_t start = 0; start < count; start += BATCH) {
+        const size_t n = count - start < BATCH ? count - start : BATCH;
+        for (size_t i = 0; i < n; i++) {
+            varintCuckooHash_(f, keys[start + i], &probes[i]);
+            varintCuckooPrefetch_(f, probes[i].index);
+            varintCuckooPrefetch_(f, probes[i].alt);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (!varintCuckooInsertProbe_(f, &probes[i])) {
+                return start + i;
+            }
+        }
+    }
+
+    return count;
+}
+
+void varintCuckooContainsBatch(const varintCuckoo *f, const uint64_t *keys,
+                               size_t count, uint8_t *found) {
+    varintCuckooProbe_ probes[BATCH];
+    for (size_t start = 0; start < count; start += BATCH) {
+        const size_t n = count - start < BATCH ? count - start : BATCH;
+        for (size_t i = 0; i < n; i++) {
+            varintCuckooHash_(f, keys[start + i], &probes[i]);
+            varintCuckooPrefetch_(f, probes[i].index);
+            varintCuckooPrefetch_(f, probes[i].alt);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            found[start + i] = varintCuckooContainsProbe_(f, &probes[i]);
+        }
+    }
+}
+
+/* ====================================================================
+ * Serialization
+ * ==================================================================== */
+size_t varintCuckooSerializedBytes(const varintCuckoo *f) {
+    return HEADER_BYTES + varintCuckooBytes(f);
+}
+
+void varintCuckooSerialize(const varintCuckoo *f, uint8_t *dst) {
+    memset(dst, 0, HEADER_BYTES);
+    memcpy(dst, varintCuckooMagic_, sizeof(varintCuckooMagic_));
+    dst[4] = f->bits;
+    varintExternalPutFixedWidth(dst + 8, f->bucketCount, VARINT_WIDTH_64B);
+    varintExternalPutFixedWidth(dst + 16, f->count, VARINT_WIDTH_64B);
+    varintExternalPutFixedWidth(dst + 24, f->victimIndex, VARINT_WIDTH_64B);
+    varintExternalPutFixedWidth(dst + 32, f->victimFingerprint,
+                                VARINT_WIDTH_32B);
+
+    const size_t slots = varintCuckooSlots_(f->bucketCount, f->bits);
+    for (size_t i = 0; i < slots; i++) {
+        varintExternalPutFixedWidth(dst + HEADER_BYTES + i * 8,
+                                    f->buckets[i], VARINT_WIDTH_64B);
+    }
+}
+
+bool varintCuckooDeserialize(varintCuckoo *f, const uint8_t *src,
+                             size_t len) {
+    memset(f, 0, sizeof(*f));
+    if (len < HEADER_BYTES ||
+        memcmp(src, varintCuckooMagic_, sizeof(varintCuckooMagic_))) {
+        return false;
+    }
+
+    const uint8_t bits = src[4];
+    const uint64_t bucketCount = varintExternalGet(src + 8, VARINT_WIDTH_64B);
+    const uint64_t count = varintExternalGet(src + 16, VARINT_WIDTH_64B);
+    const uint64_t victimIndex = varintExternalGet(src + 24, VARINT_WIDTH_64B);
+    const uint32_t victimFingerprint =
+        (uint32_t)varintExternalGet(src + 32, VARINT_WIDTH_32B);
+    if (bits < VARINT_CUCKOO_BITS_MIN || bits > VARINT_CUCKOO_BITS_MAX ||
+        !bucketCount || (bucketCount & (bucketCount - 1)) ||
+        bucketCount > (len - HEADER_BYTES) ||
+        varintCuckooSlots_(bucketCount, bits) * 8 != len - HEADER_BYTES ||
+        victimFingerprint >> bits ||
+        (victimFingerprint && victimIndex >= bucketCount)) {
+        return false;
+    }
+
+    const size_t slots = varintCuckooSlots_(bucketCount, bits);
+    f->buckets = malloc(slots * 8);
+    if (!f->buckets) {
+        return false;
+    }
+
+    for (size_t i = 0; i < slots; i++) {
+        f->buckets[i] =
+            varintExternalGet(src + HEADER_BYTES + i * 8, VARINT_WIDTH_64B);
+    }
+
+    f->bucketCount = bucketCount;
+    f->bits = bits;
+    f->victimIndex = victimIndex;
+    f->victimFingerprint = victimFingerprint;
+    f->random = 0x2545f4914f6cdd1dULL;
+
+    /* Count must agree with the fingerprints actually stored */
+    const uint64_t fingerprintMask = (1ULL << bits) - 1;
+    uint64_t stored = victimFingerprint ? 1 : 0;
+    for (uint64_t i = 0; i < bucketCount; i++) {
+        const uint64_t bucket = varintCuckooBucketGet_(f, i);
+        for (uint32_t lane = 0; lane < LANES; lane++) {
+            stored += ((bucket >> (lane * bits)) & fingerprintMask) != 0;
+        }
+    }
+
+    if (stored != count) {
+        varintCuckooFree(f);
+        return false;
+    }
+
+    f->count = count;
+    return true;
+}
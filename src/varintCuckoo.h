@@ -0,0 +1,81 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Cuckoo filters of packed fingerprints
+ * ==================================================================== */
+/* Approximate set membership with deletion.  Each key keeps one
+ * 'bits' wide fingerprint (4 to 16 bits) in one of two candidate buckets
+ * of 4 fingerprints.  A bucket is packed into 4 * 'bits' bits of one
+ * varintBitstream, so 12 bit fingerprints take 12 bits each (not 16) and
+ * a bucket is read with one bit extraction then compared against all 4
+ * lanes at once.
+ *
+ * False positive rate is about 8 / 2^bits (0.2% at 12 bits, 0.012% at
+ * 16 bits).  Filters hold up to about 95% of 4 * buckets keys.
+ *
+ * Keys are 64 bit integers (hash strings to 64 bits first); they are
+ * mixed again here, so sequential ids are fine.  Inserting the same key
+ * twice stores it twice and needs two deletes.  Deleting a key that was
+ * never inserted may delete another key's fingerprint. */
+
+typedef struct varintCuckoo {
+    uint64_t *buckets; /* varintBitstream slots */
+    uint64_t bucketCount; /* power of two */
+    uint64_t count; /* fingerprints stored, including the victim */
+    uint64_t random; /* chooses fingerprints to relocate */
+    uint64_t victimIndex; /* bucket of the fingerprint no bucket had */
+    uint32_t victimFingerprint; /* 0 if there's no victim */
+    uint8_t bits;
+} varintCuckoo;
+
+#define VARINT_CUCKOO_BITS_MIN 4
+#define VARINT_CUCKOO_BITS_MAX 16
+
+/* Size 'f' to hold 'capacity' keys with 'bits' wide fingerprints.
+ * Returns false if 'bits' is out of range or allocation fails. */
+bool varintCuckooInit(varintCuckoo *f, uint64_t capacity, uint8_t bits);
+void varintCuckooFree(varintCuckoo *f);
+
+/* Bytes of fingerprint storage */
+size_t varintCuckooBytes(const varintCuckoo *f);
+
+/* Returns false (and changes nothing) if the filter is full. */
+bool varintCuckooInsert(varintCuckoo *f, uint64_t key);
+bool varintCuckooContains(const varintCuckoo *f, uint64_t key);
+
+/* Returns false if no fingerprint of 'key' is stored. */
+bool varintCuckooDelete(varintCuckoo *f, uint64_t key);
+
+/* Batches hash and prefetch the buckets of a group of keys before
+ * touching any of them, overlapping the cache misses of large filters.
+ *
+ * Insert returns how many of 'keys' were inserted (in order; it stops at
+ * the first key that doesn't fit).  Contains sets found[i] to 1 if
+ * keys[i] may be present and 0 if it's absent. */
+size_t varintCuckooInsertBatch(varintCuckoo *f, const uint64_t *keys,
+                               size_t count);
+void varintCuckooContainsBatch(const varintCuckoo *f, const uint64_t *keys,
+                               size_t count, uint8_t *found);
+
+/* ====================================================================
+ * Serialization
+ * ==================================================================== */
+/* Serialized filters are little endian on every host:
+ *   header 40 bytes: "VCF1", bits, 3 reserved bytes, bucket count,
+ *                    count, victim bucket, victim fingerprint (4 bytes),
+ *                    4 reserved bytes
+ *   slots  the varintBitstream slots as 8 byte words */
+size_t varintCuckooSerializedBytes(const varintCuckoo *f);
+
+/* Write 'f' into 'dst' (varintCuckooSerializedBytes() long). */
+void varintCuckooSerialize(const varintCuckoo *f, uint8_t *dst);
+
+/* Load a copy of a serialized filter into 'f' (free with
+ * varintCuckooFree()).  Returns false if 'src' is malformed or
+ * allocation fails. */
+bool varintCuckooDeserialize(varintCuckoo *f, const uint8_t *src, size_t len);
+
+__END_DECLS
@@ -0,0 +1,220 @@
+#include "varintCuckoo.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 100000
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(67);
+
+    uint64_t *keys = malloc(COUNT * sizeof(*keys));
+    uint64_t *others = malloc(COUNT * sizeof(*others));
+    uint8_t *found = malloc(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        keys[i] = ctestRandom();
+        others[i] = ctestRandom();
+    }
+
+    TEST("every fingerprint width finds its keys") {
+        for (uint8_t bits = VARINT_CUCKOO_BITS_MIN;
+             bits <= VARINT_CUCKOO_BITS_MAX; bits++) {
+            varintCuckoo f;
+            if (!varintCuckooInit(&f, COUNT, bits)) {
+                ERR("Init %u failed!", bits);
+                continue;
+            }
+
+            /* 12 bit fingerprints pack 25% smaller than 16 bit ones */
+            if (varintCuckooBytes(&f) != f.bucketCount * 4 * bits / 8) {
+                ERR("Width %u uses %zu bytes!", bits, varintCuckooBytes(&f));
+            }
+
+            for (size_t i = 0; i < COUNT; i++) {
+                if (!varintCuckooInsert(&f, keys[i])) {
+                    ERR("Width %u insert %zu failed!", bits, i);
+                    break;
+                }
+            }
+
+            size_t falsePositives = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                if (!varintCuckooContains(&f, keys[i])) {
+                    ERR("Width %u lost key %zu!", bits, i);
+                    break;
+                }
+
+                falsePositives += varintCuckooContains(&f, others[i]);
+            }
+
+            /* Expected rate is about 2 * 4 / 2^bits at full buckets */
+            const size_t limit = COUNT * 8 / ((1 << bits) - 1) + 50;
+            if (falsePositives > limit) {
+                ERR("Width %u has %zu false positives (limit %zu)!", bits,
+                    falsePositives, limit);
+            }
+
+            varintCuckooFree(&f);
+        }
+    }
+
+    TEST("deleted keys go away and the rest stay") {
+        varintCuckoo f;
+        varintCuckooInit(&f, COUNT, 12);
+        for (size_t i = 0; i < COUNT; i++) {
+            varintCuckooInsert(&f, keys[i]);
+        }
+
+        for (size_t i = 0; i < COUNT; i += 2) {
+            if (!varintCuckooDelete(&f, keys[i])) {
+                ERR("Delete %zu failed!", i);
+                break;
+            }
+        }
+
+        size_t stillThere = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            if (i % 2) {
+                if (!varintCuckooContains(&f, keys[i])) {
+                    ERR("Lost key %zu after deletes!", i);
+                    break;
+                }
+            } else {
+                stillThere += varintCuckooContains(&f, keys[i]);
+            }
+        }
+
+        if (f.count != COUNT / 2 || stillThere > COUNT / 100) {
+            ERR("%" PRIu64 " stored, %zu deleted keys still present!",
+                f.count, stillThere);
+        }
+
+        /* Deleting everything leaves an empty filter */
+        for (size_t i = 1; i < COUNT; i += 2) {
+            varintCuckooDelete(&f, keys[i]);
+        }
+
+        for (size_t i = 0; i < varintCuckooBytes(&f) / 8; i++) {
+            if (f.buckets[i]) {
+                ERR("Slot %zu not empty after deleting everything!", i);
+                break;
+            }
+        }
+
+        varintCuckooFree(&f);
+    }
+
+    TEST("filling up keeps every inserted key") {
+        varintCuckoo f;
+        varintCuckooInit(&f, 1000, 16);
+        const uint64_t slots = f.bucketCount * 4;
+        size_t inserted = 0;
+        while (inserted < COUNT && varintCuckooInsert(&f, keys[inserted])) {
+            inserted++;
+        }
+
+        if (inserted < slots * 9 / 10 || inserted > slots + 1) {
+            ERR("Filled %zu of %" PRIu64 " slots!", inserted, slots);
+        }
+
+        for (size_t i = 0; i < inserted; i++) {
+            if (!varintCuckooContains(&f, keys[i])) {
+                ERR("Full filter lost key %zu!", i);
+                break;
+            }
+        }
+
+        /* Removing one key makes room again */
+        varintCuckooDelete(&f, keys[0]);
+        if (!varintCuckooInsert(&f, keys[0]) ||
+            !varintCuckooContains(&f, keys[inserted - 1])) {
+            ERRR("Insert after delete failed!");
+        }
+
+        varintCuckooFree(&f);
+    }
+
+    TEST("batches match single operations") {
+        varintCuckoo single;
+        varintCuckoo batch;
+        varintCuckooInit(&single, COUNT, 12);
+        varintCuckooInit(&batch, COUNT, 12);
+        for (size_t i = 0; i < COUNT; i++) {
+            varintCuckooInsert(&single, keys[i]);
+        }
+
+        if (varintCuckooInsertBatch(&batch, keys, COUNT) != COUNT ||
+            memcmp(single.buckets, batch.buckets,
+                   varintCuckooBytes(&single))) {
+            ERRR("Batch insert differs!");
+        }
+
+        /* Odd count leaves a partial last batch */
+        varintCuckooContainsBatch(&batch, others, COUNT - 3, found);
+        for (size_t i = 0; i < COUNT - 3; i++) {
+            if (found[i] != varintCuckooContains(&single, others[i])) {
+                ERR("Batch lookup %zu differs!", i);
+                break;
+            }
+        }
+
+        varintCuckooFree(&single);
+        varintCuckooFree(&batch);
+    }
+
+    TEST("serialized filters round trip") {
+        varintCuckoo f;
+        varintCuckooInit(&f, 5000, 12);
+        varintCuckooInsertBatch(&f, keys, 5000);
+
+        const size_t len = varintCuckooSerializedBytes(&f);
+        uint8_t *buf = malloc(len);
+        varintCuckooSerialize(&f, buf);
+
+        varintCuckoo loaded;
+        if (!varintCuckooDeserialize(&loaded, buf, len) ||
+            loaded.count != f.count ||
+            memcmp(loaded.buckets, f.buckets, varintCuckooBytes(&f))) {
+            ERRR("Deserialize failed!");
+        }
+
+        for (size_t i = 0; i < 5000; i++) {
+            if (!varintCuckooContains(&loaded, keys[i])) {
+                ERR("Loaded filter lost key %zu!", i);
+                break;
+            }
+        }
+
+        varintCuckooFree(&loaded);
+
+        varintCuckoo bad;
+        if (varintCuckooDeserialize(&bad, buf, len - 1)) {
+            ERRR("Truncated filter loaded!");
+        }
+
+        buf[16] ^= 1; /* count */
+        if (varintCuckooDeserialize(&bad, buf, len)) {
+            ERRR("Filter with wrong count loaded!");
+        }
+
+        buf[16] ^= 1;
+        buf[4] = 17; /* bits */
+        if (varintCuckooDeserialize(&bad, buf, len)) {
+            ERRR("Filter with bad width loaded!");
+        }
+
+        free(buf);
+        varintCuckooFree(&f);
+    }
+
+    free(keys);
+    free(others);
+    free(found);
+
+    TEST_FINAL_RESULT;
+}
@@ -1,5 +1,12 @@
 #include "varintExternal.h"
 #include "endianIsLittle.h"
+#include "varintExternalShuffle.h"
+
+#include <string.h>
+
+#if defined(__AVX512VBMI__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
 
 /* _varintExternalCopyToEncodingLittleEndian is an unrolled version of:
  *       for (int start = 0; start < encoding; start++) {
@@ -260,7 +267,7 @@ static varintWidth varintExternalAdd_(uint8_t *p, varintWidth origEncoding,
     VARINT_ADD_OR_ABORT_OVERFLOW_(updatingVal, add, newVal);
 
     varintWidth newEncoding;
-    varintExternalUnsignedEncoding(updatingVal, newEncoding);
+    varintExternalUnsignedEncoding((uint64_t)newVal, newEncoding);
 
     /* If new encoding is larger than current encoding, we don't
      * want to overwrite memory beyond our current varint.
@@ -285,3 +292,127 @@ varintWidth varintExternalAddGrow(uint8_t *p, varintWidth encoding,
                                   int64_t add) {
     return varintExternalAdd_(p, encoding, add, true);
 }
+
+/* ====================================================================
+ * Bulk widening and narrowing
+ * ==================================================================== */
+/* Returns how many leading values were moved by shuffles; the caller
+ * finishes the rest one at a time. */
+static size_t varintExternalUnpackVector_(const uint8_t *src, void *vals,
+                                          size_t count, varintWidth width,
+                                          uint32_t laneBytes) {
+    size_t i = 0;
+    if (!endianIsLittle()) {
+        return 0;
+    }
+
+#if defined(__AVX512VBMI__)
+    const uint32_t lanes = 64 / laneBytes;
+    uint8_t control[64];
+    varintExternalShuffleUnpack_(control, 64, laneBytes, width, false);
+    const __m512i shuffle = _mm512_loadu_si512(control);
+    const uint32_t inBytes = lanes * width;
+    const __mmask64 fields =
+        inBytes == 64 ? ~0ULL : (1ULL << inBytes) - 1;
+    const __mmask64 keep = varintExternalShuffleKeep_(control);
+    for (; i + lanes <= count; i += lanes) {
+        const __m512i in = _mm512_maskz_loadu_epi8(fields, src + i * width);
+        _mm512_storeu_si512((uint8_t *)vals + i * laneBytes,
+                            _mm512_maskz_permutexvar_epi8(keep, shuffle, in));
+    }
+#elif defined(__SSSE3__)
+    const uint32_t lanes = 16 / laneBytes;
+    uint8_t control[16];
+    varintExternalShuffleUnpack_(control, 16, laneBytes, width, false);
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *)control);
+    for (; i + lanes <= count && (count - i) * width >= 16; i += lanes) {
+        const __m128i in = _mm_loadu_si128((const __m128i *)(src + i * width));
+        _mm_storeu_si128((__m128i *)((uint8_t *)vals + i * laneBytes),
+                         _mm_shuffle_epi8(in, shuffle));
+    }
+#else
+    (void)src;
+    (void)vals;
+    (void)count;
+    (void)width;
+    (void)laneBytes;
+#endif
+
+    return i;
+}
+
+static size_t varintExternalPackVector_(uint8_t *dst, const void *vals,
+                                        size_t count, varintWidth width,
+                                        uint32_t laneBytes) {
+    size_t i = 0;
+    if (!endianIsLittle()) {
+        return 0;
+    }
+
+#if defined(__AVX512VBMI__)
+    const uint32_t lanes = 64 / laneBytes;
+    uint8_t control[64];
+    varintExternalShufflePack_(control, 64, laneBytes, width, false);
+    const __m512i shuffle = _mm512_loadu_si512(control);
+    const uint32_t outBytes = lanes * width;
+    const __mmask64 fields =
+        outBytes == 64 ? ~0ULL : (1ULL << outBytes) - 1;
+    for (; i + lanes <= count; i += lanes) {
+        const __m512i in =
+            _mm512_loadu_si512((const uint8_t *)vals + i * laneBytes);
+        _mm512_mask_storeu_epi8(dst + i * width, fields,
+                                _mm512_permutexvar_epi8(shuffle, in));
+    }
+#elif defined(__SSSE3__)
+    const uint32_t lanes = 16 / laneBytes;
+    uint8_t control[16];
+    varintExternalShufflePack_(control, 16, laneBytes, width, false);
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *)control);
+    for (; i + lanes <= count && (count - i) * width >= 16; i += lanes) {
+        const __m128i in = _mm_loadu_si128(
+            (const __m128i *)((const uint8_t *)vals + i * laneBytes));
+        _mm_storeu_si128((__m128i *)(dst + i * width),
+                         _mm_shuffle_epi8(in, shuffle));
+    }
+#else
+    (void)dst;
+    (void)vals;
+    (void)count;
+    (void)width;
+    (void)laneBytes;
+#endif
+
+    return i;
+}
+
+void varintExternalUnpackArray32(const uint8_t *src, uint32_t *vals,
+                                 size_t count, varintWidth encoding) {
+    size_t i = varintExternalUnpackVector_(src, vals, count, encoding, 4);
+    for (; i < count; i++) {
+        vals[i] = (uint32_t)varintExternalGet(src + i * encoding, encoding);
+    }
+}
+
+void varintExternalUnpackArray64(const uint8_t *src, uint64_t *vals,
+                                 size_t count, varintWidth encoding) {
+    size_t i = varintExternalUnpackVector_(src, vals, count, encoding, 8);
+    for (; i < count; i++) {
+        vals[i] = varintExternalGet(src + i * encoding, encoding);
+    }
+}
+
+void varintExternalPackArray32(uint8_t *dst, const uint32_t *vals,
+                               size_t count, varintWidth encoding) {
+    size_t i = varintExternalPackVector_(dst, vals, count, encoding, 4);
+    for (; i < count; i++) {
+        varintExternalPutFixedWidth(dst + i * encoding, vals[i], encoding);
+    }
+}
+
+void varintExternalPackArray64(uint8_t *dst, const uint64_t *vals,
+                               size_t count, varintWidth encoding) {
+    size_t i = varintExternalPackVector_(dst, vals, count, encoding, 8);
+    for (; i < count; i++) {
+        varintExternalPutFixedWidth(dst + i * encoding, vals[i], encoding);
+    }
+}
@@ -77,11 +77,29 @@ uint64_t varintExternalGet(const void *p, varintWidth encoding);
 __uint128_t varintBigExternalGet(const void *p, varintWidth encoding);
 #define varintExternalLen(v) varintExternalSignedEncoding((uint64_t)(v))
 varintWidth varintExternalSignedEncoding(int64_t value);
+/* Grow overwrites bytes after 'p'; see varintTaggedAddGrow() */
 varintWidth varintExternalAddNoGrow(uint8_t *p, varintWidth encoding,
                                     int64_t add);
 varintWidth varintExternalAddGrow(uint8_t *p, varintWidth encoding,
                                   int64_t add);
 
+/* Bulk widening and narrowing between 'count' External varints of one
+ * 'encoding' width stored back to back (as by varintExternalPutFixedWidth())
+ * and native integers.  The 32 bit versions take widths of 1 to 4 bytes,
+ * the 64 bit versions 1 to 8.  Values are moved with a shuffle control
+ * built for 'encoding': 16 (32 bit) or 8 (64 bit) values per VPERMB with
+ * AVX-512 VBMI, or 4 or 2 per PSHUFB with SSSE3.  Pack keeps the low
+ * 'encoding' bytes of each value.  Neither reads nor writes outside the
+ * 'count' varints (see varintExternalShuffle.h). */
+void varintExternalUnpackArray32(const uint8_t *src, uint32_t *vals,
+                                 size_t count, varintWidth encoding);
+void varintExternalUnpackArray64(const uint8_t *src, uint64_t *vals,
+                                 size_t count, varintWidth encoding);
+void varintExternalPackArray32(uint8_t *dst, const uint32_t *vals,
+                               size_t count, varintWidth encoding);
+void varintExternalPackArray64(uint8_t *dst, const uint64_t *vals,
+                               size_t count, varintWidth encoding);
+
 #define varintExternalUnsignedEncoding(value, encoding)                        \
     do {                                                                       \
         /* Increment encoding for each byte of 'value' with bits set. */       \
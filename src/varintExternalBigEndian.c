@@ -1,5 +1,12 @@
 #include "varintExternalBigEndian.h"
 #include "endianIsLittle.h"
+#include "varintExternalShuffle.h"
+
+#include <string.h>
+
+#if defined(__AVX512VBMI__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
 
 /* The unrolled loop version is about 20% faster than a direct loop. */
 static void _varintExternalBigEndianCopyToEncodingLittleEndian(
@@ -62,9 +69,14 @@ static void _varintExternalBigEndianCopyToEncodingLittleEndian(
         dst[0] = src[4];
         break;
 
-    case VARINT_WIDTH_64B:
-        *(uint64_t *)dst = __builtin_bswap64(*(uint64_t *)src);
+    case VARINT_WIDTH_64B: {
+        /* memcpy because bulk callers pass unaligned fields */
+        uint64_t swapped;
+        memcpy(&swapped, src, sizeof(swapped));
+        swapped = __builtin_bswap64(swapped);
+        memcpy(dst, &swapped, sizeof(swapped));
         break;
+    }
 
     default:
         assert(NULL);
@@ -162,3 +174,143 @@ uint64_t varintExternalBigEndianGet(const void *p, varintWidth encoding) {
         return _varintExternalBigEndianLoadFromEncodingBigEndian(p, encoding);
     }
 }
+
+/* ====================================================================
+ * Bulk fixed width
+ * ==================================================================== */
+void varintExternalBigEndianPutArray(uint8_t *dst, const uint64_t *vals,
+                                     size_t count, varintWidth encoding) {
+    size_t i = 0;
+    if (endianIsLittle()) {
+#if defined(__AVX512VBMI__)
+        uint8_t control[64];
+        varintExternalShufflePack_(control, 64, 8, encoding, true);
+        const __m512i shuffle = _mm512_loadu_si512(control);
+        const __mmask64 fields =
+            encoding == 8 ? ~0ULL : (1ULL << (8 * encoding)) - 1;
+        for (; i + 8 <= count; i += 8) {
+            const __m512i in = _mm512_loadu_si512(vals + i);
+            _mm512_mask_storeu_epi8(dst + i * encoding, fields,
+                                    _mm512_permutexvar_epi8(shuffle, in));
+        }
+#elif defined(__SSSE3__)
+        uint8_t control[16];
+        varintExternalShufflePack_(control, 16, 8, encoding, true);
+        const __m128i shuffle = _mm_loadu_si128((const __m128i *)control);
+        for (; i + 2 <= count && (count - i) * encoding >= 16; i += 2) {
+            const __m128i in = _mm_loadu_si128((const __m128i *)(vals + i));
+            _mm_storeu_si128((__m128i *)(dst + i * encoding),
+                             _mm_shuffle_epi8(in, shuffle));
+        }
+#endif
+    }
+
+    for (; i < count; i++) {
+        varintExternalBigEndianPutFixedWidth(dst + i * encoding, vals[i],
+                                             encoding);
+    }
+}
+
+void varintExternalBigEndianGetArray(const uint8_t *src, uint64_t *vals,
+                                     size_t count, varintWidth encoding) {
+    size_t i = 0;
+    if (endianIsLittle()) {
+#if defined(__AVX512VBMI__)
+        uint8_t control[64];
+        varintExternalShuffleUnpack_(control, 64, 8, encoding, true);
+        const __m512i shuffle = _mm512_loadu_si512(control);
+        const __mmask64 fields =
+            encoding == 8 ? ~0ULL : (1ULL << (8 * encoding)) - 1;
+        const __mmask64 keep = varintExternalShuffleKeep_(control);
+        for (; i + 8 <= count; i += 8) {
+            const __m512i in =
+                _mm512_maskz_loadu_epi8(fields, src + i * encoding);
+            _mm512_storeu_si512(vals + i,
+                                _mm512_maskz_permutexvar_epi8(keep, shuffle,
+                                                              in));
+        }
+#elif defined(__SSSE3__)
+        uint8_t control[16];
+        varintExternalShuffleUnpack_(control, 16, 8, encoding, true);
+        const __m128i shuffle = _mm_loadu_si128((const __m128i *)control);
+        for (; i + 2 <= count && (count - i) * encoding >= 16; i += 2) {
+            const __m128i in =
+                _mm_loadu_si128((const __m128i *)(src + i * encoding));
+            _mm_storeu_si128((__m128i *)(vals + i),
+                             _mm_shuffle_epi8(in, shuffle));
+        }
+#endif
+    }
+
+    for (; i < count; i++) {
+        vals[i] = varintExternalBigEndianGet(src + i * encoding, encoding);
+    }
+}
+
+/* ====================================================================
+ * Bulk mixed width
+ * ==================================================================== */
+static size_t varintExternalBigEndianWidthsTotal_(const uint8_t *widths,
+                                                  size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += widths[i];
+    }
+
+    return total;
+}
+
+size_t varintExternalBigEndianPutArrayWidths(uint8_t *dst,
+                                             const uint64_t *vals,
+                                             const uint8_t *widths,
+                                             size_t count) {
+    const size_t total = varintExternalBigEndianWidthsTotal_(widths, count);
+    const bool little = endianIsLittle();
+    size_t offset = 0;
+    size_t i = 0;
+
+    /* The 8 byte store's excess is rewritten by the fields after it */
+    for (; i < count && offset + 8 <= total; i++) {
+        uint64_t w = vals[i] << (64 - 8 * widths[i]);
+        if (little) {
+            w = __builtin_bswap64(w);
+        }
+
+        memcpy(dst + offset, &w, sizeof(w));
+        offset += widths[i];
+    }
+
+    for (; i < count; i++) {
+        varintExternalBigEndianPutFixedWidth(dst + offset, vals[i], widths[i]);
+        offset += widths[i];
+    }
+
+    return total;
+}
+
+size_t varintExternalBigEndianGetArrayWidths(const uint8_t *src,
+                                             uint64_t *vals,
+                                             const uint8_t *widths,
+                                             size_t count) {
+    const size_t total = varintExternalBigEndianWidthsTotal_(widths, count);
+    const bool little = endianIsLittle();
+    size_t offset = 0;
+    size_t i = 0;
+    for (; i < count && offset + 8 <= total; i++) {
+        uint64_t w;
+        memcpy(&w, src + offset, sizeof(w));
+        if (little) {
+            w = __builtin_bswap64(w);
+        }
+
+        vals[i] = w >> (64 - 8 * widths[i]);
+        offset += widths[i];
+    }
+
+    for (; i < count; i++) {
+        vals[i] = varintExternalBigEndianGet(src + offset, widths[i]);
+        offset += widths[i];
+    }
+
+    return total;
+}
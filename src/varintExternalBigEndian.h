@@ -14,6 +14,28 @@ void varintExternalBigEndianPutFixedWidth(void *p, uint64_t v,
                                           varintWidth encoding);
 uint64_t varintExternalBigEndianGet(const void *p, varintWidth encoding);
 
+/* Bulk encode and decode of 'count' fields of one 'encoding' width (1 to
+ * 8 bytes) back to back, as found in wire protocols.  Fields are byte
+ * reversed eight at a time with VPERMB (AVX-512 VBMI) or two at a time
+ * with PSHUFB (SSSE3), as for the External bulk codecs; values wider
+ * than 'encoding' keep their low bytes. */
+void varintExternalBigEndianPutArray(uint8_t *dst, const uint64_t *vals,
+                                     size_t count, varintWidth encoding);
+void varintExternalBigEndianGetArray(const uint8_t *src, uint64_t *vals,
+                                     size_t count, varintWidth encoding);
+
+/* Mixed width fields: field i is 'widths[i]' (1 to 8) bytes.  Fields
+ * at least 8 bytes before the end use one 8 byte load or store each.
+ * Both return the total bytes of all fields. */
+size_t varintExternalBigEndianPutArrayWidths(uint8_t *dst,
+                                             const uint64_t *vals,
+                                             const uint8_t *widths,
+                                             size_t count);
+size_t varintExternalBigEndianGetArrayWidths(const uint8_t *src,
+                                             uint64_t *vals,
+                                             const uint8_t *widths,
+                                             size_t count);
+
 #define varintExternalBigEndianUnsignedEncoding(value, encoding)               \
     do {                                                                       \
         /* Increment encoding for each byte of 'value' with bits set. */       \
@@ -0,0 +1,110 @@
+#include "varintExternalBigEndian.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 10007
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(53);
+
+    uint64_t *vals = malloc(COUNT * sizeof(*vals));
+    uint64_t *out = malloc(COUNT * sizeof(*out));
+    uint8_t *widths = malloc(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        vals[i] = ctestRandom();
+    }
+
+    TEST("fixed width arrays match single field coding") {
+        for (varintWidth width = 1; width <= 8; width++) {
+            const uint64_t mask = UINT64_MAX >> (64 - 8 * width);
+
+            /* Odd counts leave tails after every vector width */
+            for (size_t count = 0; count < 40; count++) {
+                /* Exactly sized buffers so ASan catches any overrun */
+                uint8_t *bulk = malloc(count * width + 1);
+                uint8_t *single = malloc(count * width + 1);
+                for (size_t i = 0; i < count; i++) {
+                    varintExternalBigEndianPutFixedWidth(single + i * width,
+                                                         vals[i], width);
+                }
+
+                varintExternalBigEndianPutArray(bulk, vals, count, width);
+                if (memcmp(bulk, single, count * width)) {
+                    ERR("Put width %d count %zu differs!", width, count);
+                }
+
+                varintExternalBigEndianGetArray(bulk, out, count, width);
+                for (size_t i = 0; i < count; i++) {
+                    if (out[i] != (vals[i] & mask)) {
+                        ERR("Get width %d count %zu index %zu failed!", width,
+                            count, i);
+                        break;
+                    }
+                }
+
+                free(bulk);
+                free(single);
+            }
+
+            /* Big endian byte order on the wire */
+            uint8_t field[8];
+            const uint64_t one = 1;
+            varintExternalBigEndianPutArray(field, &one, 1, width);
+            if (field[width - 1] != 1) {
+                ERR("Width %d isn't big endian!", width);
+            }
+        }
+    }
+
+    TEST("mixed width arrays round trip") {
+        size_t total = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            /* Wire protocol mix: mostly 3, 5, and 6 byte fields */
+            const uint8_t common[] = {3, 5, 6, 3, 5, 6, 1, 2, 4, 7, 8};
+            widths[i] = common[ctestRandom() % sizeof(common)];
+            total += widths[i];
+        }
+
+        uint8_t *bulk = malloc(total);
+        uint8_t *single = malloc(total);
+        size_t offset = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            varintExternalBigEndianPutFixedWidth(single + offset, vals[i],
+                                                 widths[i]);
+            offset += widths[i];
+        }
+
+        if (varintExternalBigEndianPutArrayWidths(bulk, vals, widths,
+                                                  COUNT) != total ||
+            memcmp(bulk, single, total)) {
+            ERRR("Mixed put differs!");
+        }
+
+        if (varintExternalBigEndianGetArrayWidths(bulk, out, widths,
+                                                  COUNT) != total) {
+            ERRR("Mixed get length wrong!");
+        }
+
+        for (size_t i = 0; i < COUNT; i++) {
+            if (out[i] != (vals[i] & (UINT64_MAX >> (64 - 8 * widths[i])))) {
+                ERR("Mixed get index %zu failed!", i);
+                break;
+            }
+        }
+
+        free(bulk);
+        free(single);
+    }
+
+    free(vals);
+    free(out);
+    free(widths);
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/* Byte shuffle controls for bulk External codecs */
+/* Controls move bytes between back to back 'width' byte fields and native
+ * lanes of 'laneBytes' bytes filling a 'vectorBytes' vector, keeping
+ * field bytes in order ('bigEndian' false) or reversing them (true).
+ * Bytes of a control which produce nothing are 0x80, which PSHUFB zeroes;
+ * VPERMB ignores the high bit, so its callers mask those bytes with
+ * varintExternalShuffleKeep_() instead.
+ *
+ * PSHUFB loops load and store whole 16 byte vectors, so they stop while at
+ * least 16 bytes of fields remain: loads never read past the input, and
+ * the excess of each store is rewritten by the fields after it.  VPERMB
+ * loops use masked loads and stores instead, so neither path touches
+ * memory outside the 'count' fields. */
+
+#if defined(__AVX512VBMI__) || defined(__SSSE3__)
+#include <immintrin.h>
+
+/* Fields to lanes */
+static inline void varintExternalShuffleUnpack_(uint8_t *control,
+                                                uint32_t vectorBytes,
+                                                uint32_t laneBytes,
+                                                varintWidth width,
+                                                bool bigEndian) {
+    for (uint32_t m = 0; m < vectorBytes; m++) {
+        const uint32_t j = m / laneBytes;
+        const uint32_t k = m % laneBytes;
+        const uint32_t from = bigEndian ? width - 1 - k : k;
+        control[m] = k < width ? (uint8_t)(j * width + from) : 0x80;
+    }
+}
+
+/* Lanes to fields */
+static inline void varintExternalShufflePack_(uint8_t *control,
+                                              uint32_t vectorBytes,
+                                              uint32_t laneBytes,
+                                              varintWidth width,
+                                              bool bigEndian) {
+    const uint32_t lanes = vectorBytes / laneBytes;
+    for (uint32_t m = 0; m < vectorBytes; m++) {
+        const uint32_t j = m / width;
+        const uint32_t k = m % width;
+        const uint32_t from = bigEndian ? width - 1 - k : k;
+        control[m] = j < lanes ? (uint8_t)(j * laneBytes + from) : 0x80;
+    }
+}
+#endif
+
+#if defined(__AVX512VBMI__)
+/* Bytes of a 64 byte control which produce something */
+static inline __mmask64 varintExternalShuffleKeep_(const uint8_t *control) {
+    __mmask64 keep = 0;
+    for (uint32_t m = 0; m < 64; m++) {
+        keep |= (__mmask64)(control[m] != 0x80) << m;
+    }
+
+    return keep;
+}
+#endif
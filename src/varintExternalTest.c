@@ -0,0 +1,81 @@
+#include "varintExternal.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 200
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(59);
+
+    uint64_t vals64[COUNT];
+    uint32_t vals32[COUNT];
+    uint64_t out64[COUNT];
+    uint32_t out32[COUNT];
+    for (size_t i = 0; i < COUNT; i++) {
+        vals64[i] = ctestRandom();
+        vals32[i] = (uint32_t)vals64[i];
+    }
+
+    TEST("array packing matches varintExternalPutFixedWidth()") {
+        for (varintWidth width = 1; width <= 8; width++) {
+            const uint64_t mask = UINT64_MAX >> (64 - 8 * width);
+
+            /* Every count up to several vectors, so each vector width
+             * leaves every possible tail */
+            for (size_t count = 0; count < COUNT; count++) {
+                /* Exactly sized buffers so ASan catches any overrun */
+                uint8_t *bulk = malloc(count * width + 1);
+                uint8_t *single = malloc(count * width + 1);
+                for (size_t i = 0; i < count; i++) {
+                    varintExternalPutFixedWidth(single + i * width, vals64[i],
+                                                width);
+                }
+
+                varintExternalPackArray64(bulk, vals64, count, width);
+                if (memcmp(bulk, single, count * width)) {
+                    ERR("Pack64 width %d count %zu differs!", width, count);
+                }
+
+                memset(out64, 0xa5, sizeof(out64));
+                varintExternalUnpackArray64(bulk, out64, count, width);
+                for (size_t i = 0; i < count; i++) {
+                    if (out64[i] != (vals64[i] & mask)) {
+                        ERR("Unpack64 width %d count %zu index %zu failed!",
+                            width, count, i);
+                        break;
+                    }
+                }
+
+                if (width <= 4) {
+                    varintExternalPackArray32(bulk, vals32, count, width);
+                    if (memcmp(bulk, single, count * width)) {
+                        ERR("Pack32 width %d count %zu differs!", width,
+                            count);
+                    }
+
+                    memset(out32, 0xa5, sizeof(out32));
+                    varintExternalUnpackArray32(bulk, out32, count, width);
+                    for (size_t i = 0; i < count; i++) {
+                        if (out32[i] != (uint32_t)(vals64[i] & mask)) {
+                            ERR("Unpack32 width %d count %zu index %zu "
+                                "failed!",
+                                width, count, i);
+                            break;
+                        }
+                    }
+                }
+
+                free(bulk);
+                free(single);
+            }
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,293 @@
+#include "varintGorilla.h"
+#include "varintBitstream.h"
+
+#include <string.h>
+
+#define COUNT_BITS 32
+
+/* Timestamp delta of delta buckets after their 1 to 4 control bits */
+static const uint8_t varintGorillaBucketBits_[5] = {0, 7, 9, 12, 64};
+
+/* Stored as (delta of delta + bias) so each bucket holds an unsigned
+ * field; the last bucket stores the raw 64 bit delta of delta. */
+static const int64_t varintGorillaBucketBias_[5] = {0, 63, 255, 2047, 0};
+
+static uint64_t varintGorillaDoubleBits_(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double varintGorillaBitsDouble_(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* ====================================================================
+ * Writing
+ * ==================================================================== */
+static void varintGorillaPut_(varintGorillaWriter *w, uint64_t val,
+                              uint32_t bits) {
+    varintBitstreamSet(w->dst, w->bitOffset, bits, val);
+    w->bitOffset += bits;
+}
+
+void varintGorillaWriterInit(varintGorillaWriter *w, uint64_t *dst,
+                             size_t dstBytes) {
+    memset(w, 0, sizeof(*w));
+    w->dst = dst;
+    w->capacityBits = dstBytes / 8 * 64;
+    if (w->capacityBits >= COUNT_BITS) {
+        varintBitstreamSet(dst, 0, COUNT_BITS, 0);
+        w->bitOffset = COUNT_BITS;
+    }
+}
+
+static void varintGorillaPutTimestamp_(varintGorillaWriter *w,
+                                       uint64_t timestamp) {
+    const uint64_t delta = timestamp - w->timestamp;
+    const int64_t dod = (int64_t)(delta - w->delta);
+    w->timestamp = timestamp;
+    w->delta = delta;
+
+    if (dod == 0) {
+        varintGorillaPut_(w, 0, 1);
+        return;
+    }
+
+    for (uint32_t bucket = 1; bucket < 4; bucket++) {
+        const int64_t bias = varintGorillaBucketBias_[bucket];
+        if (dod >= -bias && dod <= bias + 1) {
+            /* 'bucket' one bits then a zero, then the biased field */
+            const uint32_t bits = varintGorillaBucketBits_[bucket];
+            const uint64_t control = ((1ULL << bucket) - 1) << 1;
+            varintGorillaPut_(w, control << bits | (uint64_t)(dod + bias),
+                              bucket + 1 + bits);
+            return;
+        }
+    }
+
+    varintGorillaPut_(w, 0xf, 4);
+    varintGorillaPut_(w, (uint64_t)dod, 64);
+}
+
+static void varintGorillaPutValue_(varintGorillaWriter *w, uint64_t value) {
+    const uint64_t diff = value ^ w->value;
+    w->value = value;
+
+    if (!diff) {
+        varintGorillaPut_(w, 0, 1);
+        return;
+    }
+
+    uint32_t leading = __builtin_clzll(diff);
+    const uint32_t trailing = __builtin_ctzll(diff);
+    const uint32_t windowTrailing = 64 - w->leading - w->meaningful;
+    if (w->meaningful && leading >= w->leading &&
+        trailing >= windowTrailing) {
+        varintGorillaPut_(w, 2, 2);
+        varintGorillaPut_(w, diff >> windowTrailing, w->meaningful);
+        return;
+    }
+
+    /* New window; leading zeros past 31 are stored as meaningful bits */
+    leading = leading > 31 ? 31 : leading;
+    const uint32_t meaningful = 64 - leading - trailing;
+    varintGorillaPut_(w, 3ULL << 11 | leading << 6 | (meaningful - 1), 13);
+    varintGorillaPut_(w, diff >> trailing, meaningful);
+    w->leading = (uint8_t)leading;
+    w->meaningful = (uint8_t)meaningful;
+}
+
+bool varintGorillaAppend(varintGorillaWriter *w, int64_t timestamp,
+                         double value) {
+    const size_t needed =
+        w->count ? VARINT_GORILLA_POINT_BITS_MAX : 2 * 64;
+    if (w->bitOffset < COUNT_BITS || w->count == UINT32_MAX ||
+        w->capacityBits - w->bitOffset < needed) {
+        return false;
+    }
+
+    const uint64_t bits = varintGorillaDoubleBits_(value);
+    if (w->count) {
+        varintGorillaPutTimestamp_(w, (uint64_t)timestamp);
+        varintGorillaPutValue_(w, bits);
+    } else {
+        varintGorillaPut_(w, (uint64_t)timestamp, 64);
+        varintGorillaPut_(w, bits, 64);
+        w->timestamp = (uint64_t)timestamp;
+        w->value = bits;
+    }
+
+    w->count++;
+    varintBitstreamSet(w->dst, 0, COUNT_BITS, w->count);
+    return true;
+}
+
+size_t varintGorillaWriterBytes(const varintGorillaWriter *w) {
+    return (w->bitOffset + 63) / 64 * 8;
+}
+
+/* ====================================================================
+ * Reading
+ * ==================================================================== */
+/* Next 64 bits, left aligned and zero past the end, without consuming
+ * them.  Each point decodes from one or two of these windows instead of
+ * extracting every field separately. */
+static uint64_t varintGorillaPeek_(const varintGorillaReader *r) {
+    const size_t slot = r->bitOffset / 64;
+    const uint32_t shift = r->bitOffset % 64;
+    const size_t slots = r->capacityBits / 64;
+    if (slot >= slots) {
+        return 0;
+    }
+
+    uint64_t window = r->src[slot] << shift;
+    if (shift && slot + 1 < slots) {
+        window |= r->src[slot + 1] >> (64 - shift);
+    }
+
+    return window;
+}
+
+/* Consume 'bits' bits, failing if they run past the end */
+static bool varintGorillaSkip_(varintGorillaReader *r, uint32_t bits) {
+    if (r->capacityBits - r->bitOffset < bits) {
+        return false;
+    }
+
+    r->bitOffset += bits;
+    return true;
+}
+
+/* Top 'bits' bits of 'window' after its first 'skip' bits */
+#define varintGorillaField_(window, skip, bits)                                \
+    ((bits) == 64 ? (window) : ((window) << (skip)) >> (64 - (bits)))
+
+bool varintGorillaReaderInit(varintGorillaReader *r, const uint64_t *src,
+                             size_t srcBytes) {
+    memset(r, 0, sizeof(*r));
+    r->src = src;
+    r->capacityBits = srcBytes / 8 * 64;
+    if (r->capacityBits < COUNT_BITS) {
+        return false;
+    }
+
+    r->remaining = (uint32_t)varintBitstreamGet(src, 0, COUNT_BITS);
+    r->bitOffset = COUNT_BITS;
+    return true;
+}
+
+static bool varintGorillaGetTimestamp_(varintGorillaReader *r) {
+    /* Leading one bits of the control select the bucket */
+    uint64_t window = varintGorillaPeek_(r);
+    const uint32_t ones = __builtin_clzll(~window | (UINT64_MAX >> 4));
+    const uint32_t controlBits = ones < 4 ? ones + 1 : 4;
+    const uint32_t bits = varintGorillaBucketBits_[ones];
+    uint64_t dod = 0;
+    if (ones == 4) {
+        if (!varintGorillaSkip_(r, controlBits)) {
+            return false;
+        }
+
+        dod = varintGorillaPeek_(r);
+    } else if (ones) {
+        dod = varintGorillaField_(window, controlBits, bits) -
+              (uint64_t)varintGorillaBucketBias_[ones];
+    }
+
+    if (!varintGorillaSkip_(r, ones == 4 ? bits : controlBits + bits)) {
+        return false;
+    }
+
+    r->delta += dod;
+    r->timestamp += r->delta;
+    return true;
+}
+
+static bool varintGorillaGetValue_(varintGorillaReader *r) {
+    uint64_t window = varintGorillaPeek_(r);
+    if (!(window >> 63)) {
+        return varintGorillaSkip_(r, 1);
+    }
+
+    uint32_t header = 2;
+    if (window >> 62 == 3) {
+        const uint32_t leading = varintGorillaField_(window, 2, 5);
+        const uint32_t meaningful = varintGorillaField_(window, 7, 6) + 1;
+        if (leading + meaningful > 64) {
+            return false;
+        }
+
+        r->leading = (uint8_t)leading;
+        r->meaningful = (uint8_t)meaningful;
+        header = 13;
+    } else if (!r->meaningful) {
+        return false;
+    }
+
+    /* Meaningful bits usually share the window with their header */
+    if (header + r->meaningful > 64) {
+        if (!varintGorillaSkip_(r, header)) {
+            return false;
+        }
+
+        window = varintGorillaPeek_(r);
+        header = 0;
+    }
+
+    const uint64_t diff = varintGorillaField_(window, header, r->meaningful);
+    if (!varintGorillaSkip_(r, header + r->meaningful)) {
+        return false;
+    }
+
+    r->value ^= diff << (64 - r->leading - r->meaningful);
+    return true;
+}
+
+bool varintGorillaNext(varintGorillaReader *r, int64_t *timestamp,
+                       double *value) {
+    if (!r->remaining) {
+        return false;
+    }
+
+    if (r->index) {
+        if (!varintGorillaGetTimestamp_(r) || !varintGorillaGetValue_(r)) {
+            return false;
+        }
+    } else {
+        r->timestamp = varintGorillaPeek_(r);
+        if (!varintGorillaSkip_(r, 64)) {
+            return false;
+        }
+
+        r->value = varintGorillaPeek_(r);
+        if (!varintGorillaSkip_(r, 64)) {
+            return false;
+        }
+    }
+
+    r->index++;
+    r->remaining--;
+    *timestamp = (int64_t)r->timestamp;
+    *value = varintGorillaBitsDouble_(r->value);
+    return true;
+}
+
+size_t varintGorillaDecode(const uint64_t *src, size_t srcBytes,
+                           int64_t *timestamps, double *values,
+                           size_t maxPoints) {
+    varintGorillaReader r;
+    if (!varintGorillaReaderInit(&r, src, srcBytes)) {
+        return 0;
+    }
+
+    size_t count = 0;
+    while (count < maxPoints &&
+           varintGorillaNext(&r, &timestamps[count], &values[count])) {
+        count++;
+    }
+
+    return count;
+}
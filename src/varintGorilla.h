@@ -0,0 +1,92 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Gorilla time series blocks
+ * ==================================================================== */
+/* Blocks of (timestamp, double) points coded as in Facebook's Gorilla:
+ *   - the first point is stored raw (64 bit timestamp, 64 bit value)
+ *   - timestamps store their delta of delta in a variable size bucket:
+ *       '0'                      delta of delta is 0
+ *       '10'   + 7 bits          -63 to 64
+ *       '110'  + 9 bits          -255 to 256
+ *       '1110' + 12 bits         -2047 to 2048
+ *       '1111' + 64 bits         anything else
+ *   - values store their XOR with the previous value:
+ *       '0'                      same value
+ *       '10' + meaningful bits   XOR fits the previous window of
+ *                                meaningful (not leading or trailing
+ *                                zero) bits
+ *       '11' + 5 bits leading zeros + 6 bits meaningful length - 1
+ *            + meaningful bits
+ *
+ * Regular timestamps cost 1 bit and unchanged values 1 bit, so typical
+ * metrics take 1-2 bytes per point instead of ~12 as Tagged timestamp
+ * plus raw double.
+ *
+ * A block is a varintBitstream (native 64 bit words) whose first 32 bits
+ * count its points.  Blocks are append only: varintGorillaAppend() adds
+ * points until the block is full and the count is always current, so a
+ * block can be read at any time. */
+
+/* Most bits one point can take (beyond the first point's 128) */
+#define VARINT_GORILLA_POINT_BITS_MAX (4 + 64 + 2 + 5 + 6 + 64)
+
+typedef struct varintGorillaWriter {
+    uint64_t *dst;
+    size_t capacityBits;
+    size_t bitOffset;
+    uint32_t count;
+    uint64_t timestamp;
+    uint64_t delta;
+    uint64_t value;
+    uint8_t leading; /* current window of meaningful value bits */
+    uint8_t meaningful; /* 0 until a window exists */
+} varintGorillaWriter;
+
+/* Start an empty block in 'dst', which has room for 'dstBytes' bytes
+ * (a multiple of 8). */
+void varintGorillaWriterInit(varintGorillaWriter *w, uint64_t *dst,
+                             size_t dstBytes);
+
+/* Returns false (and writes nothing) if the block may not have room for
+ * another point. */
+bool varintGorillaAppend(varintGorillaWriter *w, int64_t timestamp,
+                         double value);
+
+/* Bytes of 'dst' used so far (a multiple of 8) */
+size_t varintGorillaWriterBytes(const varintGorillaWriter *w);
+
+typedef struct varintGorillaReader {
+    const uint64_t *src;
+    size_t capacityBits;
+    size_t bitOffset;
+    uint32_t remaining;
+    uint32_t index;
+    uint64_t timestamp;
+    uint64_t delta;
+    uint64_t value;
+    uint8_t leading;
+    uint8_t meaningful;
+} varintGorillaReader;
+
+/* Read the block in 'src' ('srcBytes' long, a multiple of 8).  Returns
+ * false if it's too short to hold its count. */
+bool varintGorillaReaderInit(varintGorillaReader *r, const uint64_t *src,
+                             size_t srcBytes);
+
+/* Decode the next point.  Returns false after the last point or if the
+ * block is malformed (then the reader's 'remaining' is nonzero). */
+bool varintGorillaNext(varintGorillaReader *r, int64_t *timestamp,
+                       double *value);
+
+/* Decode all points of a block into arrays with room for 'maxPoints'.
+ * Returns points decoded, which is less than the block's count if the
+ * block is malformed or 'maxPoints' is too small. */
+size_t varintGorillaDecode(const uint64_t *src, size_t srcBytes,
+                           int64_t *timestamps, double *values,
+                           size_t maxPoints);
+
+__END_DECLS
@@ -0,0 +1,167 @@
+#include "varintGorilla.h"
+
+#include "ctest.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define COUNT 20000
+
+static bool sameBits(double a, double b) {
+    return !memcmp(&a, &b, sizeof(a));
+}
+
+/* Encode, decode, and compare bit for bit; returns block bytes */
+static size_t roundTrip(int32_t *errp, const int64_t *timestamps,
+                        const double *values, size_t count) {
+    int32_t err = *errp;
+    const size_t capacity =
+        (128 + count * VARINT_GORILLA_POINT_BITS_MAX) / 64 * 8 + 16;
+    uint64_t *block = malloc(capacity);
+    int64_t *outTimestamps = malloc(count * sizeof(*outTimestamps) + 1);
+    double *outValues = malloc(count * sizeof(*outValues) + 1);
+
+    varintGorillaWriter w;
+    varintGorillaWriterInit(&w, block, capacity);
+    for (size_t i = 0; i < count; i++) {
+        if (!varintGorillaAppend(&w, timestamps[i], values[i])) {
+            ERR("Append %zu failed!", i);
+            break;
+        }
+    }
+
+    const size_t bytes = varintGorillaWriterBytes(&w);
+    if (varintGorillaDecode(block, bytes, outTimestamps, outValues, count) !=
+        count) {
+        ERR("Decoded fewer than %zu points!", count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (outTimestamps[i] != timestamps[i] ||
+            !sameBits(outValues[i], values[i])) {
+            ERR("Point %zu failed!", i);
+            break;
+        }
+    }
+
+    free(block);
+    free(outTimestamps);
+    free(outValues);
+    *errp = err;
+    return bytes;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(71);
+
+    int64_t *timestamps = malloc(COUNT * sizeof(*timestamps));
+    double *values = malloc(COUNT * sizeof(*values));
+
+    TEST("metrics compress to under 2 bytes per point") {
+        /* 10 second scrapes with occasional jitter of a gauge that mostly
+         * holds steady */
+        int64_t t = 1700000000000;
+        double gauge = 42.5;
+        for (size_t i = 0; i < COUNT; i++) {
+            t += 10000 + (ctestRandom() % 20 == 0 ? ctestRandom() % 200 : 0);
+            timestamps[i] = t;
+            if (ctestRandom() % 10 == 0) {
+                gauge += (double)(ctestRandom() % 8) - 3.5;
+            }
+
+            values[i] = gauge;
+        }
+
+        const size_t bytes = roundTrip(&err, timestamps, values, COUNT);
+        if (bytes * 10 > COUNT * 20) {
+            ERR("%zu bytes is %.2f bytes per point!", bytes,
+                (double)bytes / COUNT);
+        }
+    }
+
+    TEST("every timestamp bucket and value window round trips") {
+        int64_t t = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            /* Deltas of delta across every bucket boundary */
+            const int64_t jumps[] = {0,     1,     -63,   64,    -64,
+                                     65,    -255,  256,   -256,  257,
+                                     -2047, 2048,  -2048, 2049,  1 << 30,
+                                     -(1LL << 40)};
+            t += jumps[ctestRandom() % (sizeof(jumps) / sizeof(*jumps))];
+            timestamps[i] = t;
+
+            uint64_t bits = ctestRandom();
+            bits >>= ctestRandom() % 64;
+            bits <<= ctestRandom() % 64;
+            memcpy(&values[i], &bits, sizeof(bits));
+        }
+
+        roundTrip(&err, timestamps, values, COUNT);
+
+        const int64_t extremeTimestamps[] = {INT64_MIN, INT64_MAX, 0, -1,
+                                             INT64_MAX, INT64_MIN};
+        const double extremeValues[] = {-0.0, NAN, INFINITY, -INFINITY,
+                                        0.0, 1e-310};
+        roundTrip(&err, extremeTimestamps, extremeValues, 6);
+    }
+
+    TEST("blocks are append only and readable at any time") {
+        uint64_t block[32];
+        varintGorillaWriter w;
+        varintGorillaWriterInit(&w, block, sizeof(block));
+
+        size_t appended = 0;
+        while (varintGorillaAppend(&w, timestamps[appended],
+                                   values[appended])) {
+            appended++;
+
+            /* Count is current after every append */
+            varintGorillaReader r;
+            varintGorillaReaderInit(&r, block, sizeof(block));
+            if (r.remaining != appended) {
+                ERR("Count %u after %zu appends!", r.remaining, appended);
+                break;
+            }
+        }
+
+        if (!appended || varintGorillaWriterBytes(&w) > sizeof(block)) {
+            ERR("Full block holds %zu points in %zu bytes!", appended,
+                varintGorillaWriterBytes(&w));
+        }
+
+        int64_t ts;
+        double value;
+        varintGorillaReader r;
+        varintGorillaReaderInit(&r, block, sizeof(block));
+        for (size_t i = 0; i < appended; i++) {
+            if (!varintGorillaNext(&r, &ts, &value) || ts != timestamps[i] ||
+                !sameBits(value, values[i])) {
+                ERR("Full block point %zu failed!", i);
+                break;
+            }
+        }
+
+        if (varintGorillaNext(&r, &ts, &value)) {
+            ERRR("Read past the last point!");
+        }
+
+        /* A count past the data fails instead of reading beyond */
+        block[0] |= 0xffffULL << 32;
+        varintGorillaReaderInit(&r, block, 16);
+        while (varintGorillaNext(&r, &ts, &value)) {
+        }
+
+        if (!r.remaining || r.bitOffset > 128) {
+            ERRR("Truncated block read too far!");
+        }
+    }
+
+    free(timestamps);
+    free(values);
+
+    TEST_FINAL_RESULT;
+}
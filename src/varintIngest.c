@@ -0,0 +1,842 @@
+#define _GNU_SOURCE
+#include "varintIngest.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintExternal.h"
+#include "varintSplit.h"
+#include "varintSplitFull.h"
+#include "varintSplitFull16.h"
+#include "varintSplitFullNoZero.h"
+#include "varintTagged.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* The ring needs IORING_OP_READ (5.6 headers, which also added
+ * IORING_FEAT_RW_CUR_POS; the opcodes are enums so can't be tested
+ * directly) and IORING_FEAT_SINGLE_MMAP.  Older headers read with pread(). */
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_SINGLE_MMAP) &&      \
+    defined(IORING_FEAT_RW_CUR_POS)
+#define VARINT_INGEST_URING 1
+#endif
+#endif
+#endif
+
+#define VARINT_INGEST_BLOCK_DEFAULT (1 << 20)
+#define VARINT_INGEST_DEPTH_DEFAULT 8
+
+/* Buffers hold carried bytes of a split varint just before their data,
+ * and data stays cache line aligned. */
+#define VARINT_INGEST_HEADROOM 64
+
+typedef enum varintIngestState_ {
+    VARINT_INGEST_FREE = 0,
+    VARINT_INGEST_READING,  /* read in flight */
+    VARINT_INGEST_READY,    /* read complete, waiting for its turn */
+    VARINT_INGEST_DECODING, /* cut on varint boundaries, queued or decoding */
+} varintIngestState_;
+
+/* 'state' is handed between the reading thread and workers with atomic
+ * acquire/release, which also publishes the rest of the buffer. */
+typedef struct varintIngestBuf_ {
+    uint8_t *mem; /* HEADROOM + blockBytes */
+    varintIngestState_ state;
+    uint64_t seq;    /* block number in file order */
+    uint64_t offset; /* file offset of the read */
+    size_t want;     /* bytes requested */
+    size_t filled;   /* bytes read so far */
+
+    /* Set once the block is cut on varint boundaries */
+    const uint8_t *start;
+    size_t len;
+    size_t count;
+    uint64_t firstIndex;
+    uint64_t fileOffset;
+} varintIngestBuf_;
+
+#if VARINT_INGEST_URING
+typedef struct varintIngestRing_ {
+    int fd;
+    bool fixed; /* buffers registered */
+    unsigned *sqTail;
+    unsigned sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqMap;
+    size_t sqMapLen;
+    void *cqMap;
+    size_t cqMapLen;
+    size_t sqesLen;
+    unsigned pending; /* prepared but not yet submitted */
+} varintIngestRing_;
+#endif
+
+typedef struct varintIngest_ {
+    const varintIngestConfig *config;
+    int fd;
+    uint64_t fileSize;
+    size_t blockBytes;
+
+    varintIngestBuf_ *bufs;
+    size_t nbuf;
+
+    uint64_t nextReadOffset;
+    uint64_t nextReadSeq;
+    uint64_t nextCutSeq;
+    uint64_t blocks;
+    uint64_t values;
+    unsigned inflight;
+
+    uint8_t carry[VARINT_INGEST_HEADROOM];
+    size_t carryLen;
+
+    /* Workers */
+    pthread_t *threads;
+    uint32_t workers;
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t bufFreed;
+    size_t *queue; /* buffer indexes, ring of nbuf entries */
+    size_t queueHead;
+    size_t queueLen;
+    bool shutdown;
+    int err;
+
+#if VARINT_INGEST_URING
+    varintIngestRing_ ring;
+    bool useRing;
+#endif
+} varintIngest_;
+
+/* ====================================================================
+ * Decoding
+ * ==================================================================== */
+/* Split family decoders are macros setting a length and a value */
+#define VARINT_INGEST_DECODE_SPLIT_(get)                                       \
+    do {                                                                       \
+        while (src < end) {                                                    \
+            varintWidth width;                                                 \
+            get(src, width, out[n]);                                           \
+            src += width;                                                      \
+            n++;                                                               \
+        }                                                                      \
+    } while (0)
+
+/* Decode the 'len' bytes of whole varints at 'src', the first of which is
+ * value 'firstIndex' of the stream. */
+static size_t varintIngestDecode_(const varintIngestConfig *config,
+                                  const uint8_t *src, size_t len,
+                                  uint64_t firstIndex, uint64_t *out) {
+    const uint8_t *const end = src + len;
+    size_t n = 0;
+    switch (config->format) {
+    case VARINT_INGEST_TAGGED:
+        while (src < end) {
+            src += varintTaggedGet64(src, &out[n++]);
+        }
+        break;
+    case VARINT_INGEST_CHAINED:
+        while (src < end) {
+            src += varintChainedGetVarint(src, &out[n++]);
+        }
+        break;
+    case VARINT_INGEST_CHAINED_SIMPLE:
+        while (src < end) {
+            src += varintChainedSimpleDecode64(src, &out[n++]);
+        }
+        break;
+    case VARINT_INGEST_SPLIT:
+        VARINT_INGEST_DECODE_SPLIT_(varintSplitGet_);
+        break;
+    case VARINT_INGEST_SPLIT_FULL:
+        VARINT_INGEST_DECODE_SPLIT_(varintSplitFullGet_);
+        break;
+    case VARINT_INGEST_SPLIT_FULL_NO_ZERO:
+        VARINT_INGEST_DECODE_SPLIT_(varintSplitFullNoZeroGet_);
+        break;
+    case VARINT_INGEST_SPLIT_FULL_16:
+        VARINT_INGEST_DECODE_SPLIT_(varintSplitFull16Get_);
+        break;
+    case VARINT_INGEST_EXTERNAL: {
+        const uint8_t *widths = config->widths + firstIndex;
+        while (src < end) {
+            const varintWidth width = widths[n];
+            varintExternalGetQuick_(src, width, out[n]);
+            src += width;
+            n++;
+        }
+        break;
+    }
+    }
+
+    return n;
+}
+
+/* Decode a cut block into 'out' + firstIndex or 'scratch' and hand it to
+ * the callback.  Returns 0 or an errno. */
+static int varintIngestRunBlock_(varintIngest_ *in, const varintIngestBuf_ *b,
+                                 uint64_t *scratch) {
+    const varintIngestConfig *config = in->config;
+    if (!config->out && !config->fn) {
+        /* Nothing consumes values: cutting already validated and
+         * counted the block. */
+        return 0;
+    }
+
+    uint64_t *values = config->out ? config->out + b->firstIndex : scratch;
+    varintIngestDecode_(config, b->start, b->len, b->firstIndex, values);
+
+    if (config->fn) {
+        const varintIngestBlock block = {.values = values,
+                                         .count = b->count,
+                                         .firstIndex = b->firstIndex,
+                                         .fileOffset = b->fileOffset};
+        if (!config->fn(config->ctx, &block)) {
+            return ECANCELED;
+        }
+    }
+
+    return 0;
+}
+
+/* ====================================================================
+ * Workers
+ * ==================================================================== */
+static void *varintIngestWorker_(void *arg) {
+    varintIngest_ *in = arg;
+    uint64_t *scratch = NULL;
+    if (in->config->fn && !in->config->out) {
+        scratch = malloc((in->blockBytes + VARINT_INGEST_HEADROOM) *
+                         sizeof(*scratch));
+    }
+
+    pthread_mutex_lock(&in->lock);
+    if (in->config->fn && !in->config->out && !scratch && !in->err) {
+        in->err = ENOMEM;
+    }
+
+    for (;;) {
+        while (!in->queueLen && !in->shutdown) {
+            pthread_cond_wait(&in->workReady, &in->lock);
+        }
+
+        if (!in->queueLen) {
+            break;
+        }
+
+        const size_t i = in->queue[in->queueHead];
+        in->queueHead = (in->queueHead + 1) % in->nbuf;
+        in->queueLen--;
+        const bool skip = in->err != 0;
+        pthread_mutex_unlock(&in->lock);
+
+        const int err = skip ? 0 : varintIngestRunBlock_(in, &in->bufs[i],
+                                                         scratch);
+
+        pthread_mutex_lock(&in->lock);
+        if (err && !in->err) {
+            in->err = err;
+        }
+
+        __atomic_store_n(&in->bufs[i].state, VARINT_INGEST_FREE,
+                         __ATOMIC_RELEASE);
+        pthread_cond_signal(&in->bufFreed);
+    }
+
+    pthread_mutex_unlock(&in->lock);
+    free(scratch);
+    return NULL;
+}
+
+/* ====================================================================
+ * io_uring
+ * ==================================================================== */
+#if VARINT_INGEST_URING
+static void varintIngestRingClose_(varintIngestRing_ *r) {
+    if (r->sqes) {
+        munmap(r->sqes, r->sqesLen);
+    }
+
+    if (r->cqMap && r->cqMap != r->sqMap) {
+        munmap(r->cqMap, r->cqMapLen);
+    }
+
+    if (r->sqMap) {
+        munmap(r->sqMap, r->sqMapLen);
+    }
+
+    close(r->fd);
+}
+
+static bool varintIngestRingOpen_(varintIngest_ *in) {
+    varintIngestRing_ *r = &in->ring;
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(r, 0, sizeof(*r));
+
+    r->fd = (int)syscall(__NR_io_uring_setup, (unsigned)in->nbuf, &p);
+    if (r->fd < 0) {
+        return false;
+    }
+
+    r->sqMapLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cqMapLen = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cqMapLen > r->sqMapLen) {
+            r->sqMapLen = r->cqMapLen;
+        }
+
+        r->cqMapLen = r->sqMapLen;
+    }
+
+    r->sqMap = mmap(NULL, r->sqMapLen, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sqMap == MAP_FAILED) {
+        r->sqMap = NULL;
+        goto fail;
+    }
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cqMap = r->sqMap;
+    } else {
+        r->cqMap = mmap(NULL, r->cqMapLen, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if (r->cqMap == MAP_FAILED) {
+            r->cqMap = NULL;
+            goto fail;
+        }
+    }
+
+    r->sqesLen = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqesLen, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        r->sqes = NULL;
+        goto fail;
+    }
+
+    uint8_t *sq = r->sqMap;
+    uint8_t *cq = r->cqMap;
+    r->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    r->sqMask = *(unsigned *)(sq + p.sq_off.ring_mask);
+    r->sqArray = (unsigned *)(sq + p.sq_off.array);
+    r->cqHead = (unsigned *)(cq + p.cq_off.head);
+    r->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    r->cqMask = *(unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    /* Registering pins the buffers once instead of on every read.  It can
+     * fail under a low RLIMIT_MEMLOCK; plain reads still work then. */
+    struct iovec *iov = malloc(in->nbuf * sizeof(*iov));
+    if (iov) {
+        for (size_t i = 0; i < in->nbuf; i++) {
+            iov[i].iov_base = in->bufs[i].mem + VARINT_INGEST_HEADROOM;
+            iov[i].iov_len = in->blockBytes;
+        }
+
+        r->fixed = syscall(__NR_io_uring_register, r->fd,
+                           IORING_REGISTER_BUFFERS, iov,
+                           (unsigned)in->nbuf) == 0;
+        free(iov);
+    }
+
+    return true;
+
+fail:
+    varintIngestRingClose_(r);
+    return false;
+}
+
+static void varintIngestRingPrep_(varintIngest_ *in, size_t i) {
+    varintIngestRing_ *r = &in->ring;
+    const varintIngestBuf_ *b = &in->bufs[i];
+
+    /* We are the only producer, so the tail only needs ordering against
+     * the kernel reading it (done on submit). */
+    const unsigned tail = *r->sqTail + r->pending;
+    const unsigned idx = tail & r->sqMask;
+    struct io_uring_sqe *sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = r->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = in->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(b->mem + VARINT_INGEST_HEADROOM +
+                                      b->filled);
+    sqe->len = (uint32_t)(b->want - b->filled);
+    sqe->off = b->offset + b->filled;
+    if (r->fixed) {
+        sqe->buf_index = (uint16_t)i;
+    }
+
+    sqe->user_data = i;
+    r->sqArray[idx] = idx;
+    r->pending++;
+    in->inflight++;
+}
+
+/* Submit prepared reads and, if 'wait', block for at least one
+ * completion.  Returns 0 or an errno. */
+static int varintIngestRingEnter_(varintIngest_ *in, bool wait) {
+    varintIngestRing_ *r = &in->ring;
+    const unsigned submit = r->pending;
+    if (submit) {
+        __atomic_store_n(r->sqTail, *r->sqTail + submit, __ATOMIC_RELEASE);
+        r->pending = 0;
+    }
+
+    if (!submit && !wait) {
+        return 0;
+    }
+
+    for (;;) {
+        const long ret = syscall(__NR_io_uring_enter, r->fd, submit,
+                                 wait ? 1 : 0,
+                                 wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (ret >= 0) {
+            return 0;
+        }
+
+        if (errno != EINTR) {
+            return errno;
+        }
+    }
+}
+
+/* Collect completed reads, resubmitting the rest of short reads.
+ * Returns 0 or an errno. */
+static int varintIngestRingReap_(varintIngest_ *in) {
+    varintIngestRing_ *r = &in->ring;
+    unsigned head = *r->cqHead;
+    const unsigned tail = __atomic_load_n(r->cqTail, __ATOMIC_ACQUIRE);
+    int err = 0;
+    for (; head != tail; head++) {
+        const struct io_uring_cqe *cqe = &r->cqes[head & r->cqMask];
+        varintIngestBuf_ *b = &in->bufs[cqe->user_data];
+        in->inflight--;
+        if (cqe->res <= 0) {
+            /* A zero length read before 'want' means the file shrank */
+            if (!err) {
+                err = cqe->res ? -cqe->res : EIO;
+            }
+
+            b->state = VARINT_INGEST_FREE;
+            continue;
+        }
+
+        b->filled += (size_t)cqe->res;
+        if (b->filled < b->want) {
+            varintIngestRingPrep_(in, cqe->user_data);
+        } else {
+            b->state = VARINT_INGEST_READY;
+        }
+    }
+
+    __atomic_store_n(r->cqHead, head, __ATOMIC_RELEASE);
+    return err;
+}
+#endif
+
+/* ====================================================================
+ * Reading
+ * ==================================================================== */
+static int varintIngestPread_(varintIngest_ *in, varintIngestBuf_ *b) {
+    while (b->filled < b->want) {
+        const ssize_t got =
+            pread(in->fd, b->mem + VARINT_INGEST_HEADROOM + b->filled,
+                  b->want - b->filled, (off_t)(b->offset + b->filled));
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return errno;
+        }
+
+        if (!got) {
+            return EIO;
+        }
+
+        b->filled += (size_t)got;
+    }
+
+    b->state = VARINT_INGEST_READY;
+    return 0;
+}
+
+/* Start reads into every free buffer.  Returns 0 or an errno. */
+static int varintIngestSubmit_(varintIngest_ *in) {
+    for (size_t i = 0; i < in->nbuf && in->nextReadOffset < in->fileSize;
+         i++) {
+        varintIngestBuf_ *b = &in->bufs[i];
+        if (__atomic_load_n(&b->state, __ATOMIC_ACQUIRE) !=
+            VARINT_INGEST_FREE) {
+            continue;
+        }
+
+        const uint64_t left = in->fileSize - in->nextReadOffset;
+        b->state = VARINT_INGEST_READING;
+        b->seq = in->nextReadSeq++;
+        b->offset = in->nextReadOffset;
+        b->want = left < in->blockBytes ? (size_t)left : in->blockBytes;
+        b->filled = 0;
+        in->nextReadOffset += b->want;
+
+#if VARINT_INGEST_URING
+        if (in->useRing) {
+            varintIngestRingPrep_(in, i);
+            continue;
+        }
+#endif
+
+        const int err = varintIngestPread_(in, b);
+        if (err) {
+            return err;
+        }
+    }
+
+#if VARINT_INGEST_URING
+    if (in->useRing) {
+        return varintIngestRingEnter_(in, false);
+    }
+#endif
+
+    return 0;
+}
+
+/* External varints cut where the next width no longer fits in 'avail'
+ * bytes (or isn't a valid width).  Returns the bytes of whole varints and
+ * sets 'count' to how many there are. */
+static size_t varintIngestCutExternal_(const varintIngest_ *in, size_t avail,
+                                       size_t *count) {
+    const varintIngestConfig *config = in->config;
+    size_t len = 0;
+    uint64_t i = in->values;
+    for (; i < config->widthCount; i++) {
+        const varintWidth width = config->widths[i];
+        if (width < VARINT_WIDTH_8B || width > VARINT_WIDTH_64B ||
+            len + width > avail) {
+            break;
+        }
+
+        len += width;
+    }
+
+    *count = i - in->values;
+    return len;
+}
+
+/* Cut the next block in file order on varint boundaries, moving the
+ * trailing partial varint to 'carry'.  Returns 0 or an errno. */
+static int varintIngestCut_(varintIngest_ *in, varintIngestBuf_ *b) {
+    uint8_t *data = b->mem + VARINT_INGEST_HEADROOM;
+    uint8_t *start = data - in->carryLen;
+    memcpy(start, in->carry, in->carryLen);
+
+    const size_t avail = in->carryLen + b->filled;
+    size_t count = 0;
+    const varintIngestFormat format = in->config->format;
+    const size_t len =
+        format == VARINT_INGEST_EXTERNAL
+            ? varintIngestCutExternal_(in, avail, &count)
+            : varintScanPrefix((varintScanFormat)format, start, avail,
+                               &count);
+    const size_t tail = avail - len;
+    const bool last = b->offset + b->filled == in->fileSize;
+
+    /* A remainder longer than any varint (or any remainder at the end of
+     * the file) is malformed input. */
+    if ((last && tail) || tail >= 9) {
+        return EILSEQ;
+    }
+
+    if (in->config->out && in->values + count > in->config->outCapacity) {
+        return ENOSPC;
+    }
+
+    b->fileOffset = b->offset - in->carryLen;
+    memcpy(in->carry, start + len, tail);
+    in->carryLen = tail;
+
+    b->start = start;
+    b->len = len;
+    b->count = count;
+    b->firstIndex = in->values;
+    in->values += count;
+    in->blocks++;
+    in->nextCutSeq++;
+    return 0;
+}
+
+/* Find the buffer holding block 'seq' if its read has completed */
+static varintIngestBuf_ *varintIngestNextReady_(varintIngest_ *in) {
+    for (size_t i = 0; i < in->nbuf; i++) {
+        varintIngestBuf_ *b = &in->bufs[i];
+        if (__atomic_load_n(&b->state, __ATOMIC_ACQUIRE) ==
+                VARINT_INGEST_READY &&
+            b->seq == in->nextCutSeq) {
+            return b;
+        }
+    }
+
+    return NULL;
+}
+
+/* Hand a cut block to a worker, or decode it here without workers.
+ * Returns 0 or an errno. */
+static int varintIngestDispatch_(varintIngest_ *in, varintIngestBuf_ *b,
+                                 uint64_t *scratch) {
+    if (!in->workers) {
+        const int err = varintIngestRunBlock_(in, b, scratch);
+        b->state = VARINT_INGEST_FREE;
+        return err;
+    }
+
+    pthread_mutex_lock(&in->lock);
+    __atomic_store_n(&b->state, VARINT_INGEST_DECODING, __ATOMIC_RELEASE);
+    in->queue[(in->queueHead + in->queueLen) % in->nbuf] = b - in->bufs;
+    in->queueLen++;
+    pthread_cond_signal(&in->workReady);
+    pthread_mutex_unlock(&in->lock);
+    return 0;
+}
+
+/* Record 'err' as the ingest error unless one is already set */
+static void varintIngestFail_(varintIngest_ *in, int err) {
+    if (!err) {
+        return;
+    }
+
+    if (in->workers) {
+        pthread_mutex_lock(&in->lock);
+    }
+
+    if (!in->err) {
+        in->err = err;
+    }
+
+    if (in->workers) {
+        pthread_mutex_unlock(&in->lock);
+    }
+}
+
+static void varintIngestRun_(varintIngest_ *in, uint64_t *scratch) {
+    const uint64_t totalBlocks =
+        (in->fileSize + in->blockBytes - 1) / in->blockBytes;
+
+    while (in->nextCutSeq < totalBlocks) {
+        if (in->workers) {
+            pthread_mutex_lock(&in->lock);
+        }
+
+        const bool stop = in->err != 0;
+        if (in->workers) {
+            pthread_mutex_unlock(&in->lock);
+        }
+
+        if (stop) {
+            break;
+        }
+
+        varintIngestFail_(in, varintIngestSubmit_(in));
+
+        varintIngestBuf_ *b = varintIngestNextReady_(in);
+        if (b) {
+            int err = varintIngestCut_(in, b);
+            if (!err) {
+                err = varintIngestDispatch_(in, b, scratch);
+            }
+
+            varintIngestFail_(in, err);
+            continue;
+        }
+
+#if VARINT_INGEST_URING
+        if (in->useRing && in->inflight) {
+            int err = varintIngestRingEnter_(in, true);
+            if (!err) {
+                err = varintIngestRingReap_(in);
+            }
+
+            varintIngestFail_(in, err);
+            continue;
+        }
+#endif
+
+        /* Every buffer is with a worker: wait for one back */
+        pthread_mutex_lock(&in->lock);
+        bool anyFree = false;
+        while (!anyFree && !in->err) {
+            for (size_t i = 0; i < in->nbuf; i++) {
+                anyFree |= __atomic_load_n(&in->bufs[i].state,
+                                           __ATOMIC_ACQUIRE) ==
+                           VARINT_INGEST_FREE;
+            }
+
+            if (!anyFree) {
+                pthread_cond_wait(&in->bufFreed, &in->lock);
+            }
+        }
+
+        pthread_mutex_unlock(&in->lock);
+    }
+
+#if VARINT_INGEST_URING
+    /* The kernel owns buffers with reads in flight; wait them out even
+     * after an error before the buffers are freed. */
+    while (in->useRing && in->inflight) {
+        if (varintIngestRingEnter_(in, true) ||
+            varintIngestRingReap_(in)) {
+            /* Keep draining; the first error is already recorded */
+        }
+    }
+#endif
+}
+
+/* ====================================================================
+ * Ingest
+ * ==================================================================== */
+bool varintIngestFile(int fd, const varintIngestConfig *config,
+                      varintIngestStats *stats) {
+    varintIngest_ in = {.config = config, .fd = fd};
+    uint64_t *scratch = NULL;
+    uint32_t started = 0;
+    int err = 0;
+
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st)) {
+        return false;
+    }
+
+    if (!S_ISREG(st.st_mode) ||
+        (config->format == VARINT_INGEST_EXTERNAL && !config->widths)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    in.fileSize = (uint64_t)st.st_size;
+
+    /* Blocks must be much larger than one varint so every block (plus
+     * carried bytes) holds at least one whole varint. */
+    in.blockBytes =
+        config->blockBytes ? config->blockBytes : VARINT_INGEST_BLOCK_DEFAULT;
+    in.blockBytes = (in.blockBytes + 4095) & ~(size_t)4095;
+    in.workers = config->workers;
+    in.nbuf = (config->depth ? config->depth : VARINT_INGEST_DEPTH_DEFAULT) +
+              in.workers;
+
+    in.bufs = calloc(in.nbuf, sizeof(*in.bufs));
+    in.queue = calloc(in.nbuf, sizeof(*in.queue));
+    in.threads = calloc(in.workers ? in.workers : 1, sizeof(*in.threads));
+    if (!in.bufs || !in.queue || !in.threads) {
+        err = ENOMEM;
+        goto done;
+    }
+
+    for (size_t i = 0; i < in.nbuf; i++) {
+        if (posix_memalign((void **)&in.bufs[i].mem, 4096,
+                           VARINT_INGEST_HEADROOM + in.blockBytes)) {
+            err = ENOMEM;
+            goto done;
+        }
+    }
+
+#if VARINT_INGEST_URING
+    in.useRing = !config->noUring && varintIngestRingOpen_(&in);
+#endif
+
+    pthread_mutex_init(&in.lock, NULL);
+    pthread_cond_init(&in.workReady, NULL);
+    pthread_cond_init(&in.bufFreed, NULL);
+    for (; started < in.workers; started++) {
+        if (pthread_create(&in.threads[started], NULL, varintIngestWorker_,
+                           &in)) {
+            break;
+        }
+    }
+
+    /* Too few threads started: decode with those that did, or here
+     * between reads if none did */
+    in.workers = started;
+    if (config->fn && !config->out && !in.workers) {
+        scratch = malloc((in.blockBytes + VARINT_INGEST_HEADROOM) *
+                         sizeof(*scratch));
+    }
+
+    if (config->fn && !config->out && !in.workers && !scratch) {
+        in.err = ENOMEM;
+    } else {
+        varintIngestRun_(&in, scratch);
+    }
+
+    pthread_mutex_lock(&in.lock);
+    in.shutdown = true;
+    pthread_cond_broadcast(&in.workReady);
+    pthread_mutex_unlock(&in.lock);
+
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(in.threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&in.bufFreed);
+    pthread_cond_destroy(&in.workReady);
+    pthread_mutex_destroy(&in.lock);
+    err = in.err;
+
+    /* Every block held whole varints, but an External file may still end
+     * before the last value 'widths' describes */
+    if (!err && config->format == VARINT_INGEST_EXTERNAL &&
+        in.values != config->widthCount) {
+        err = EILSEQ;
+    }
+
+#if VARINT_INGEST_URING
+    if (in.useRing) {
+        varintIngestRingClose_(&in.ring);
+    }
+#endif
+
+done:
+    if (stats) {
+        stats->bytes = in.nextReadOffset;
+        stats->values = in.values;
+        stats->blocks = in.blocks;
+#if VARINT_INGEST_URING
+        stats->usedUring = in.useRing;
+#endif
+    }
+
+    if (in.bufs) {
+        for (size_t i = 0; i < in.nbuf; i++) {
+            free(in.bufs[i].mem);
+        }
+    }
+
+    free(scratch);
+    free(in.bufs);
+    free(in.queue);
+    free(in.threads);
+
+    if (err) {
+        errno = err;
+        return false;
+    }
+
+    return true;
+}
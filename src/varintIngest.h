@@ -0,0 +1,97 @@
+#pragma once
+
+#include "varint.h"
+#include "varintScan.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * File ingest overlapping reads with decoding
+ * ==================================================================== */
+/* varintIngestFile() decodes a file holding one stream of varints while
+ * later parts of the file are still being read.  Every varintScanFormat
+ * format is accepted (Tagged, Chained, ChainedSimple, and the Split
+ * family), as are External varints whose widths are kept outside the file
+ * ('widths' holds one varintWidth byte per value, as written by
+ * VARINT_PARALLEL_EXTERNAL).
+ *
+ * On Linux (with 5.6 or newer kernel headers) the file is read with
+ * io_uring: 'depth' block sized reads are kept in flight into buffers
+ * registered with the kernel once, so reads skip per-call page pinning.
+ * Elsewhere (or if io_uring is unavailable, e.g. blocked by a seccomp
+ * policy) blocks are read with pread() instead; decoding still overlaps
+ * reading when workers are used.
+ *
+ * Blocks are cut on varint boundaries by the reading thread (a fast
+ * varintScanPrefix() pass which also counts values, or a sum of External
+ * widths, so each block knows the index of its first value).  The few
+ * bytes of a varint crossing a block boundary are carried into the head of
+ * the next block's buffer.
+ * Whole blocks are then decoded by 'workers' threads (or as many as could
+ * be started), or by the reading thread itself between reads when
+ * 'workers' is 0 or no thread could be started.
+ *
+ * Decoded values go to 'out' (each block written at its first value's
+ * index, so any number of workers fill one array), to 'fn' once per
+ * block, or both.  With neither, the file is only validated and counted. */
+
+typedef enum varintIngestFormat {
+    VARINT_INGEST_TAGGED = VARINT_SCAN_TAGGED,
+    VARINT_INGEST_CHAINED = VARINT_SCAN_CHAINED,
+    VARINT_INGEST_CHAINED_SIMPLE = VARINT_SCAN_CHAINED_SIMPLE,
+    VARINT_INGEST_SPLIT = VARINT_SCAN_SPLIT,
+    VARINT_INGEST_SPLIT_FULL = VARINT_SCAN_SPLIT_FULL,
+    VARINT_INGEST_SPLIT_FULL_NO_ZERO = VARINT_SCAN_SPLIT_FULL_NO_ZERO,
+    VARINT_INGEST_SPLIT_FULL_16 = VARINT_SCAN_SPLIT_FULL_16,
+    VARINT_INGEST_EXTERNAL, /* varintExternalPut() + 'widths' */
+} varintIngestFormat;
+
+typedef struct varintIngestBlock {
+    const uint64_t *values; /* decoded values of this block */
+    size_t count;
+    uint64_t firstIndex; /* stream position of values[0] */
+    uint64_t fileOffset; /* file offset of the block's first varint */
+} varintIngestBlock;
+
+/* Called once per block, from worker threads concurrently when
+ * 'workers' > 0.  'block->values' is only valid during the call.
+ * Return false to stop ingest. */
+typedef bool varintIngestBlockFn(void *ctx, const varintIngestBlock *block);
+
+typedef struct varintIngestConfig {
+    varintIngestFormat format;
+    size_t blockBytes; /* bytes per read (default 1 MB) */
+    uint32_t depth;    /* reads in flight (default 8) */
+    uint32_t workers;  /* decode threads (default 0: decode while reading) */
+    bool noUring;      /* always read with pread() */
+
+    uint64_t *out;      /* if not NULL, receives every value */
+    size_t outCapacity; /* values 'out' can hold */
+
+    varintIngestBlockFn *fn; /* if not NULL, called per block */
+    void *ctx;
+
+    const uint8_t *widths; /* EXTERNAL only: width of every value */
+    size_t widthCount;     /* EXTERNAL only: values in the file */
+} varintIngestConfig;
+
+typedef struct varintIngestStats {
+    uint64_t bytes;  /* bytes read */
+    uint64_t values; /* values decoded */
+    uint64_t blocks;
+    bool usedUring;
+} varintIngestStats;
+
+/* Decode all of 'fd' (a regular file, read from offset 0).
+ * Returns true on success.  On failure returns false with errno set:
+ *   EINVAL     'fd' isn't a regular file, or EXTERNAL without 'widths'
+ *   EILSEQ     the file doesn't end on a whole varint (for EXTERNAL: the
+ *              file isn't exactly the sum of 'widths', or a width isn't
+ *              1 to 8 bytes)
+ *   ENOSPC     more values than 'outCapacity'
+ *   ECANCELED  'fn' returned false
+ *   or the errno of a failed read or allocation.
+ * 'stats' (if not NULL) is filled in either way. */
+bool varintIngestFile(int fd, const varintIngestConfig *config,
+                      varintIngestStats *stats);
+
+__END_DECLS
@@ -0,0 +1,256 @@
+#define _GNU_SOURCE
+#include "varintIngest.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintExternal.h"
+#include "varintSplit.h"
+#include "varintSplitFull.h"
+#include "varintSplitFull16.h"
+#include "varintSplitFullNoZero.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define COUNT 500000
+
+static size_t encode(varintIngestFormat format, uint8_t *dst, uint64_t val) {
+    varintWidth len = 0;
+    switch (format) {
+    case VARINT_INGEST_TAGGED:
+        len = varintTaggedPut64(dst, val);
+        break;
+    case VARINT_INGEST_CHAINED:
+        len = varintChainedPutVarint(dst, val);
+        break;
+    case VARINT_INGEST_CHAINED_SIMPLE:
+        len = varintChainedSimpleEncode64(dst, val);
+        break;
+    case VARINT_INGEST_SPLIT:
+        varintSplitPut_(dst, len, val);
+        break;
+    case VARINT_INGEST_SPLIT_FULL:
+        varintSplitFullPut_(dst, len, val);
+        break;
+    case VARINT_INGEST_SPLIT_FULL_NO_ZERO:
+        varintSplitFullNoZeroPut_(dst, len, val);
+        break;
+    case VARINT_INGEST_SPLIT_FULL_16:
+        varintSplitFull16Put_(dst, len, val);
+        break;
+    case VARINT_INGEST_EXTERNAL:
+        len = varintExternalPut(dst, val);
+        break;
+    }
+
+    return len;
+}
+
+/* Temporary file holding 'count' values of 'vals' in 'format'.  For
+ * EXTERNAL, 'widths' receives the width of each value. */
+static int writeStream(varintIngestFormat format, const uint64_t *vals,
+                       size_t count, size_t *bytes, uint8_t *widths) {
+    char path[] = "/tmp/varintIngestTestXXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        return -1;
+    }
+
+    unlink(path);
+    uint8_t *buf = malloc(count * 9);
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        const size_t width = encode(format, buf + len, vals[i]);
+        if (widths) {
+            widths[i] = (uint8_t)width;
+        }
+
+        len += width;
+    }
+
+    if (write(fd, buf, len) != (ssize_t)len) {
+        close(fd);
+        free(buf);
+        return -1;
+    }
+
+    free(buf);
+    *bytes = len;
+    return fd;
+}
+
+typedef struct blockCheck {
+    pthread_mutex_t lock;
+    const uint64_t *expect;
+    uint64_t seen;
+    uint64_t blocks;
+    bool bad;
+    uint64_t stopAfter;
+} blockCheck;
+
+static bool checkBlock(void *ctx, const varintIngestBlock *block) {
+    blockCheck *c = ctx;
+    bool bad = false;
+    for (size_t i = 0; i < block->count; i++) {
+        bad |= block->values[i] != c->expect[block->firstIndex + i];
+    }
+
+    pthread_mutex_lock(&c->lock);
+    c->seen += block->count;
+    c->bad |= bad;
+    const bool keepGoing = ++c->blocks < c->stopAfter;
+    pthread_mutex_unlock(&c->lock);
+    return keepGoing;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(31);
+
+    static uint64_t vals[COUNT];
+    static uint64_t out[COUNT];
+    static uint8_t widths[COUNT];
+    for (size_t i = 0; i < COUNT; i++) {
+        /* SplitFullNoZero has no encoding for 0 */
+        vals[i] = ctestRandomWidth();
+        vals[i] = vals[i] ? vals[i] : 1;
+    }
+
+    TEST("every format, reader, and worker count decodes the file") {
+        for (varintIngestFormat f = VARINT_INGEST_TAGGED;
+             f <= VARINT_INGEST_EXTERNAL; f++) {
+            size_t bytes = 0;
+            const int fd = writeStream(f, vals, COUNT, &bytes, widths);
+            if (fd < 0) {
+                ERRR("Couldn't write test file!");
+                break;
+            }
+
+            for (uint32_t mode = 0; mode < 8; mode++) {
+                blockCheck check = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                                    .expect = vals,
+                                    .stopAfter = UINT64_MAX};
+                memset(out, 0, sizeof(out));
+                varintIngestConfig config = {
+                    .format = f,
+                    .blockBytes = mode & 1 ? 4096 : 0,
+                    .workers = mode & 2 ? 4 : 0,
+                    .noUring = mode & 4,
+                    .depth = mode & 1 ? 3 : 0,
+                    .out = out,
+                    .outCapacity = COUNT,
+                    .fn = checkBlock,
+                    .ctx = &check,
+                    .widths = widths,
+                    .widthCount = COUNT};
+                varintIngestStats stats;
+                if (!varintIngestFile(fd, &config, &stats) ||
+                    stats.values != COUNT || stats.bytes != bytes ||
+                    memcmp(out, vals, sizeof(vals)) || check.bad ||
+                    check.seen != COUNT || check.blocks != stats.blocks) {
+                    ERR("Format %d mode %u failed (errno %d)!", f, mode,
+                        errno);
+                }
+            }
+
+            /* Callback only: values come from per-worker scratch */
+            blockCheck check = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                                .expect = vals,
+                                .stopAfter = UINT64_MAX};
+            varintIngestConfig config = {.format = f,
+                                         .blockBytes = 8192,
+                                         .workers = 2,
+                                         .fn = checkBlock,
+                                         .ctx = &check,
+                                         .widths = widths,
+                                         .widthCount = COUNT};
+            if (!varintIngestFile(fd, &config, NULL) || check.bad ||
+                check.seen != COUNT) {
+                ERR("Format %d callback-only ingest failed!", f);
+            }
+
+            close(fd);
+        }
+    }
+
+    TEST("errors stop ingest") {
+        size_t bytes = 0;
+        int fd = writeStream(VARINT_INGEST_TAGGED, vals, COUNT, &bytes, NULL);
+        varintIngestConfig config = {.format = VARINT_INGEST_TAGGED,
+                                     .blockBytes = 4096,
+                                     .workers = 2,
+                                     .out = out,
+                                     .outCapacity = COUNT - 1};
+        if (varintIngestFile(fd, &config, NULL) || errno != ENOSPC) {
+            ERRR("Undersized output not detected!");
+        }
+
+        blockCheck check = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                            .expect = vals,
+                            .stopAfter = 3};
+        config.out = NULL;
+        config.fn = checkBlock;
+        config.ctx = &check;
+        if (varintIngestFile(fd, &config, NULL) || errno != ECANCELED) {
+            ERRR("Callback stop not reported!");
+        }
+
+        /* Cut the last varint short */
+        uint64_t wide = UINT64_MAX;
+        uint8_t z[9];
+        const varintWidth len = varintTaggedPut64(z, wide);
+        if (write(fd, z, len - 1) != len - 1) {
+            ERRR("Couldn't extend test file!");
+        }
+
+        config.fn = NULL;
+        for (int noUring = 0; noUring < 2; noUring++) {
+            config.noUring = noUring;
+            if (varintIngestFile(fd, &config, NULL) || errno != EILSEQ) {
+                ERRR("Truncated varint not detected!");
+            }
+        }
+
+        close(fd);
+
+        /* Empty file */
+        fd = writeStream(VARINT_INGEST_TAGGED, vals, 0, &bytes, NULL);
+        varintIngestStats stats;
+        if (!varintIngestFile(fd, &config, &stats) || stats.values) {
+            ERRR("Empty file failed!");
+        }
+
+        close(fd);
+
+        /* External widths must describe the file exactly */
+        fd = writeStream(VARINT_INGEST_EXTERNAL, vals, COUNT, &bytes, widths);
+        config.format = VARINT_INGEST_EXTERNAL;
+        config.widths = NULL;
+        if (varintIngestFile(fd, &config, NULL) || errno != EINVAL) {
+            ERRR("Missing External widths not detected!");
+        }
+
+        config.widths = widths;
+        config.widthCount = COUNT - 1;
+        if (varintIngestFile(fd, &config, NULL) || errno != EILSEQ) {
+            ERRR("Bytes past the last External width not detected!");
+        }
+
+        config.widthCount = COUNT;
+        widths[COUNT - 1]++;
+        if (varintIngestFile(fd, &config, NULL) || errno != EILSEQ) {
+            ERRR("External widths past the end of file not detected!");
+        }
+
+        close(fd);
+    }
+
+    TEST_FINAL_RESULT;
+}
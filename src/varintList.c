@@ -0,0 +1,313 @@
+#include "varintList.h"
+#include "varintSplitFull.h"
+
+#include <stdlib.h>
+
+/* Bytes of free space given to each side of a new (or regrown) list. */
+#define VARINT_LIST_INITIAL_SLACK 32
+
+/* ====================================================================
+ * Entry framing
+ * ==================================================================== */
+static size_t varintListEntryLenForPayload_(size_t len) {
+    size_t headerLen;
+    size_t backLen;
+    varintSplitFullLength_(headerLen, len);
+    varintSplitFullLength_(backLen, headerLen + len);
+    return headerLen + len + backLen;
+}
+
+static void varintListEntryWrite_(uint8_t *dst, const void *payload,
+                                  size_t len) {
+    size_t headerLen;
+    size_t backLen;
+    varintSplitFullPut_(dst, headerLen, len);
+    memcpy(dst + headerLen, payload, len);
+    varintSplitFullReversedPutForward_(dst + headerLen + len, backLen,
+                                       headerLen + len);
+    (void)backLen;
+}
+
+/* Total length of the entry starting at 'entry'. */
+static size_t varintListEntryLen_(const uint8_t *entry) {
+    size_t headerLen;
+    size_t backLen;
+    uint64_t len;
+    varintSplitFullGet_(entry, headerLen, len);
+    varintSplitFullLength_(backLen, headerLen + len);
+    return headerLen + len + backLen;
+}
+
+/* Total length of the entry ending immediately before 'end'. */
+static size_t varintListEntryLenBackward_(const uint8_t *end) {
+    size_t backLen;
+    uint64_t len;
+    varintSplitFullReversedGet_(end - 1, backLen, len);
+    return backLen + len;
+}
+
+const uint8_t *varintListEntryGet(const uint8_t *entry, size_t *len) {
+    size_t headerLen;
+    uint64_t payloadLen;
+    varintSplitFullGet_(entry, headerLen, payloadLen);
+    *len = payloadLen;
+    return entry + headerLen;
+}
+
+/* ====================================================================
+ * Storage management
+ * ==================================================================== */
+varintList *varintListNew(void) {
+    const size_t size = 2 * VARINT_LIST_INITIAL_SLACK;
+    varintList *l = malloc(sizeof(*l) + size);
+    if (!l) {
+        return NULL;
+    }
+
+    l->size = size;
+    l->head = l->tail = VARINT_LIST_INITIAL_SLACK;
+    l->count = 0;
+    return l;
+}
+
+void varintListFree(varintList *l) {
+    free(l);
+}
+
+/* Guarantee at least 'headNeed' free bytes before the first entry and
+ * 'tailNeed' free bytes after the last entry.
+ *
+ * Growing at least doubles the free space so pushes stay amortized O(1).
+ * When only the tail needs room we can realloc; otherwise we copy entries
+ * into a new allocation with the spare space split across both sides. */
+static varintList *varintListReserve_(varintList *l, size_t headNeed,
+                                      size_t tailNeed) {
+    if (l->head >= headNeed && l->size - l->tail >= tailNeed) {
+        return l;
+    }
+
+    const size_t used = l->tail - l->head;
+    if (l->head >= headNeed) {
+        const size_t size =
+            l->tail + 2 * tailNeed + used + VARINT_LIST_INITIAL_SLACK;
+        varintList *grown = realloc(l, sizeof(*l) + size);
+        if (!grown) {
+            return NULL;
+        }
+
+        grown->size = size;
+        return grown;
+    }
+
+    const size_t size = 2 * (used + headNeed + tailNeed) +
+                        2 * VARINT_LIST_INITIAL_SLACK;
+    varintList *grown = malloc(sizeof(*l) + size);
+    if (!grown) {
+        return NULL;
+    }
+
+    const size_t spare = size - used - headNeed - tailNeed;
+    grown->size = size;
+    grown->head = headNeed + spare / 2;
+    grown->tail = grown->head + used;
+    grown->count = l->count;
+    memcpy(grown->data + grown->head, l->data + l->head, used);
+    free(l);
+    return grown;
+}
+
+/* Turn the 'oldLen' bytes at '*offset' into 'newLen' bytes of unspecified
+ * content, moving whichever side of the list is shorter.  '*offset' is
+ * updated to the new position of the region. */
+static varintList *varintListResizeAt_(varintList *l, size_t *offset,
+                                       size_t oldLen, size_t newLen) {
+    const size_t before = *offset - l->head;
+    const size_t after = l->tail - (*offset + oldLen);
+
+    if (newLen > oldLen) {
+        const size_t grow = newLen - oldLen;
+        if (before < after) {
+            l = varintListReserve_(l, grow, 0);
+            if (!l) {
+                return NULL;
+            }
+
+            memmove(l->data + l->head - grow, l->data + l->head, before);
+            l->head -= grow;
+        } else {
+            l = varintListReserve_(l, 0, grow);
+            if (!l) {
+                return NULL;
+            }
+
+            memmove(l->data + l->head + before + newLen,
+                    l->data + l->head + before + oldLen, after);
+            l->tail += grow;
+        }
+    } else if (newLen < oldLen) {
+        const size_t shrink = oldLen - newLen;
+        if (before < after) {
+            memmove(l->data + l->head + shrink, l->data + l->head, before);
+            l->head += shrink;
+        } else {
+            memmove(l->data + l->head + before + newLen,
+                    l->data + l->head + before + oldLen, after);
+            l->tail -= shrink;
+        }
+    }
+
+    *offset = l->head + before;
+    return l;
+}
+
+/* ====================================================================
+ * Push / Pop
+ * ==================================================================== */
+varintList *varintListPushHead(varintList *l, const void *payload,
+                               size_t len) {
+    const size_t entryLen = varintListEntryLenForPayload_(len);
+    l = varintListReserve_(l, entryLen, 0);
+    if (!l) {
+        return NULL;
+    }
+
+    l->head -= entryLen;
+    l->count++;
+    varintListEntryWrite_(l->data + l->head, payload, len);
+    return l;
+}
+
+varintList *varintListPushTail(varintList *l, const void *payload,
+                               size_t len) {
+    const size_t entryLen = varintListEntryLenForPayload_(len);
+    l = varintListReserve_(l, 0, entryLen);
+    if (!l) {
+        return NULL;
+    }
+
+    varintListEntryWrite_(l->data + l->tail, payload, len);
+    l->tail += entryLen;
+    l->count++;
+    return l;
+}
+
+bool varintListPopHead(varintList *l) {
+    if (!l->count) {
+        return false;
+    }
+
+    l->head += varintListEntryLen_(l->data + l->head);
+    l->count--;
+    return true;
+}
+
+bool varintListPopTail(varintList *l) {
+    if (!l->count) {
+        return false;
+    }
+
+    l->tail -= varintListEntryLenBackward_(l->data + l->tail);
+    l->count--;
+    return true;
+}
+
+/* ====================================================================
+ * Iteration
+ * ==================================================================== */
+uint8_t *varintListFirst(const varintList *l) {
+    return l->count ? (uint8_t *)l->data + l->head : NULL;
+}
+
+uint8_t *varintListLast(const varintList *l) {
+    if (!l->count) {
+        return NULL;
+    }
+
+    const uint8_t *end = l->data + l->tail;
+    return (uint8_t *)end - varintListEntryLenBackward_(end);
+}
+
+uint8_t *varintListNext(const varintList *l, const uint8_t *entry) {
+    const uint8_t *next = entry + varintListEntryLen_(entry);
+    return next < l->data + l->tail ? (uint8_t *)next : NULL;
+}
+
+uint8_t *varintListPrev(const varintList *l, const uint8_t *entry) {
+    if (entry <= l->data + l->head) {
+        return NULL;
+    }
+
+    return (uint8_t *)entry - varintListEntryLenBackward_(entry);
+}
+
+/* Negative indexes count from the tail (-1 is the last entry).  We walk
+ * from whichever end is closer to the requested position. */
+uint8_t *varintListIndex(const varintList *l, int64_t index) {
+    if (index < 0) {
+        index += l->count;
+    }
+
+    if (index < 0 || (uint64_t)index >= l->count) {
+        return NULL;
+    }
+
+    uint8_t *entry;
+    if ((uint64_t)index < l->count / 2) {
+        entry = varintListFirst(l);
+        while (index--) {
+            entry = varintListNext(l, entry);
+        }
+    } else {
+        entry = varintListLast(l);
+        for (size_t i = l->count - 1; i > (uint64_t)index; i--) {
+            entry = varintListPrev(l, entry);
+        }
+    }
+
+    return entry;
+}
+
+/* ====================================================================
+ * In-place modification
+ * ==================================================================== */
+varintList *varintListReplace(varintList *l, uint8_t **entry,
+                              const void *payload, size_t len) {
+    size_t offset = *entry - l->data;
+    const size_t oldLen = varintListEntryLen_(*entry);
+    const size_t newLen = varintListEntryLenForPayload_(len);
+
+    l = varintListResizeAt_(l, &offset, oldLen, newLen);
+    if (!l) {
+        return NULL;
+    }
+
+    varintListEntryWrite_(l->data + offset, payload, len);
+    *entry = l->data + offset;
+    return l;
+}
+
+varintList *varintListInsert(varintList *l, uint8_t **entry,
+                             const void *payload, size_t len) {
+    size_t offset = *entry ? (size_t)(*entry - l->data) : l->tail;
+    const size_t newLen = varintListEntryLenForPayload_(len);
+
+    l = varintListResizeAt_(l, &offset, 0, newLen);
+    if (!l) {
+        return NULL;
+    }
+
+    varintListEntryWrite_(l->data + offset, payload, len);
+    l->count++;
+    *entry = l->data + offset;
+    return l;
+}
+
+void varintListDelete(varintList *l, uint8_t **entry) {
+    size_t offset = *entry - l->data;
+    const size_t oldLen = varintListEntryLen_(*entry);
+
+    /* Shrinking never allocates, so this can't fail. */
+    varintListResizeAt_(l, &offset, oldLen, 0);
+    l->count--;
+    *entry = offset < l->tail ? l->data + offset : NULL;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * List of SplitFull framed entries
+ * ==================================================================== */
+/* varint model List Container:
+ *   Type encoded inside: each entry carries a SplitFull length header and a
+ *                        Reversed SplitFull back-length trailer
+ *   Size: payload + 2 bytes to payload + 18 bytes per entry
+ *   Layout: one allocation holding all entries contiguously with free space
+ *           kept on both sides of the entries.
+ *   Meaning: the header tells you how far to step forward, the trailer
+ *            tells you how far to step backward.
+ *   Pro: one allocation per list instead of one node (plus two pointers)
+ *        per element.  Push and pop at either end are amortized O(1).
+ *   Con: inserting, deleting, or resizing an element in the middle moves
+ *        the shorter side of the list with memmove. */
+
+/* List Entry Layout */
+/* ================= */
+/*
+ * |[SplitFull payload length]|[payload]|[Reversed SplitFull back-length]|
+ *
+ * The back-length is the byte length of header plus payload, written with
+ * varintSplitFullReversedPutForward_() so its type byte is the final byte
+ * of the entry.  Reading one byte before an entry therefore always lands on
+ * the type byte of the previous entry's back-length.
+ *
+ * Payloads are opaque bytes.  For typed elements (integers, floats,
+ * strings) store a varintSplitValue as the payload. */
+
+typedef struct varintList {
+    size_t size;  /* bytes allocated for data[] */
+    size_t head;  /* offset of first entry in data[] */
+    size_t tail;  /* offset one past the last entry in data[] */
+    size_t count; /* number of entries */
+    uint8_t data[];
+} varintList;
+
+/* All functions returning varintList * may move the list in memory; always
+ * use the returned pointer.  On allocation failure they return NULL and
+ * leave the original list (and any entry pointers into it) untouched. */
+varintList *varintListNew(void);
+void varintListFree(varintList *l);
+
+#define varintListCount(l) ((l)->count)
+#define varintListBytes(l) ((l)->tail - (l)->head)
+
+varintList *varintListPushHead(varintList *l, const void *payload,
+                               size_t len);
+varintList *varintListPushTail(varintList *l, const void *payload,
+                               size_t len);
+bool varintListPopHead(varintList *l);
+bool varintListPopTail(varintList *l);
+
+/* Iteration.  Entry pointers stay valid until the next call modifying the
+ * list.  Each returns NULL when there is no such entry. */
+uint8_t *varintListFirst(const varintList *l);
+uint8_t *varintListLast(const varintList *l);
+uint8_t *varintListNext(const varintList *l, const uint8_t *entry);
+uint8_t *varintListPrev(const varintList *l, const uint8_t *entry);
+uint8_t *varintListIndex(const varintList *l, int64_t index);
+
+/* Return pointer to payload of 'entry' and set 'len' to its length. */
+const uint8_t *varintListEntryGet(const uint8_t *entry, size_t *len);
+
+/* In-place modification.  '*entry' is updated to point at:
+ *   - Replace: the replaced entry
+ *   - Insert: the inserted entry (inserted before '*entry'; if '*entry' is
+ *             NULL, the payload is appended)
+ *   - Delete: the entry after the deleted one, or NULL if none
+ * Delete never allocates, so it can't fail and doesn't move the list. */
+varintList *varintListReplace(varintList *l, uint8_t **entry,
+                              const void *payload, size_t len);
+varintList *varintListInsert(varintList *l, uint8_t **entry,
+                             const void *payload, size_t len);
+void varintListDelete(varintList *l, uint8_t **entry);
+
+__END_DECLS
@@ -0,0 +1,247 @@
+#include "varintList.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+/* Payload 'id' of length 'len' is bytes (id + i) so contents are checkable. */
+static void fill(uint8_t *buf, size_t id, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(id + i);
+    }
+}
+
+static bool matches(const uint8_t *entry, size_t id, size_t len) {
+    size_t gotLen;
+    const uint8_t *got = varintListEntryGet(entry, &gotLen);
+    if (gotLen != len) {
+        return false;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        if (got[i] != (uint8_t)(id + i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+
+    /* Lengths crossing every SplitFull header width boundary */
+    static const size_t lens[] = {0,     1,     62,    63,   64,
+                                  65,    200,   16380, 16446, 16447,
+                                  16500, 70000, 3,     0,     9};
+    const size_t lensCount = sizeof(lens) / sizeof(*lens);
+    uint8_t *buf = malloc(70000);
+
+    TEST("push tail, iterate forward and backward") {
+        varintList *l = varintListNew();
+        for (size_t i = 0; i < lensCount; i++) {
+            fill(buf, i, lens[i]);
+            l = varintListPushTail(l, buf, lens[i]);
+        }
+
+        if (varintListCount(l) != lensCount) {
+            ERR("Expected %zu entries, got %zu!", lensCount,
+                varintListCount(l));
+        }
+
+        size_t i = 0;
+        for (uint8_t *e = varintListFirst(l); e; e = varintListNext(l, e)) {
+            if (!matches(e, i, lens[i])) {
+                ERR("Forward entry %zu mismatch!", i);
+            }
+            i++;
+        }
+
+        if (i != lensCount) {
+            ERR("Forward iteration visited %zu entries!", i);
+        }
+
+        for (uint8_t *e = varintListLast(l); e; e = varintListPrev(l, e)) {
+            i--;
+            if (!matches(e, i, lens[i])) {
+                ERR("Backward entry %zu mismatch!", i);
+            }
+        }
+
+        if (i != 0) {
+            ERR("Backward iteration stopped at %zu!", i);
+        }
+
+        for (size_t j = 0; j < lensCount; j++) {
+            if (!matches(varintListIndex(l, j), j, lens[j]) ||
+                !matches(varintListIndex(l, (int64_t)j - lensCount), j,
+                         lens[j])) {
+                ERR("Index %zu mismatch!", j);
+            }
+        }
+
+        if (varintListIndex(l, lensCount) ||
+            varintListIndex(l, -(int64_t)lensCount - 1)) {
+            ERRR("Out of range index returned an entry!");
+        }
+
+        varintListFree(l);
+    }
+
+    TEST("push and pop at both ends behave as a deque") {
+        varintList *l = varintListNew();
+        size_t ids[4096];
+        size_t lo = 2048;
+        size_t hi = 2048;
+        ctestSeed(7);
+        for (size_t round = 0; round < 20000; round++) {
+            const uint32_t r = (uint32_t)ctestRandom();
+            switch (r % 4) {
+            case 0:
+                if (lo > 0) {
+                    ids[--lo] = round;
+                    fill(buf, round, round % 90);
+                    l = varintListPushHead(l, buf, round % 90);
+                }
+                break;
+            case 1:
+                if (hi < 4096) {
+                    ids[hi++] = round;
+                    fill(buf, round, round % 90);
+                    l = varintListPushTail(l, buf, round % 90);
+                }
+                break;
+            case 2:
+                if (varintListPopHead(l) != (lo < hi)) {
+                    ERRR("PopHead result mismatch!");
+                }
+                if (lo < hi) {
+                    lo++;
+                }
+                break;
+            case 3:
+                if (varintListPopTail(l) != (lo < hi)) {
+                    ERRR("PopTail result mismatch!");
+                }
+                if (lo < hi) {
+                    hi--;
+                }
+                break;
+            }
+
+            if (varintListCount(l) != hi - lo) {
+                ERR("Round %zu: count %zu, expected %zu!", round,
+                    varintListCount(l), hi - lo);
+                break;
+            }
+
+            if (lo < hi &&
+                (!matches(varintListFirst(l), ids[lo], ids[lo] % 90) ||
+                 !matches(varintListLast(l), ids[hi - 1],
+                          ids[hi - 1] % 90))) {
+                ERR("Round %zu: ends don't match!", round);
+                break;
+            }
+        }
+
+        size_t i = lo;
+        for (uint8_t *e = varintListFirst(l); e; e = varintListNext(l, e)) {
+            if (!matches(e, ids[i], ids[i] % 90)) {
+                ERR("Entry %zu mismatch after deque rounds!", i - lo);
+            }
+            i++;
+        }
+
+        varintListFree(l);
+    }
+
+    TEST("replace, insert, and delete in the middle") {
+        varintList *l = varintListNew();
+        size_t ids[64];
+        size_t idLens[64];
+        size_t count = 0;
+        for (; count < 32; count++) {
+            ids[count] = count;
+            idLens[count] = count * 3;
+            fill(buf, count, idLens[count]);
+            l = varintListPushTail(l, buf, idLens[count]);
+        }
+
+        /* Grow and shrink entries near both ends and across header widths */
+        static const size_t positions[] = {0, 3, 16, 28, 31};
+        static const size_t newLens[] = {70, 0, 16447, 5, 64};
+        for (size_t k = 0; k < 5; k++) {
+            const size_t at = positions[k];
+            uint8_t *e = varintListIndex(l, at);
+            fill(buf, 1000 + k, newLens[k]);
+            l = varintListReplace(l, &e, buf, newLens[k]);
+            ids[at] = 1000 + k;
+            idLens[at] = newLens[k];
+            if (!matches(e, ids[at], idLens[at])) {
+                ERR("Replaced entry %zu not returned!", at);
+            }
+        }
+
+        /* Insert before index 5 and at the end */
+        uint8_t *e = varintListIndex(l, 5);
+        fill(buf, 2000, 100);
+        l = varintListInsert(l, &e, buf, 100);
+        memmove(&ids[6], &ids[5], (count - 5) * sizeof(*ids));
+        memmove(&idLens[6], &idLens[5], (count - 5) * sizeof(*idLens));
+        ids[5] = 2000;
+        idLens[5] = 100;
+        count++;
+
+        e = NULL;
+        fill(buf, 3000, 1);
+        l = varintListInsert(l, &e, buf, 1);
+        ids[count] = 3000;
+        idLens[count] = 1;
+        count++;
+
+        /* Delete near the front (moves head side) and near the back */
+        e = varintListIndex(l, 2);
+        varintListDelete(l, &e);
+        if (!matches(e, ids[3], idLens[3])) {
+            ERRR("Delete didn't return the following entry!");
+        }
+        memmove(&ids[2], &ids[3], (count - 3) * sizeof(*ids));
+        memmove(&idLens[2], &idLens[3], (count - 3) * sizeof(*idLens));
+        count--;
+
+        e = varintListLast(l);
+        varintListDelete(l, &e);
+        if (e) {
+            ERRR("Deleting the last entry should return NULL!");
+        }
+        count--;
+
+        if (varintListCount(l) != count) {
+            ERR("Count is %zu, expected %zu!", varintListCount(l), count);
+        }
+
+        size_t i = 0;
+        for (e = varintListFirst(l); e; e = varintListNext(l, e)) {
+            if (!matches(e, ids[i], idLens[i])) {
+                ERR("Entry %zu mismatch after modifications!", i);
+            }
+            i++;
+        }
+
+        for (e = varintListLast(l); e; e = varintListPrev(l, e)) {
+            i--;
+            if (!matches(e, ids[i], idLens[i])) {
+                ERR("Backward entry %zu mismatch after modifications!", i);
+            }
+        }
+
+        varintListFree(l);
+    }
+
+    free(buf);
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+/* ====================================================================
+ * Packed bit arrays for every width, generated by templates
+ * ==================================================================== */
+/* varint::packed<Bits, Slot> reads and writes the same layout as
+ * varintPacked.h with PACK_STORAGE_BITS Bits and
+ * PACK_STORAGE_SLOT_STORAGE_TYPE Slot: value i occupies bits
+ * [i * Bits, (i + 1) * Bits) of an array of Slot, low bits first, with a
+ * value crossing a slot boundary keeping its low bits in the first slot.
+ *
+ * Instead of one #define + #include stanza per width, every width from 1
+ * to 64 bits is one template instantiation.  Positions repeat their slot
+ * alignment every 'period' values (slot bits / gcd(Bits, slot bits)), so
+ * each position inside a period has its slot, shift, and whether it
+ * straddles slots known at compile time.  Kernels are generated for each
+ * of those positions:
+ *   get<I>(src) / set<I>(dst, v)  compile time position: no branches
+ *   unpack() / pack()             whole periods fully unrolled, so bulk
+ *                                 scans have no per-element branches
+ *   get(src, i) / set(dst, i, v)  runtime position: branch free when no
+ *                                 position can straddle (Bits divides the
+ *                                 slot width), else one straddle branch
+ *
+ * Unlike varintPacked.h, widths wider than the slot (e.g. 40 bit values
+ * in uint8_t slots) are supported: a value may span any number of slots.
+ *
+ * varint::packedUnpack() / packedPack() pick the instantiation for a
+ * width only known at runtime from a table covering all 64 widths. */
+
+#if __cplusplus < 201703L
+#error "varintPacked.hpp requires C++17 or newer"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+namespace varint {
+
+namespace detail {
+/* Smallest unsigned type holding 'Bits' bits, like the default
+ * PACK_STORAGE_VALUE_TYPE. */
+template <unsigned Bits>
+using packedValue = std::conditional_t<
+    (Bits <= 8), std::uint8_t,
+    std::conditional_t<(Bits <= 16), std::uint16_t,
+                       std::conditional_t<(Bits <= 32), std::uint32_t,
+                                          std::uint64_t>>>;
+} // namespace detail
+
+template <unsigned Bits, typename Slot = std::uint32_t>
+struct packed {
+    static_assert(Bits >= 1 && Bits <= 64, "packed widths are 1 to 64 bits");
+    static_assert(std::is_unsigned_v<Slot> && sizeof(Slot) <= 8,
+                  "slots are unsigned integers up to 64 bits");
+
+    using value_type = detail::packedValue<Bits>;
+    using slot_type = Slot;
+
+    static constexpr unsigned bits = Bits;
+    static constexpr unsigned slot_bits = sizeof(Slot) * 8;
+
+    /* Values until slot alignment repeats, and the slots they fill */
+    static constexpr std::size_t period =
+        slot_bits / std::gcd(Bits, slot_bits);
+    static constexpr std::size_t period_slots = period * Bits / slot_bits;
+
+    static constexpr std::uint64_t mask =
+        Bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << Bits) - 1;
+
+    /* True if some position crosses a slot boundary */
+    static constexpr bool can_straddle = slot_bits % Bits != 0;
+
+    /* Slots needed to hold 'count' values */
+    static constexpr std::size_t slots_for(std::size_t count) noexcept {
+        return (count * Bits + slot_bits - 1) / slot_bits;
+    }
+
+    /* Values held by 'bytes' bytes of storage, as
+     * varintPacked<Bits>CountFromStorageBytes() */
+    static constexpr std::size_t
+    count_from_storage_bytes(std::size_t bytes) noexcept {
+        return bytes * 8 / Bits;
+    }
+
+    /* ================================================================
+     * Compile time positions
+     * ================================================================ */
+    template <std::size_t I>
+    static constexpr value_type get(const Slot *src) noexcept {
+        constexpr std::size_t first = I * Bits / slot_bits;
+        constexpr unsigned shift = I * Bits % slot_bits;
+        constexpr std::size_t span =
+            (shift + Bits + slot_bits - 1) / slot_bits;
+        return value_type(
+            gather<first, shift>(src, std::make_index_sequence<span>{}) &
+            mask);
+    }
+
+    template <std::size_t I>
+    static constexpr void set(Slot *dst, value_type v) noexcept {
+        constexpr std::size_t first = I * Bits / slot_bits;
+        constexpr unsigned shift = I * Bits % slot_bits;
+        constexpr std::size_t span =
+            (shift + Bits + slot_bits - 1) / slot_bits;
+        scatter<first, shift>(dst, std::uint64_t(v) & mask,
+                              std::make_index_sequence<span>{});
+    }
+
+    /* ================================================================
+     * Runtime positions
+     * ================================================================ */
+    static constexpr value_type get(const Slot *src, std::size_t i) noexcept {
+        const std::uint64_t bit = std::uint64_t(i) * Bits;
+        const Slot *in = src + bit / slot_bits;
+        const unsigned shift = bit % slot_bits;
+        std::uint64_t v = std::uint64_t(in[0]) >> shift;
+        if constexpr (can_straddle) {
+            for (unsigned k = 1; k * slot_bits < shift + Bits; k++) {
+                v |= std::uint64_t(in[k]) << (k * slot_bits - shift);
+            }
+        }
+
+        return value_type(v & mask);
+    }
+
+    static constexpr void set(Slot *dst, std::size_t i,
+                              value_type v) noexcept {
+        const std::uint64_t bit = std::uint64_t(i) * Bits;
+        Slot *out = dst + bit / slot_bits;
+        const unsigned shift = bit % slot_bits;
+        const std::uint64_t val = std::uint64_t(v) & mask;
+        out[0] = Slot((out[0] & ~Slot(mask << shift)) | Slot(val << shift));
+        if constexpr (can_straddle) {
+            for (unsigned k = 1; k * slot_bits < shift + Bits; k++) {
+                const unsigned down = k * slot_bits - shift;
+                out[k] = Slot((out[k] & ~Slot(mask >> down)) |
+                              Slot(val >> down));
+            }
+        }
+    }
+
+    /* ================================================================
+     * Bulk
+     * ================================================================ */
+    /* Read 'count' values starting at position 'first' into 'out'.  'out'
+     * may be any integer type at least as wide as value_type. */
+    template <typename Value>
+    static constexpr void unpack(const Slot *src, std::size_t first,
+                                 Value *out, std::size_t count) noexcept {
+        std::size_t i = 0;
+        for (; i < count && (first + i) % period; i++) {
+            out[i] = get(src, first + i);
+        }
+
+        const Slot *block = src + (first + i) / period * period_slots;
+        for (; count - i >= period; i += period) {
+            unpackPeriod(block, out + i, std::make_index_sequence<period>{});
+            block += period_slots;
+        }
+
+        for (; i < count; i++) {
+            out[i] = get(src, first + i);
+        }
+    }
+
+    /* Write 'count' values from 'values' starting at position 'first'.
+     * Bits outside the written positions are preserved.  Wider 'values'
+     * types are truncated to value_type. */
+    template <typename Value>
+    static constexpr void pack(Slot *dst, std::size_t first,
+                               const Value *values,
+                               std::size_t count) noexcept {
+        std::size_t i = 0;
+        for (; i < count && (first + i) % period; i++) {
+            set(dst, first + i, value_type(values[i]));
+        }
+
+        Slot *block = dst + (first + i) / period * period_slots;
+        for (; count - i >= period; i += period) {
+            packPeriod(block, values + i, std::make_index_sequence<period>{});
+            block += period_slots;
+        }
+
+        for (; i < count; i++) {
+            set(dst, first + i, value_type(values[i]));
+        }
+    }
+
+    /* First position in sorted 'src' holding a value >= 'v', as
+     * varintPacked<Bits>BinarySearch() */
+    static constexpr std::size_t lower_bound(const Slot *src, std::size_t len,
+                                             value_type v) noexcept {
+        std::size_t min = 0;
+        std::size_t max = len;
+        while (min < max) {
+            const std::size_t mid = (min + max) >> 1;
+            if (get(src, mid) < v) {
+                min = mid + 1;
+            } else {
+                max = mid;
+            }
+        }
+
+        return min;
+    }
+
+  private:
+    template <std::size_t First, unsigned Shift, std::size_t... K>
+    static constexpr std::uint64_t
+    gather(const Slot *src, std::index_sequence<K...>) noexcept {
+        return (std::uint64_t(src[First]) >> Shift) |
+               (std::uint64_t(0) | ... |
+                (K ? std::uint64_t(src[First + K]) << shiftUp<K, Shift>()
+                   : 0));
+    }
+
+    template <std::size_t First, unsigned Shift, std::size_t... K>
+    static constexpr void scatter(Slot *dst, std::uint64_t val,
+                                  std::index_sequence<K...>) noexcept {
+        dst[First] = Slot((dst[First] & ~Slot(mask << Shift)) |
+                          Slot(val << Shift));
+        ((K ? void(dst[First + K] =
+                       Slot((dst[First + K] &
+                             ~Slot(mask >> shiftUp<K, Shift>())) |
+                            Slot(val >> shiftUp<K, Shift>())))
+            : void()),
+         ...);
+    }
+
+    /* Distance from bit 0 of the K-th spanned slot back to the value's
+     * first bit.  Only K >= 1 is used; K == 0 returns 0 so the shift
+     * stays in range when the fold instantiates it. */
+    template <std::size_t K, unsigned Shift>
+    static constexpr unsigned shiftUp() noexcept {
+        return K ? unsigned(K * slot_bits - Shift) : 0;
+    }
+
+    template <typename Value, std::size_t... I>
+    static constexpr void unpackPeriod(const Slot *block, Value *out,
+                                       std::index_sequence<I...>) noexcept {
+        ((out[I] = get<I>(block)), ...);
+    }
+
+    template <typename Value, std::size_t... I>
+    static constexpr void packPeriod(Slot *block, const Value *values,
+                                     std::index_sequence<I...>) noexcept {
+        (set<I>(block, value_type(values[I])), ...);
+    }
+};
+
+/* ====================================================================
+ * Runtime width dispatch
+ * ==================================================================== */
+namespace detail {
+template <typename Slot>
+using packedUnpackFn = void (*)(const Slot *, std::size_t, std::uint64_t *,
+                                std::size_t);
+template <typename Slot>
+using packedPackFn = void (*)(Slot *, std::size_t, const std::uint64_t *,
+                              std::size_t);
+
+/* Bulk kernels widened to uint64_t values so every width shares one
+ * signature.  The kernels read and write uint64_t values directly, so
+ * nothing is staged. */
+template <unsigned Bits, typename Slot>
+void packedUnpackWide(const Slot *src, std::size_t first, std::uint64_t *out,
+                      std::size_t count) {
+    packed<Bits, Slot>::unpack(src, first, out, count);
+}
+
+template <unsigned Bits, typename Slot>
+void packedPackWide(Slot *dst, std::size_t first, const std::uint64_t *values,
+                    std::size_t count) {
+    packed<Bits, Slot>::pack(dst, first, values, count);
+}
+
+template <typename Slot, std::size_t... B>
+constexpr std::array<packedUnpackFn<Slot>, 64>
+packedUnpackTable(std::index_sequence<B...>) {
+    return {{&packedUnpackWide<B + 1, Slot>...}};
+}
+
+template <typename Slot, std::size_t... B>
+constexpr std::array<packedPackFn<Slot>, 64>
+packedPackTable(std::index_sequence<B...>) {
+    return {{&packedPackWide<B + 1, Slot>...}};
+}
+} // namespace detail
+
+/* Unpack 'count' values of width 'bits' (1 to 64) starting at position
+ * 'first' of 'src' (an array of Slot) into 'out'. */
+template <typename Slot = std::uint32_t>
+void packedUnpack(unsigned bits, const void *src, std::size_t first,
+                  std::uint64_t *out, std::size_t count) {
+    static constexpr auto table =
+        detail::packedUnpackTable<Slot>(std::make_index_sequence<64>{});
+    table[bits - 1](static_cast<const Slot *>(src), first, out, count);
+}
+
+/* Pack 'count' values of width 'bits' (1 to 64) into 'dst' (an array of
+ * Slot) starting at position 'first'.  Values are truncated to 'bits'. */
+template <typename Slot = std::uint32_t>
+void packedPack(unsigned bits, void *dst, std::size_t first,
+                const std::uint64_t *values, std::size_t count) {
+    static constexpr auto table =
+        detail::packedPackTable<Slot>(std::make_index_sequence<64>{});
+    table[bits - 1](static_cast<Slot *>(dst), first, values, count);
+}
+
+} // namespace varint
@@ -0,0 +1,197 @@
+/* varintPacked.h uses C99 'restrict' which C++ spells differently */
+#define restrict __restrict
+
+#define PACK_STORAGE_BITS 12
+#define PACK_STORAGE_SLOT_STORAGE_TYPE uint32_t
+#define PACK_STORAGE_VALUE_TYPE uint16_t
+#define PACK_STORAGE_MICRO_PROMOTION_TYPE uint32_t
+#include "varintPacked.h"
+
+#define PACK_STORAGE_BITS 12
+#define PACK_STORAGE_COMPACT
+#define PACK_STORAGE_VALUE_TYPE uint16_t
+#define PACK_STORAGE_MICRO_PROMOTION_TYPE uint64_t
+#include "varintPacked.h"
+
+#define PACK_STORAGE_BITS 14
+#define PACK_STORAGE_VALUE_TYPE uint32_t
+#include "varintPacked.h"
+
+#include "varintPacked.hpp"
+
+#include "ctest.h"
+
+#include <cstring>
+#include <vector>
+
+#define COUNT 1000
+
+/* Bit by bit definition of the layout: bit k of value i is bit
+ * (i * bits + k) of the slot array, low bits of each slot first. */
+template <typename Slot>
+static uint64_t referenceGet(const std::vector<Slot> &s, unsigned bits,
+                             size_t i) {
+    const size_t slotBits = sizeof(Slot) * 8;
+    uint64_t v = 0;
+    for (unsigned k = 0; k < bits; k++) {
+        const size_t bit = i * bits + k;
+        v |= uint64_t((s[bit / slotBits] >> (bit % slotBits)) & 1) << k;
+    }
+
+    return v;
+}
+
+/* Check every access path of one width against the reference layout. */
+template <unsigned Bits, typename Slot>
+static int32_t checkWidth(void) {
+    using P = varint::packed<Bits, Slot>;
+    using V = typename P::value_type;
+    int32_t err = 0;
+
+    std::vector<V> vals(COUNT);
+    for (auto &v : vals) {
+        v = V(ctestRandom() & P::mask);
+    }
+
+    /* Runtime set, checked by the reference and runtime get */
+    std::vector<Slot> a(P::slots_for(COUNT));
+    for (size_t i = 0; i < COUNT; i++) {
+        P::set(a.data(), i, vals[i]);
+    }
+
+    for (size_t i = 0; i < COUNT; i++) {
+        if (referenceGet(a, Bits, i) != vals[i] ||
+            P::get(a.data(), i) != vals[i]) {
+            ERR("%u bits in %zu byte slots: position %zu wrong!", Bits,
+                sizeof(Slot), i);
+            break;
+        }
+    }
+
+    /* Bulk pack from an unaligned start over existing data must match
+     * runtime sets exactly, including the untouched neighbours. */
+    const size_t first = 3;
+    const size_t count = COUNT - 7;
+    std::vector<Slot> b(a);
+    for (size_t i = 0; i < count; i++) {
+        P::set(a.data(), first + i, vals[COUNT - 1 - i]);
+    }
+
+    std::vector<V> reversed(vals.rbegin(), vals.rbegin() + count);
+    P::pack(b.data(), first, reversed.data(), count);
+    if (a != b) {
+        ERR("%u bits in %zu byte slots: pack differs from set!", Bits,
+            sizeof(Slot));
+    }
+
+    std::vector<V> out(count);
+    P::unpack(b.data(), first, out.data(), count);
+    if (out != reversed) {
+        ERR("%u bits in %zu byte slots: unpack differs!", Bits, sizeof(Slot));
+    }
+
+    /* Compile time positions inside the first period */
+    if (P::template get<P::period - 1>(b.data()) !=
+            P::get(b.data(), P::period - 1) ||
+        P::template get<1>(b.data()) != P::get(b.data(), 1)) {
+        ERR("%u bits in %zu byte slots: get<I> differs!", Bits, sizeof(Slot));
+    }
+
+    /* set<I> only changes its own position */
+    const V before = P::get(b.data(), 0);
+    const V after = P::get(b.data(), P::period);
+    P::template set<P::period - 1>(b.data(), V(P::mask));
+    if (P::get(b.data(), P::period - 1) != V(P::mask) ||
+        (P::period > 1 && P::get(b.data(), 0) != before) ||
+        P::get(b.data(), P::period) != after) {
+        ERR("%u bits in %zu byte slots: set<I> differs!", Bits, sizeof(Slot));
+    }
+
+    /* Runtime width dispatch over 64-bit values */
+    std::vector<uint64_t> wide(count);
+    std::vector<uint64_t> wideOut(count);
+    for (size_t i = 0; i < count; i++) {
+        wide[i] = reversed[i];
+    }
+
+    std::vector<Slot> c(P::slots_for(COUNT));
+    varint::packedPack<Slot>(Bits, c.data(), first, wide.data(), count);
+    varint::packedUnpack<Slot>(Bits, c.data(), first, wideOut.data(), count);
+    if (wideOut != wide) {
+        ERR("%u bits in %zu byte slots: runtime dispatch failed!", Bits,
+            sizeof(Slot));
+    }
+
+    return err;
+}
+
+template <typename Slot, unsigned... B>
+static int32_t checkAllWidths(std::integer_sequence<unsigned, B...>) {
+    return (checkWidth<B + 1, Slot>() + ...);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(23);
+
+    TEST("every width round trips in every slot size") {
+        const auto widths = std::make_integer_sequence<unsigned, 64>{};
+        err += checkAllWidths<uint8_t>(widths);
+        err += checkAllWidths<uint16_t>(widths);
+        err += checkAllWidths<uint32_t>(widths);
+        err += checkAllWidths<uint64_t>(widths);
+    }
+
+    TEST("layout matches varintPacked.h") {
+        static uint32_t c12[COUNT];
+        static uint32_t t12[COUNT];
+        static uint8_t c12Compact[COUNT * 2];
+        static uint8_t t12Compact[COUNT * 2];
+        static uint32_t c14[COUNT];
+        static uint32_t t14[COUNT];
+        for (uint32_t i = 0; i < COUNT; i++) {
+            const uint16_t v = ctestRandom() & 0xfff;
+            varintPacked12Set(c12, i, v);
+            varint::packed<12>::set(t12, i, v);
+            varintPackedCompact12Set(c12Compact, i, v);
+            varint::packed<12, uint8_t>::set(t12Compact, i, v);
+            varintPacked14Set(c14, i, v << 2 | 3);
+            varint::packed<14>::set(t14, i, v << 2 | 3);
+        }
+
+        if (memcmp(c12, t12, sizeof(c12)) ||
+            memcmp(c12Compact, t12Compact, sizeof(c12Compact)) ||
+            memcmp(c14, t14, sizeof(c14))) {
+            ERRR("Packed layout differs from varintPacked.h!");
+        }
+
+        uint16_t out[COUNT];
+        varint::packed<14>::unpack(c14, 0, out, COUNT);
+        for (uint32_t i = 0; i < COUNT; i++) {
+            if (out[i] != varintPacked14Get(c14, i)) {
+                ERR("Position %u unpacked wrong!", i);
+                break;
+            }
+        }
+    }
+
+    TEST("lower_bound matches varintPacked.h binary search") {
+        static uint32_t sorted[COUNT];
+        for (uint32_t i = 0; i < COUNT; i++) {
+            varintPacked12Set(sorted, i, (i * 3) & 0xfff);
+        }
+
+        for (uint16_t v = 0; v < 3010; v++) {
+            if (varint::packed<12>::lower_bound(sorted, COUNT, v) !=
+                varintPacked12BinarySearch(sorted, COUNT, v)) {
+                ERR("Search for %u differs!", v);
+                break;
+            }
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
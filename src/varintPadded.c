@@ -0,0 +1,21 @@
+#include "varintPadded.h"
+
+#include <stdlib.h>
+
+void *varintPaddedAlloc(size_t len) {
+    uint8_t *p = malloc(len + VARINT_PADDING);
+    if (p) {
+        memset(p + len, 0, VARINT_PADDING);
+    }
+
+    return p;
+}
+
+void *varintPaddedRealloc(void *p, size_t len) {
+    uint8_t *grown = realloc(p, len + VARINT_PADDING);
+    if (grown) {
+        memset(grown + len, 0, VARINT_PADDING);
+    }
+
+    return grown;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "varint.h"
+#include "varintSplit.h"
+#include "varintSplitFull.h"
+#include "varintSplitFull16.h"
+#include "varintSplitFullNoZero.h"
+
+#include <string.h>
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Padded buffer decoding
+ * ==================================================================== */
+/* Decoders normally switch on width so they never read a byte past the
+ * varint they decode, and on random widths that switch mispredicts more
+ * than anything else they do.  If a buffer guarantees VARINT_PADDING
+ * readable bytes after its last varint, every width can instead be read
+ * with one unaligned 8 byte load, then shifted and masked down to the
+ * width (byte swapped first for big endian layouts).
+ *
+ * The *Padded() decoders below require that contract and return the same
+ * results as their unpadded versions; bytes in the padding never affect a
+ * result.  varintPaddedAlloc() and varintPaddedRealloc() return buffers
+ * with the padding (zeroed) already in place.  varintPrefixGetQuick_()
+ * relies on the same contract. */
+
+#define VARINT_PADDING 8
+
+/* 'len' usable bytes followed by VARINT_PADDING zero bytes.  Release with
+ * free().  Realloc re-zeroes the padding after the new 'len'. */
+void *varintPaddedAlloc(size_t len);
+void *varintPaddedRealloc(void *p, size_t len);
+
+static inline uint64_t varintPaddedLoadLittle_(const void *p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+static inline uint64_t varintPaddedLoadBig_(const void *p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+/* varintExternalGet() */
+static inline uint64_t varintExternalGetPadded(const void *p,
+                                               varintWidth width) {
+    return varintPaddedLoadLittle_(p) & (UINT64_MAX >> (64 - 8 * width));
+}
+
+/* varintExternalBigEndianGet() */
+static inline uint64_t varintExternalBigEndianGetPadded(const void *p,
+                                                        varintWidth width) {
+    return varintPaddedLoadBig_(p) >> (64 - 8 * width);
+}
+
+/* varintTaggedGet64(): first bytes 250 to 255 are followed by 3 to 8 big
+ * endian bytes, all read by one load. */
+static inline varintWidth varintTaggedGet64Padded(const uint8_t *z,
+                                                  uint64_t *pResult) {
+    if (z[0] <= 240) {
+        *pResult = z[0];
+        return 1;
+    }
+
+    if (z[0] <= 248) {
+        *pResult = (z[0] - 241) * 256 + z[1] + 240;
+        return 2;
+    }
+
+    if (z[0] == 249) {
+        *pResult = 2288 + 256 * z[1] + z[2];
+        return 3;
+    }
+
+    const varintWidth len = z[0] - 246;
+    *pResult = varintPaddedLoadBig_(z + 1) >> (64 - 8 * (len - 1));
+    return len;
+}
+
+/* varintSplitFullGet_(): the three embedded levels share one big endian
+ * load (level n keeps 6 + 8n bits past its base), and the VAR level is
+ * one little endian load of its external width. */
+static inline varintWidth varintSplitFullGetPadded(const uint8_t *p,
+                                                   uint64_t *pResult) {
+    if (varintSplitFullEncoding2_(p) == VARINT_SPLIT_FULL_VAR) {
+        const varintWidth width = varintSplitFullEncodingWidthBytesExternal_(p);
+        *pResult =
+            varintExternalGetPadded(p + 1, width) + VARINT_SPLIT_FULL_MAX_22;
+        return 1 + width;
+    }
+
+    static const uint64_t base[3] = {0, VARINT_SPLIT_FULL_MAX_6,
+                                     VARINT_SPLIT_FULL_MAX_14};
+    const uint32_t level = p[0] >> 6;
+    const uint32_t bytes = level + 1;
+    *pResult = ((varintPaddedLoadBig_(p) >> (64 - 8 * bytes)) &
+                (UINT64_MAX >> (64 - 6 - 8 * level))) +
+               base[level];
+    return (varintWidth)bytes;
+}
+
+/* varintSplitGet_(): as varintSplitFullGetPadded() with two embedded
+ * levels.  The reserved 11 prefix returns 0 for both width and value, as
+ * varintSplitGet_() does. */
+static inline varintWidth varintSplitGetPadded(const uint8_t *p,
+                                               uint64_t *pResult) {
+    if (varintSplitEncoding2_(p) == VARINT_SPLIT_VAR) {
+        const varintWidth width = varintSplitEncodingWidthBytesExternal_(p);
+        *pResult = varintExternalGetPadded(p + 1, width) + VARINT_SPLIT_MAX_14;
+        return 1 + width;
+    }
+
+    const uint32_t level = p[0] >> 6;
+    if (level > 1) {
+        *pResult = 0;
+        return 0;
+    }
+
+    const uint32_t bytes = level + 1;
+    *pResult = ((varintPaddedLoadBig_(p) >> (64 - 8 * bytes)) &
+                (UINT64_MAX >> (64 - 6 - 8 * level))) +
+               (level ? VARINT_SPLIT_MAX_6 : 0);
+    return (varintWidth)bytes;
+}
+
+/* varintSplitFullNoZeroGet_(): as varintSplitFullGetPadded(), with every
+ * level based one higher since 0 has no encoding. */
+static inline varintWidth varintSplitFullNoZeroGetPadded(const uint8_t *p,
+                                                         uint64_t *pResult) {
+    if (varintSplitFullNoZeroEncoding2_(p) == VARINT_SPLIT_FULL_NO_ZERO_VAR) {
+        const varintWidth width =
+            varintSplitFullNoZeroEncodingWidthBytesExternal_(p);
+        *pResult = varintExternalGetPadded(p + 1, width) +
+                   VARINT_SPLIT_FULL_NO_ZERO_MAX_22;
+        return 1 + width;
+    }
+
+    static const uint64_t base[3] = {1, VARINT_SPLIT_FULL_NO_ZERO_MAX_6,
+                                     VARINT_SPLIT_FULL_NO_ZERO_MAX_14};
+    const uint32_t level = p[0] >> 6;
+    const uint32_t bytes = level + 1;
+    *pResult = ((varintPaddedLoadBig_(p) >> (64 - 8 * bytes)) &
+                (UINT64_MAX >> (64 - 6 - 8 * level))) +
+               base[level];
+    return (varintWidth)bytes;
+}
+
+/* varintSplitFull16Get_(): embedded level n is n + 2 bytes keeping
+ * 14 + 8n bits past its base. */
+static inline varintWidth varintSplitFull16GetPadded(const uint8_t *p,
+                                                     uint64_t *pResult) {
+    if (varintSplitFull16Encoding2_(p) == VARINT_SPLIT_FULL_16_VAR) {
+        const varintWidth width =
+            varintSplitFull16EncodingWidthBytesExternal_(p);
+        *pResult = varintExternalGetPadded(p + 1, width) +
+                   VARINT_SPLIT_FULL_16_MAX_30;
+        return 1 + width;
+    }
+
+    static const uint64_t base[3] = {0, VARINT_SPLIT_FULL_16_MAX_14,
+                                     VARINT_SPLIT_FULL_16_MAX_22};
+    const uint32_t level = p[0] >> 6;
+    const uint32_t bytes = level + 2;
+    *pResult = ((varintPaddedLoadBig_(p) >> (64 - 8 * bytes)) &
+                (UINT64_MAX >> (64 - 14 - 8 * level))) +
+               base[level];
+    return (varintWidth)bytes;
+}
+
+__END_DECLS
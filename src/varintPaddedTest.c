@@ -0,0 +1,125 @@
+#include "varintPadded.h"
+#include "varintExternal.h"
+#include "varintExternalBigEndian.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 200000
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(47);
+
+    /* Each varint is copied to the end of an exactly sized padded buffer,
+     * so a padded decoder reading past VARINT_PADDING trips ASan. */
+    TEST("padded decoders match unpadded decoders") {
+        for (size_t i = 0; i < COUNT; i++) {
+            uint64_t v = ctestRandomWidth();
+            if (i < 64) {
+                /* Every bit length, including the largest values */
+                v = i ? UINT64_MAX >> i : UINT64_MAX;
+            }
+
+            uint8_t z[9];
+            uint64_t got = 0;
+
+            varintWidth width = varintExternalPut(z, v);
+            uint8_t *p = varintPaddedAlloc(width);
+            memcpy(p, z, width);
+            if (varintExternalGetPadded(p, width) != v) {
+                ERR("External %" PRIu64 " failed!", v);
+            }
+
+            width = varintExternalBigEndianPut(z, v);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            if (varintExternalBigEndianGetPadded(p, width) != v) {
+                ERR("External big endian %" PRIu64 " failed!", v);
+            }
+
+            width = varintTaggedPut64(z, v);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            if (varintTaggedGet64Padded(p, &got) != width || got != v) {
+                ERR("Tagged %" PRIu64 " failed!", v);
+            }
+
+            varintSplitFullPut_(z, width, v);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            varintWidth expectWidth;
+            uint64_t expect;
+            varintSplitFullGet_(p, expectWidth, expect);
+            if (varintSplitFullGetPadded(p, &got) != width ||
+                expectWidth != width || got != v || expect != v) {
+                ERR("SplitFull %" PRIu64 " failed!", v);
+            }
+
+            varintSplitPut_(z, width, v);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            varintSplitGet_(p, expectWidth, expect);
+            if (varintSplitGetPadded(p, &got) != width ||
+                expectWidth != width || got != v || expect != v) {
+                ERR("Split %" PRIu64 " failed!", v);
+            }
+
+            /* SplitFullNoZero has no encoding for 0 */
+            const uint64_t nonZero = v ? v : 1;
+            varintSplitFullNoZeroPut_(z, width, nonZero);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            varintSplitFullNoZeroGet_(p, expectWidth, expect);
+            if (varintSplitFullNoZeroGetPadded(p, &got) != width ||
+                expectWidth != width || got != nonZero || expect != nonZero) {
+                ERR("SplitFullNoZero %" PRIu64 " failed!", nonZero);
+            }
+
+            varintSplitFull16Put_(z, width, v);
+            p = varintPaddedRealloc(p, width);
+            memcpy(p, z, width);
+            varintSplitFull16Get_(p, expectWidth, expect);
+            if (varintSplitFull16GetPadded(p, &got) != width ||
+                expectWidth != width || got != v || expect != v) {
+                ERR("SplitFull16 %" PRIu64 " failed!", v);
+            }
+
+            free(p);
+        }
+    }
+
+    TEST("padding bytes never affect results") {
+        uint8_t *p = varintPaddedAlloc(9);
+        for (size_t i = 0; i < COUNT / 10; i++) {
+            const uint64_t v = ctestRandomWidth();
+            const varintWidth width = varintTaggedPut64(p, v);
+            memset(p + width, 0xff, 9 + VARINT_PADDING - width);
+            uint64_t got = 0;
+            varintTaggedGet64Padded(p, &got);
+
+            varintWidth splitWidth;
+            varintSplitFullPut_(p, splitWidth, v);
+            memset(p + splitWidth, 0xff, 9 + VARINT_PADDING - splitWidth);
+            uint64_t gotSplit = 0;
+            varintSplitFullGetPadded(p, &gotSplit);
+
+            varintSplitFull16Put_(p, splitWidth, v);
+            memset(p + splitWidth, 0xff, 9 + VARINT_PADDING - splitWidth);
+            uint64_t gotSplit16 = 0;
+            varintSplitFull16GetPadded(p, &gotSplit16);
+            if (got != v || gotSplit != v || gotSplit16 != v) {
+                ERR("Padding changed %" PRIu64 "!", v);
+            }
+        }
+
+        free(p);
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,340 @@
+#define _GNU_SOURCE
+#include "varintParallel.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintExternal.h"
+#include "varintScan.h"
+#include "varintSplitFull.h"
+#include "varintTagged.h"
+#include "varintThreads.h"
+
+/* ====================================================================
+ * Chained decoding
+ * ==================================================================== */
+typedef struct varintParallelDecode_ {
+    const uint8_t *src;
+    size_t start;
+    size_t end;
+    varintScanFormat format;
+    size_t count;  /* pass one: values in [start, end) */
+    bool valid;    /* pass one: range is whole well-formed varints */
+    uint64_t *out; /* pass two: where this range's values go */
+} varintParallelDecode_;
+
+static void *varintParallelCount_(void *arg) {
+    varintParallelDecode_ *d = arg;
+    const size_t len = d->end - d->start;
+    d->valid = varintScanPrefix(d->format, d->src + d->start, len,
+                                &d->count) == len;
+    return NULL;
+}
+
+static void *varintParallelDecodeRange_(void *arg) {
+    varintParallelDecode_ *d = arg;
+    const uint8_t *src = d->src + d->start;
+    const uint8_t *const end = d->src + d->end;
+    uint64_t *out = d->out;
+    if (d->format == VARINT_SCAN_CHAINED) {
+        while (src < end) {
+            src += varintChainedGetVarint(src, out++);
+        }
+    } else {
+        while (src < end) {
+            src += varintChainedSimpleDecode64(src, out++);
+        }
+    }
+
+    return NULL;
+}
+
+/* First value boundary at or after 'from': just past the first byte with
+ * its high bit clear at or after 'from - 1'.  Returns 'limit' if no such
+ * byte exists before it. */
+static size_t varintParallelResync_(const uint8_t *src, size_t from,
+                                    size_t limit) {
+    for (size_t i = from - 1; i < limit; i++) {
+        if (!(src[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+
+    return limit;
+}
+
+static bool varintParallelDecodeChained_(varintScanFormat format,
+                                         const uint8_t *src, size_t len,
+                                         uint64_t *out, size_t outCapacity,
+                                         uint32_t threads, size_t *count) {
+    threads = varintThreadsFor_(threads, len, VARINT_PARALLEL_MIN_BYTES);
+
+    varintParallelDecode_ stackRanges[64];
+    varintParallelDecode_ *ranges =
+        threads <= 64 ? stackRanges : calloc(threads, sizeof(*ranges));
+    if (!ranges) {
+        return false;
+    }
+
+    /* Range starts only move forward, so each resync is bounded by the
+     * stream end; a range with no boundary in it ends up empty. */
+    size_t prevStart = 0;
+    for (uint32_t t = 0; t < threads; t++) {
+        varintParallelDecode_ *d = &ranges[t];
+        const size_t split = (size_t)((uint64_t)len * t / threads);
+        d->src = src;
+        d->format = format;
+        d->start = t ? varintParallelResync_(src, split, len) : 0;
+        if (d->start < prevStart) {
+            d->start = prevStart;
+        }
+
+        prevStart = d->start;
+        if (t) {
+            ranges[t - 1].end = d->start;
+        }
+    }
+
+    ranges[threads - 1].end = len;
+
+    bool ok = varintThreadsRun_(varintParallelCount_, ranges,
+                                sizeof(*ranges), threads);
+
+    /* Exclusive prefix sum places each range's output */
+    size_t total = 0;
+    for (uint32_t t = 0; ok && t < threads; t++) {
+        ok = ranges[t].valid;
+        ranges[t].out = out + total;
+        total += ranges[t].count;
+    }
+
+    ok = ok && total <= outCapacity &&
+         varintThreadsRun_(varintParallelDecodeRange_, ranges,
+                           sizeof(*ranges), threads);
+
+    if (ranges != stackRanges) {
+        free(ranges);
+    }
+
+    if (ok && count) {
+        *count = total;
+    }
+
+    return ok;
+}
+
+bool varintChainedDecodeParallel(const uint8_t *src, size_t len,
+                                 uint64_t *out, size_t outCapacity,
+                                 uint32_t threads, size_t *count) {
+    return varintParallelDecodeChained_(VARINT_SCAN_CHAINED, src, len, out,
+                                        outCapacity, threads, count);
+}
+
+bool varintChainedSimpleDecodeParallel(const uint8_t *src, size_t len,
+                                       uint64_t *out, size_t outCapacity,
+                                       uint32_t threads, size_t *count) {
+    return varintParallelDecodeChained_(VARINT_SCAN_CHAINED_SIMPLE, src, len,
+                                        out, outCapacity, threads, count);
+}
+
+/* ====================================================================
+ * Encoding
+ * ==================================================================== */
+typedef struct varintParallelEncode_ {
+    const varintParallelEncodeConfig *config;
+    const uint64_t *values;
+    size_t first;    /* index of values[0] in the whole input */
+    size_t count;
+    size_t len;      /* pass one: encoded bytes of this chunk */
+    uint8_t *dst;    /* pass two: where this chunk's bytes go */
+    uint64_t offset; /* pass two: output offset of 'dst' */
+} varintParallelEncode_;
+
+static void *varintParallelSize_(void *arg) {
+    varintParallelEncode_ *e = arg;
+    const uint64_t *values = e->values;
+    size_t len = 0;
+    switch (e->config->format) {
+    case VARINT_PARALLEL_TAGGED:
+        for (size_t i = 0; i < e->count; i++) {
+            len += varintTaggedLenQuick(values[i]);
+        }
+        break;
+    case VARINT_PARALLEL_CHAINED_SIMPLE:
+        for (size_t i = 0; i < e->count; i++) {
+            len += varintChainedSimpleLength(values[i]);
+        }
+        break;
+    case VARINT_PARALLEL_SPLIT_FULL:
+        for (size_t i = 0; i < e->count; i++) {
+            varintWidth width;
+            varintSplitFullLength_(width, values[i]);
+            len += width;
+        }
+        break;
+    case VARINT_PARALLEL_EXTERNAL: {
+        uint8_t *widths = e->config->widths + e->first;
+        for (size_t i = 0; i < e->count; i++) {
+            varintWidth width;
+            varintExternalUnsignedEncoding(values[i], width);
+            widths[i] = width;
+            len += width;
+        }
+        break;
+    }
+    }
+
+    e->len = len;
+    return NULL;
+}
+
+static void *varintParallelWrite_(void *arg) {
+    varintParallelEncode_ *e = arg;
+    const varintParallelEncodeConfig *config = e->config;
+    const uint64_t *values = e->values;
+    uint8_t *const start = e->dst;
+    uint8_t *dst = start;
+
+    /* Values of this chunk whose offsets are checkpoints */
+    const size_t interval = config->checkpointInterval;
+    size_t nextCheckpoint = SIZE_MAX;
+    if (interval) {
+        const size_t firstCheckpoint =
+            (e->first + interval - 1) / interval * interval;
+        nextCheckpoint = firstCheckpoint - e->first;
+    }
+
+    for (size_t i = 0; i < e->count; i++) {
+        if (i == nextCheckpoint) {
+            config->checkpoints[(e->first + i) / interval] =
+                e->offset + (uint64_t)(dst - start);
+            nextCheckpoint += interval;
+        }
+
+        switch (config->format) {
+        case VARINT_PARALLEL_TAGGED:
+            dst += varintTaggedPut64(dst, values[i]);
+            break;
+        case VARINT_PARALLEL_CHAINED_SIMPLE:
+            dst += varintChainedSimpleEncode64(dst, values[i]);
+            break;
+        case VARINT_PARALLEL_SPLIT_FULL: {
+            varintWidth width;
+            varintSplitFullPut_(dst, width, values[i]);
+            dst += width;
+            break;
+        }
+        case VARINT_PARALLEL_EXTERNAL: {
+            const varintWidth width = config->widths[e->first + i];
+            varintExternalPutFixedWidth(dst, values[i], width);
+            dst += width;
+            break;
+        }
+        }
+    }
+
+    return NULL;
+}
+
+/* Pass one over 'count' values split into chunks.  Returns the chunks
+ * (caller frees if not 'stackChunks') with their lengths filled in, or
+ * NULL if threads can't be started. */
+static varintParallelEncode_ *
+varintParallelSizeChunks_(const varintParallelEncodeConfig *config,
+                          const uint64_t *values, size_t count,
+                          varintParallelEncode_ *stackChunks,
+                          uint32_t *chunkCount, size_t *total) {
+    const uint32_t threads =
+        varintThreadsFor_(config->threads, count * sizeof(*values),
+                          VARINT_PARALLEL_MIN_BYTES);
+
+    varintParallelEncode_ *chunks =
+        threads <= 64 ? stackChunks : calloc(threads, sizeof(*chunks));
+    if (!chunks) {
+        return NULL;
+    }
+
+    for (uint32_t t = 0; t < threads; t++) {
+        varintParallelEncode_ *e = &chunks[t];
+        const size_t first = (size_t)((uint64_t)count * t / threads);
+        const size_t last = (size_t)((uint64_t)count * (t + 1) / threads);
+        e->config = config;
+        e->values = values + first;
+        e->first = first;
+        e->count = last - first;
+    }
+
+    if (!varintThreadsRun_(varintParallelSize_, chunks, sizeof(*chunks),
+                           threads)) {
+        if (chunks != stackChunks) {
+            free(chunks);
+        }
+
+        return NULL;
+    }
+
+    size_t sum = 0;
+    for (uint32_t t = 0; t < threads; t++) {
+        sum += chunks[t].len;
+    }
+
+    *chunkCount = threads;
+    *total = sum;
+    return chunks;
+}
+
+bool varintParallelEncodedLength(const varintParallelEncodeConfig *config,
+                                 const uint64_t *values, size_t count,
+                                 size_t *encodedLen) {
+    varintParallelEncode_ stackChunks[64];
+    uint32_t chunkCount = 0;
+    size_t total = 0;
+    varintParallelEncode_ *chunks = varintParallelSizeChunks_(
+        config, values, count, stackChunks, &chunkCount, &total);
+    if (!chunks) {
+        return false;
+    }
+
+    if (chunks != stackChunks) {
+        free(chunks);
+    }
+
+    if (encodedLen) {
+        *encodedLen = total;
+    }
+
+    return true;
+}
+
+bool varintParallelEncode(const varintParallelEncodeConfig *config,
+                          const uint64_t *values, size_t count, uint8_t *dst,
+                          size_t dstCapacity, size_t *encodedLen) {
+    varintParallelEncode_ stackChunks[64];
+    uint32_t chunkCount = 0;
+    size_t total = 0;
+    varintParallelEncode_ *chunks = varintParallelSizeChunks_(
+        config, values, count, stackChunks, &chunkCount, &total);
+    if (!chunks) {
+        return false;
+    }
+
+    if (encodedLen) {
+        *encodedLen = total;
+    }
+
+    /* Exclusive prefix sum places each chunk's output */
+    uint64_t offset = 0;
+    for (uint32_t t = 0; t < chunkCount; t++) {
+        chunks[t].dst = dst + offset;
+        chunks[t].offset = offset;
+        offset += chunks[t].len;
+    }
+
+    const bool ok = total <= dstCapacity &&
+                    varintThreadsRun_(varintParallelWrite_, chunks,
+                                      sizeof(*chunks), chunkCount);
+
+    if (chunks != stackChunks) {
+        free(chunks);
+    }
+
+    return ok;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Multithreaded bulk decoding
+ * ==================================================================== */
+/* Chained and ChainedSimple streams self-synchronize: every byte with its
+ * high bit clear ends a value (a terminator, or a 9th byte that happens
+ * to have a clear high bit), so the byte after any such byte starts a
+ * value.  A 9th byte with its high bit set ends a value too, but a value
+ * boundary after it is only found by decoding from an earlier boundary.
+ *
+ * The stream is split into one range per thread at arbitrary offsets and
+ * each range start moves forward to just after the next clear byte.  Each
+ * thread counts and validates its range (varintScanPrefix()), an
+ * exclusive prefix sum of the counts gives each range's output position,
+ * then each thread decodes its range straight into place.
+ *
+ * 'threads' of 0 uses one thread per online CPU.  Small inputs use fewer
+ * threads so each gets at least VARINT_PARALLEL_MIN_BYTES. */
+
+#define VARINT_PARALLEL_MIN_BYTES (64 * 1024)
+
+/* Decode all 'len' bytes of 'src' into 'out' (room for 'outCapacity'
+ * values) and store the number of values in 'count'.  Returns false if
+ * 'src' isn't a whole sequence of well-formed varints, holds more than
+ * 'outCapacity' values, or threads can't be started. */
+bool varintChainedDecodeParallel(const uint8_t *src, size_t len,
+                                 uint64_t *out, size_t outCapacity,
+                                 uint32_t threads, size_t *count);
+bool varintChainedSimpleDecodeParallel(const uint8_t *src, size_t len,
+                                       uint64_t *out, size_t outCapacity,
+                                       uint32_t threads, size_t *count);
+
+/* ====================================================================
+ * Multithreaded bulk encoding
+ * ==================================================================== */
+/* Where an encoded value lands depends on the widths of every value before
+ * it, so encoding runs in two passes over per-thread chunks of 'values':
+ * pass one sums each chunk's encoded length, an exclusive prefix sum of
+ * the lengths gives each chunk's output offset, and pass two encodes each
+ * chunk straight into its final position.  Output is byte-identical to
+ * encoding the values one after another on one thread.
+ *
+ * VARINT_PARALLEL_EXTERNAL writes External varints (varintExternalPut())
+ * back to back with their widths kept outside the payload: one
+ * varintWidth byte per value goes to 'widths' (filled during pass one).
+ *
+ * Pass two can also record a checkpoint index: the output offset of every
+ * 'checkpointInterval'th value, so a reader can start decoding (or hand
+ * ranges to other threads) at any checkpoint without scanning from the
+ * start. */
+
+typedef enum varintParallelFormat {
+    VARINT_PARALLEL_TAGGED = 0,     /* varintTaggedPut64() */
+    VARINT_PARALLEL_CHAINED_SIMPLE, /* varintChainedSimpleEncode64() */
+    VARINT_PARALLEL_SPLIT_FULL,     /* varintSplitFullPut_() */
+    VARINT_PARALLEL_EXTERNAL,       /* varintExternalPut() + 'widths' */
+} varintParallelFormat;
+
+typedef struct varintParallelEncodeConfig {
+    varintParallelFormat format;
+    uint32_t threads; /* 0: one per online CPU */
+
+    uint8_t *widths; /* EXTERNAL only: room for one byte per value */
+
+    /* If 'checkpointInterval' > 0, 'checkpoints[k]' receives the output
+     * offset of value k * checkpointInterval ('checkpoints' must hold
+     * ceil(count / checkpointInterval) entries). */
+    size_t checkpointInterval;
+    uint64_t *checkpoints;
+} varintParallelEncodeConfig;
+
+/* Encode 'count' 'values' into 'dst' (room for 'dstCapacity' bytes).
+ * 'encodedLen' (if not NULL) receives the encoded length once pass one
+ * completes, so a failure due to a short 'dst' reports the size needed.
+ * Returns false if 'dst' is too small or threads can't be started.
+ * A 'dst' of count * 9 bytes is always large enough. */
+bool varintParallelEncode(const varintParallelEncodeConfig *config,
+                          const uint64_t *values, size_t count, uint8_t *dst,
+                          size_t dstCapacity, size_t *encodedLen);
+
+/* Pass one alone: the exact number of bytes varintParallelEncode() writes
+ * for 'values' (fills 'config->widths' for EXTERNAL).  Returns false only
+ * if threads can't be started. */
+bool varintParallelEncodedLength(const varintParallelEncodeConfig *config,
+                                 const uint64_t *values, size_t count,
+                                 size_t *encodedLen);
+
+__END_DECLS
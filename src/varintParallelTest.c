@@ -0,0 +1,211 @@
+#include "varintParallel.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintExternal.h"
+#include "varintSplitFull.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 1000000
+
+/* Mostly short values, with long runs of 9 byte values whose last byte
+ * has its high bit set (the case resynchronization must not trust). */
+static uint64_t randomValue(size_t i) {
+    /* Wide last value so truncating the stream splits it */
+    if ((i / 1000) % 7 == 3 || i == COUNT - 1) {
+        return (1ULL << 63) | 0x80 | ctestRandom();
+    }
+
+    return ctestRandomWidth();
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(37);
+
+    uint64_t *vals = malloc(COUNT * sizeof(*vals));
+    uint64_t *out = malloc(COUNT * sizeof(*out));
+    uint8_t *chained = malloc(COUNT * 9);
+    uint8_t *simple = malloc(COUNT * 9);
+    size_t chainedLen = 0;
+    size_t simpleLen = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        vals[i] = randomValue(i);
+        chainedLen += varintChainedPutVarint(chained + chainedLen, vals[i]);
+        simpleLen += varintChainedSimpleEncode64(simple + simpleLen, vals[i]);
+    }
+
+    TEST("parallel decode matches for any thread count") {
+        const uint32_t threadCounts[] = {0, 1, 2, 3, 7, 16, 100};
+        for (size_t t = 0; t < sizeof(threadCounts) / sizeof(*threadCounts);
+             t++) {
+            size_t count = 0;
+            memset(out, 0, COUNT * sizeof(*out));
+            if (!varintChainedDecodeParallel(chained, chainedLen, out, COUNT,
+                                             threadCounts[t], &count) ||
+                count != COUNT || memcmp(out, vals, COUNT * sizeof(*out))) {
+                ERR("Chained with %u threads failed!", threadCounts[t]);
+            }
+
+            memset(out, 0, COUNT * sizeof(*out));
+            if (!varintChainedSimpleDecodeParallel(simple, simpleLen, out,
+                                                   COUNT, threadCounts[t],
+                                                   &count) ||
+                count != COUNT || memcmp(out, vals, COUNT * sizeof(*out))) {
+                ERR("ChainedSimple with %u threads failed!",
+                    threadCounts[t]);
+            }
+        }
+    }
+
+    TEST("all 9 byte values leave some ranges empty") {
+        const size_t n = VARINT_PARALLEL_MIN_BYTES;
+        uint8_t *wide = malloc(n * 9);
+        size_t len = 0;
+        for (size_t i = 0; i < n; i++) {
+            vals[i] = UINT64_MAX - i;
+            len += varintChainedPutVarint(wide + len, vals[i]);
+        }
+
+        size_t count = 0;
+        if (!varintChainedDecodeParallel(wide, len, out, n, 8, &count) ||
+            count != n || memcmp(out, vals, n * sizeof(*out))) {
+            ERRR("Stream without terminators decoded wrong!");
+        }
+
+        free(wide);
+    }
+
+    TEST("malformed input and small output are rejected") {
+        size_t count = 0;
+        if (varintChainedDecodeParallel(chained, chainedLen - 1, out, COUNT,
+                                        4, &count)) {
+            ERRR("Truncated stream accepted!");
+        }
+
+        if (varintChainedSimpleDecodeParallel(simple, simpleLen, out,
+                                              COUNT - 1, 4, &count)) {
+            ERRR("Undersized output accepted!");
+        }
+
+        if (!varintChainedDecodeParallel(chained, 0, out, 0, 4, &count) ||
+            count) {
+            ERRR("Empty stream failed!");
+        }
+    }
+
+    TEST("parallel encode matches serial encode") {
+        uint8_t *serial = malloc(COUNT * 9);
+        uint8_t *parallel = malloc(COUNT * 9);
+        uint8_t *widths = malloc(COUNT);
+        uint8_t *serialWidths = malloc(COUNT);
+        const size_t interval = 1000;
+        uint64_t *checkpoints = malloc((COUNT / interval) * sizeof(uint64_t));
+        uint64_t *serialCheckpoints =
+            malloc((COUNT / interval) * sizeof(uint64_t));
+        for (size_t i = 0; i < COUNT; i++) {
+            vals[i] = randomValue(i);
+        }
+
+        const varintParallelFormat formats[] = {
+            VARINT_PARALLEL_TAGGED, VARINT_PARALLEL_CHAINED_SIMPLE,
+            VARINT_PARALLEL_SPLIT_FULL, VARINT_PARALLEL_EXTERNAL};
+        for (size_t f = 0; f < 4; f++) {
+            size_t serialLen = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                if (i % interval == 0) {
+                    serialCheckpoints[i / interval] = serialLen;
+                }
+
+                uint8_t *dst = serial + serialLen;
+                varintWidth width = 0;
+                switch (formats[f]) {
+                case VARINT_PARALLEL_TAGGED:
+                    width = varintTaggedPut64(dst, vals[i]);
+                    break;
+                case VARINT_PARALLEL_CHAINED_SIMPLE:
+                    width = varintChainedSimpleEncode64(dst, vals[i]);
+                    break;
+                case VARINT_PARALLEL_SPLIT_FULL:
+                    varintSplitFullPut_(dst, width, vals[i]);
+                    break;
+                case VARINT_PARALLEL_EXTERNAL:
+                    width = varintExternalPut(dst, vals[i]);
+                    serialWidths[i] = width;
+                    break;
+                }
+
+                serialLen += width;
+            }
+
+            const uint32_t threadCounts[] = {0, 1, 3, 16, 100};
+            for (size_t t = 0; t < 5; t++) {
+                varintParallelEncodeConfig config = {
+                    .format = formats[f],
+                    .threads = threadCounts[t],
+                    .widths = widths,
+                    .checkpointInterval = interval,
+                    .checkpoints = checkpoints};
+                size_t len = 0;
+                memset(parallel, 0, COUNT * 9);
+                if (!varintParallelEncode(&config, vals, COUNT, parallel,
+                                          COUNT * 9, &len) ||
+                    len != serialLen || memcmp(parallel, serial, len) ||
+                    memcmp(checkpoints, serialCheckpoints,
+                           (COUNT / interval) * sizeof(uint64_t)) ||
+                    (formats[f] == VARINT_PARALLEL_EXTERNAL &&
+                     memcmp(widths, serialWidths, COUNT))) {
+                    ERR("Format %zu with %u threads failed!", f,
+                        threadCounts[t]);
+                }
+
+                size_t needed = 0;
+                if (!varintParallelEncodedLength(&config, vals, COUNT,
+                                                 &needed) ||
+                    needed != serialLen) {
+                    ERR("Format %zu length with %u threads failed!", f,
+                        threadCounts[t]);
+                }
+
+                if (varintParallelEncode(&config, vals, COUNT, parallel,
+                                         serialLen - 1, &needed) ||
+                    needed != serialLen) {
+                    ERR("Format %zu short output accepted!", f);
+                }
+            }
+        }
+
+        /* Round trip through the parallel decoder */
+        varintParallelEncodeConfig config = {
+            .format = VARINT_PARALLEL_CHAINED_SIMPLE};
+        size_t len = 0;
+        size_t count = 0;
+        if (!varintParallelEncode(&config, vals, COUNT, parallel, COUNT * 9,
+                                  &len) ||
+            !varintChainedSimpleDecodeParallel(parallel, len, out, COUNT, 0,
+                                               &count) ||
+            count != COUNT || memcmp(out, vals, COUNT * sizeof(*out))) {
+            ERRR("Parallel round trip failed!");
+        }
+
+        free(serial);
+        free(parallel);
+        free(widths);
+        free(serialWidths);
+        free(checkpoints);
+        free(serialCheckpoints);
+    }
+
+    free(vals);
+    free(out);
+    free(chained);
+    free(simple);
+
+    TEST_FINAL_RESULT;
+}
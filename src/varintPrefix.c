@@ -0,0 +1,104 @@
+#include "varintPrefix.h"
+
+/* ====================================================================
+ * Encoding
+ * ==================================================================== */
+varintWidth varintPrefixLen(uint64_t v) {
+    /* Significant bits, 7 per byte, and anything over 56 takes 9 */
+    const uint32_t bits = 64 - __builtin_clzll(v | 1);
+    return bits > 56 ? 9 : (varintWidth)((bits + 6) / 7);
+}
+
+static inline void varintPrefixStore64_(uint8_t *p, uint64_t w) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    memcpy(p, &w, sizeof(w));
+}
+
+/* Little endian word of an n byte (n up to 8) varint: the value shifted
+ * up past n - 1 one bits and a zero bit. */
+#define varintPrefixWord_(v, n) (((v) << (n)) | ((1ULL << ((n)-1)) - 1))
+
+varintWidth varintPrefixPut(uint8_t *p, uint64_t v) {
+    const varintWidth n = varintPrefixLen(v);
+    if (n == 9) {
+        p[0] = 0xff;
+        varintPrefixStore64_(p + 1, v);
+        return n;
+    }
+
+    const uint64_t w = varintPrefixWord_(v, n);
+    for (uint32_t i = 0; i < n; i++) {
+        p[i] = (uint8_t)(w >> (8 * i));
+    }
+
+    return n;
+}
+
+size_t varintPrefixEncodeArray(uint8_t *p, const uint64_t *vals,
+                               size_t count) {
+    uint8_t *const start = p;
+    size_t i = 0;
+
+    /* Values with at least 7 values after them are written with a full 8
+     * byte store: the up to 7 bytes past their end are overwritten by the
+     * following values, which take at least a byte each. */
+    for (; i + 7 < count; i++) {
+        const varintWidth n = varintPrefixLen(vals[i]);
+        if (n == 9) {
+            p[0] = 0xff;
+            varintPrefixStore64_(p + 1, vals[i]);
+        } else {
+            varintPrefixStore64_(p, varintPrefixWord_(vals[i], n));
+        }
+
+        p += n;
+    }
+
+    for (; i < count; i++) {
+        p += varintPrefixPut(p, vals[i]);
+    }
+
+    return (size_t)(p - start);
+}
+
+/* ====================================================================
+ * Decoding
+ * ==================================================================== */
+varintWidth varintPrefixGetLen(const uint8_t *p) {
+    return varintPrefixGetLenQuick_(p);
+}
+
+varintWidth varintPrefixGet(const uint8_t *p, uint64_t *v) {
+    const varintWidth n = varintPrefixGetLenQuick_(p);
+    if (n == 9) {
+        *v = varintPrefixLoad64_(p + 1);
+        return n;
+    }
+
+    /* Read only this varint's bytes */
+    uint64_t w = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        w |= (uint64_t)p[i] << (8 * i);
+    }
+
+    *v = w >> n;
+    return n;
+}
+
+size_t varintPrefixDecodeArray(const uint8_t *p, size_t len, uint64_t *vals,
+                               size_t count) {
+    const uint8_t *const start = p;
+    const uint8_t *const end = p + len;
+    size_t i = 0;
+    while (i < count && end - p >= 9) {
+        p += varintPrefixGetQuick_(p, &vals[i++]);
+    }
+
+    while (i < count) {
+        p += varintPrefixGet(p, &vals[i++]);
+    }
+
+    return (size_t)(p - start);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "varint.h"
+
+#include <string.h>
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Prefix varints
+ * ==================================================================== */
+/* varint model Prefix Container:
+ *   Type encoded inside: unary length in the low bits of the first byte
+ *   Size: 1 byte to 9 bytes
+ *   Layout: little endian
+ *   Meaning: a first byte with n - 1 low one bits then a zero bit starts
+ *            an n byte varint (n is 1 to 8) whose value is its n bytes
+ *            read as a little endian integer shifted down by n.
+ *            A first byte of 0xff is followed by a full 8 byte value.
+ *   Pro: length is one tzcnt of the inverted first byte; value is one
+ *        unaligned load, shift, and mask with no data dependent branches.
+ *   Con: one byte only stores values up to 127; values above 2^56 - 1
+ *        need 9 bytes. */
+
+/* n byte Prefix varints hold 7 * n bits (for n up to 8) */
+#define VARINT_PREFIX_MAX_1 127ULL
+#define VARINT_PREFIX_MAX_2 16383ULL
+#define VARINT_PREFIX_MAX_3 2097151ULL
+#define VARINT_PREFIX_MAX_4 268435455ULL
+#define VARINT_PREFIX_MAX_5 34359738367ULL
+#define VARINT_PREFIX_MAX_6 4398046511103ULL
+#define VARINT_PREFIX_MAX_7 562949953421311ULL
+#define VARINT_PREFIX_MAX_8 72057594037927935ULL /* 2^56 - 1 */
+#define VARINT_PREFIX_MAX_9 UINT64_MAX
+
+varintWidth varintPrefixLen(uint64_t v);
+varintWidth varintPrefixPut(uint8_t *p, uint64_t v);
+varintWidth varintPrefixGetLen(const uint8_t *p);
+varintWidth varintPrefixGet(const uint8_t *p, uint64_t *v);
+
+/* Bulk encode of 'count' values back to back; returns bytes written.
+ * Writes only the encoded bytes. */
+size_t varintPrefixEncodeArray(uint8_t *p, const uint64_t *vals,
+                               size_t count);
+
+/* Bulk decode of 'count' values; returns bytes read.  'len' is how many
+ * bytes of 'p' are readable (at least the encoded length): values more
+ * than 9 bytes from the end decode with single wide loads. */
+size_t varintPrefixDecodeArray(const uint8_t *p, size_t len, uint64_t *vals,
+                               size_t count);
+
+/* ====================================================================
+ * Single load decoding
+ * ==================================================================== */
+/* For latency critical point lookups.  'p' must have at least 9 readable
+ * bytes, which holds for every varint in a buffer with VARINT_PADDING
+ * (varintPadded.h) bytes of slack after its last varint. */
+#define varintPrefixGetLenQuick_(p)                                            \
+    ((varintWidth)(__builtin_ctz(~(uint32_t)(p)[0]) + 1))
+
+static inline uint64_t varintPrefixLoad64_(const uint8_t *p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+static inline varintWidth varintPrefixGetQuick_(const uint8_t *p,
+                                                uint64_t *v) {
+    const uint32_t n = varintPrefixGetLenQuick_(p);
+    const uint64_t word = varintPrefixLoad64_(p);
+    const uint64_t full = varintPrefixLoad64_(p + 1);
+
+    /* n of 9 shifts by 9 and keeps 63 bits, but then selects 'full' */
+    const uint64_t small = (word >> n) & (UINT64_MAX >> (64 - 7 * n));
+    *v = n == 9 ? full : small;
+    return (varintWidth)n;
+}
+
+__END_DECLS
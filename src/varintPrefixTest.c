@@ -0,0 +1,129 @@
+#include "varintPrefix.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 100000
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(43);
+
+    TEST("layout is pinned") {
+        const struct {
+            uint64_t v;
+            uint8_t len;
+            uint8_t bytes[9];
+        } pinned[] = {
+            {0, 1, {0x00}},
+            {127, 1, {0xfe}},
+            {128, 2, {0x01, 0x02}},
+            {VARINT_PREFIX_MAX_2, 2, {0xfd, 0xff}},
+            {VARINT_PREFIX_MAX_2 + 1, 3, {0x03, 0x00, 0x02}},
+            {VARINT_PREFIX_MAX_8, 8,
+             {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}},
+            {VARINT_PREFIX_MAX_8 + 1, 9,
+             {0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01}},
+            {UINT64_MAX, 9,
+             {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}},
+        };
+
+        for (size_t i = 0; i < sizeof(pinned) / sizeof(*pinned); i++) {
+            uint8_t buf[32] = {0};
+            const varintWidth len = varintPrefixPut(buf, pinned[i].v);
+            if (len != pinned[i].len || varintPrefixLen(pinned[i].v) != len ||
+                memcmp(buf, pinned[i].bytes, len)) {
+                ERR("Value %" PRIu64 " encoded wrong!", pinned[i].v);
+            }
+        }
+    }
+
+    TEST("every width boundary round trips through every decoder") {
+        const uint64_t maxes[] = {
+            VARINT_PREFIX_MAX_1, VARINT_PREFIX_MAX_2, VARINT_PREFIX_MAX_3,
+            VARINT_PREFIX_MAX_4, VARINT_PREFIX_MAX_5, VARINT_PREFIX_MAX_6,
+            VARINT_PREFIX_MAX_7, VARINT_PREFIX_MAX_8, VARINT_PREFIX_MAX_9};
+        for (size_t w = 0; w < 9; w++) {
+            const uint64_t edges[] = {maxes[w], maxes[w] - 1,
+                                      w ? maxes[w - 1] + 1 : 0};
+            for (size_t e = 0; e < 3; e++) {
+                /* Slack after the varint for the single load decoder */
+                uint8_t buf[9 + 8];
+                memset(buf, 0xa5, sizeof(buf));
+                const varintWidth len = varintPrefixPut(buf, edges[e]);
+                uint64_t slow = 0;
+                uint64_t quick = 0;
+                if (len != w + 1 || varintPrefixGetLen(buf) != len ||
+                    varintPrefixGet(buf, &slow) != len ||
+                    varintPrefixGetQuick_(buf, &quick) != len ||
+                    slow != edges[e] || quick != edges[e]) {
+                    ERR("Width %zu edge %" PRIu64 " failed!", w + 1,
+                        edges[e]);
+                }
+            }
+        }
+    }
+
+    TEST("bulk encode and decode match single value coding") {
+        uint64_t *vals = malloc(COUNT * sizeof(*vals));
+        uint64_t *out = malloc(COUNT * sizeof(*out));
+        uint8_t *bulk = malloc(COUNT * 9 + 8);
+        uint8_t *single = malloc(COUNT * 9);
+        size_t singleLen = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            vals[i] = ctestRandomWidth();
+            singleLen += varintPrefixPut(single + singleLen, vals[i]);
+        }
+
+        /* Bulk encode must not write past the encoded bytes */
+        memset(bulk, 0xa5, COUNT * 9 + 8);
+        const size_t bulkLen = varintPrefixEncodeArray(bulk, vals, COUNT);
+        if (bulkLen != singleLen || memcmp(bulk, single, singleLen)) {
+            ERRR("Bulk encode differs from single encode!");
+        }
+
+        for (size_t i = bulkLen; i < bulkLen + 8; i++) {
+            if (bulk[i] != 0xa5) {
+                ERR("Bulk encode wrote byte %zu past the end!", i - bulkLen);
+                break;
+            }
+        }
+
+        /* Small trailing values, where a wide store would overrun */
+        for (size_t n = 1; n <= 16; n++) {
+            const uint64_t ones[16] = {1, 1, 1, 1, 1, 1, 1, 1,
+                                       1, 1, 1, 1, 1, 1, 1, 1};
+            uint8_t small[16 + 8];
+            memset(small, 0xa5, sizeof(small));
+            const size_t smallLen = varintPrefixEncodeArray(small, ones, n);
+            bool ok = smallLen == n;
+            for (size_t i = 0; i < sizeof(small); i++) {
+                ok &= small[i] == (i < n ? 0x02 : 0xa5);
+            }
+
+            if (!ok) {
+                ERR("Bulk encode of %zu ones failed!", n);
+            }
+        }
+
+        /* Exact length: the tail decodes without wide loads */
+        uint8_t *exact = malloc(bulkLen);
+        memcpy(exact, bulk, bulkLen);
+        if (varintPrefixDecodeArray(exact, bulkLen, out, COUNT) != bulkLen ||
+            memcmp(out, vals, COUNT * sizeof(*out))) {
+            ERRR("Bulk decode failed!");
+        }
+
+        free(exact);
+        free(vals);
+        free(out);
+        free(bulk);
+        free(single);
+    }
+
+    TEST_FINAL_RESULT;
+}
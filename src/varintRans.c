@@ -0,0 +1,278 @@
+#include "varintRans.h"
+#include "varintTagged.h"
+
+#include <string.h>
+
+#define VARINT_RANS_TOTAL (1U << VARINT_RANS_PROB_BITS)
+#define VARINT_RANS_MASK (VARINT_RANS_TOTAL - 1)
+
+/* Lower bound of a normalized state; states stay in [L, L << 8) */
+#define VARINT_RANS_L (1U << 23)
+
+/* ====================================================================
+ * Model
+ * ==================================================================== */
+/* Scale 'counts' to frequencies summing to VARINT_RANS_TOTAL, keeping every
+ * used symbol at a frequency of at least 1. */
+static void varintRansNormalize_(const uint64_t *counts, uint32_t symbols,
+                                 uint64_t total, uint32_t *freqs) {
+    uint32_t sum = 0;
+    uint32_t most = 0;
+    for (uint32_t s = 0; s < symbols; s++) {
+        freqs[s] = 0;
+        if (counts[s]) {
+            const uint64_t scaled =
+                (counts[s] * VARINT_RANS_TOTAL + total / 2) / total;
+            freqs[s] = scaled ? (uint32_t)scaled : 1;
+            sum += freqs[s];
+        }
+
+        if (counts[s] > counts[most]) {
+            most = s;
+        }
+    }
+
+    /* Rounding (and raising rare symbols to 1) can overshoot; take the
+     * excess from whichever symbol is currently largest. */
+    while (sum > VARINT_RANS_TOTAL) {
+        uint32_t largest = 0;
+        for (uint32_t s = 1; s < symbols; s++) {
+            if (freqs[s] > freqs[largest]) {
+                largest = s;
+            }
+        }
+
+        freqs[largest]--;
+        sum--;
+    }
+
+    /* or undershoot; give a shortfall to the most common symbol */
+    freqs[most] += VARINT_RANS_TOTAL - sum;
+}
+
+/* ====================================================================
+ * Encoding
+ * ==================================================================== */
+size_t varintRansEncode(const uint8_t *src, size_t count, uint8_t *dst,
+                        size_t dstCapacity) {
+    uint64_t counts[256] = {0};
+    uint32_t symbols = 0;
+    for (size_t i = 0; i < count; i++) {
+        counts[src[i]]++;
+        if (src[i] >= symbols) {
+            symbols = src[i] + 1U;
+        }
+    }
+
+    uint32_t freqs[256];
+    uint32_t starts[256];
+    if (count) {
+        varintRansNormalize_(counts, symbols, count, freqs);
+    }
+
+    uint8_t header[VARINT_RANS_HEADER_MAX];
+    size_t headerLen = varintTaggedPut64(header, count);
+    headerLen += varintTaggedPut64(header + headerLen, symbols);
+    uint32_t start = 0;
+    for (uint32_t s = 0; s < symbols; s++) {
+        headerLen += varintTaggedPut64(header + headerLen, freqs[s]);
+        starts[s] = start;
+        start += freqs[s];
+    }
+
+    if (headerLen > dstCapacity) {
+        return 0;
+    }
+
+    memcpy(dst, header, headerLen);
+    if (!count) {
+        return headerLen;
+    }
+
+    /* Symbols are encoded last to first, writing bytes backwards from the
+     * end of 'dst' so the decoder reads them forwards. */
+    uint8_t *const limit = dst + headerLen + 4 * VARINT_RANS_STATES;
+    uint8_t *ptr = dst + dstCapacity;
+    if (ptr < limit) {
+        return 0;
+    }
+
+    uint32_t states[VARINT_RANS_STATES];
+    for (uint32_t j = 0; j < VARINT_RANS_STATES; j++) {
+        states[j] = VARINT_RANS_L;
+    }
+
+    for (size_t i = count; i-- > 0;) {
+        if (ptr - limit < 2) {
+            return 0;
+        }
+
+        uint32_t *x = &states[i % VARINT_RANS_STATES];
+        const uint32_t freq = freqs[src[i]];
+        const uint32_t xMax =
+            ((VARINT_RANS_L >> VARINT_RANS_PROB_BITS) << 8) * freq;
+        while (*x >= xMax) {
+            *--ptr = (uint8_t)*x;
+            *x >>= 8;
+        }
+
+        *x = ((*x / freq) << VARINT_RANS_PROB_BITS) + (*x % freq) +
+             starts[src[i]];
+    }
+
+    /* Final states, state 0 first */
+    for (uint32_t j = VARINT_RANS_STATES; j-- > 0;) {
+        ptr -= 4;
+        for (uint32_t b = 0; b < 4; b++) {
+            ptr[b] = (uint8_t)(states[j] >> (8 * b));
+        }
+    }
+
+    const size_t bodyLen = (size_t)(dst + dstCapacity - ptr);
+    memmove(dst + headerLen, ptr, bodyLen);
+    return headerLen + bodyLen;
+}
+
+/* ====================================================================
+ * Decoding
+ * ==================================================================== */
+bool varintRansDecodedCount(const uint8_t *src, size_t len, size_t *count) {
+    uint64_t n;
+    if (!varintTaggedGet(src, len > 9 ? 9 : (int32_t)len, &n) ||
+        n > SIZE_MAX) {
+        return false;
+    }
+
+    *count = (size_t)n;
+    return true;
+}
+
+bool varintRansDecode(const uint8_t *src, size_t len, uint8_t *dst,
+                      size_t dstCapacity, size_t *count) {
+    const uint8_t *p = src;
+    const uint8_t *const end = src + len;
+#define varintRansGet_(value)                                                  \
+    do {                                                                       \
+        const size_t _left = (size_t)(end - p);                                \
+        const varintWidth _w =                                                 \
+            varintTaggedGet(p, _left > 9 ? 9 : (int32_t)_left, &(value));      \
+        if (!_w) {                                                             \
+            return false;                                                      \
+        }                                                                      \
+        p += _w;                                                               \
+    } while (0)
+
+    uint64_t n;
+    uint64_t symbols;
+    varintRansGet_(n);
+    varintRansGet_(symbols);
+    if (n > dstCapacity || symbols > 256 || (!n != !symbols)) {
+        return false;
+    }
+
+    if (!n) {
+        *count = 0;
+        return p == end;
+    }
+
+    uint16_t freqs[256];
+    uint16_t starts[256];
+    uint8_t slotSymbol[VARINT_RANS_TOTAL];
+    uint32_t start = 0;
+    for (uint32_t s = 0; s < symbols; s++) {
+        uint64_t freq;
+        varintRansGet_(freq);
+        if (freq > VARINT_RANS_TOTAL - start) {
+            return false;
+        }
+
+        freqs[s] = (uint16_t)freq;
+        starts[s] = (uint16_t)start;
+        memset(slotSymbol + start, (int)s, freq);
+        start += freq;
+    }
+#undef varintRansGet_
+
+    if (start != VARINT_RANS_TOTAL ||
+        (size_t)(end - p) < 4 * VARINT_RANS_STATES) {
+        return false;
+    }
+
+    uint32_t states[VARINT_RANS_STATES];
+    for (uint32_t j = 0; j < VARINT_RANS_STATES; j++) {
+        states[j] = (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+                    (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        p += 4;
+        if (states[j] < VARINT_RANS_L || states[j] >= VARINT_RANS_L << 8) {
+            return false;
+        }
+    }
+
+#define varintRansStep_(x, out)                                                \
+    do {                                                                       \
+        const uint32_t _slot = (x)&VARINT_RANS_MASK;                           \
+        const uint8_t _s = slotSymbol[_slot];                                  \
+        (out) = _s;                                                            \
+        (x) = freqs[_s] * ((x) >> VARINT_RANS_PROB_BITS) + _slot - starts[_s]; \
+    } while (0)
+
+    /* States stay in [L, L << 8), so a symbol reads at most 2 bytes and
+     * while 2 bytes per state remain the four states can renormalize
+     * without bounds checks. */
+    size_t i = 0;
+    uint32_t x0 = states[0];
+    uint32_t x1 = states[1];
+    uint32_t x2 = states[2];
+    uint32_t x3 = states[3];
+    while (n - i >= 4 && end - p >= 8) {
+        varintRansStep_(x0, dst[i]);
+        varintRansStep_(x1, dst[i + 1]);
+        varintRansStep_(x2, dst[i + 2]);
+        varintRansStep_(x3, dst[i + 3]);
+        while (x0 < VARINT_RANS_L) {
+            x0 = x0 << 8 | *p++;
+        }
+
+        while (x1 < VARINT_RANS_L) {
+            x1 = x1 << 8 | *p++;
+        }
+
+        while (x2 < VARINT_RANS_L) {
+            x2 = x2 << 8 | *p++;
+        }
+
+        while (x3 < VARINT_RANS_L) {
+            x3 = x3 << 8 | *p++;
+        }
+
+        i += 4;
+    }
+
+    states[0] = x0;
+    states[1] = x1;
+    states[2] = x2;
+    states[3] = x3;
+    for (; i < n; i++) {
+        uint32_t *x = &states[i % VARINT_RANS_STATES];
+        varintRansStep_(*x, dst[i]);
+        while (*x < VARINT_RANS_L) {
+            if (p == end) {
+                return false;
+            }
+
+            *x = *x << 8 | *p++;
+        }
+    }
+#undef varintRansStep_
+
+    /* Decoding ends in the encoder's initial states exactly when the
+     * input was a whole, unmodified stream. */
+    for (uint32_t j = 0; j < VARINT_RANS_STATES; j++) {
+        if (states[j] != VARINT_RANS_L) {
+            return false;
+        }
+    }
+
+    *count = (size_t)n;
+    return p == end;
+}
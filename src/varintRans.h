@@ -0,0 +1,55 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * rANS entropy coding of control streams
+ * ==================================================================== */
+/* Formats keeping widths outside their payload (External varints with a
+ * width array, as written by varintParallelEncode()) spend a whole byte
+ * per value on a width which is nearly always one of two or three values.
+ * varintRans compresses such a control stream with a static model rANS
+ * coder, leaving the payload bytes byte-aligned and untouched.
+ *
+ * Symbol frequencies are counted once, scaled to sum to
+ * 2^VARINT_RANS_PROB_BITS, and stored in the header as Tagged varints.
+ * Four rANS states are interleaved (symbol i uses state i % 4) so the
+ * decoder's four dependency chains overlap instead of running one after
+ * another.  Each state renormalizes a byte at a time, so a symbol costs
+ * at most 2 bytes and a stream of one symbol costs only its header.
+ *
+ * Encoded layout:
+ *   count    Tagged varint: symbols in the stream
+ *   symbols  Tagged varint: highest symbol + 1 (0 if count is 0)
+ *   freqs    Tagged varint per symbol below 'symbols' (0 if unused)
+ *   states   4 x 32-bit little endian final encoder states
+ *   bytes    renormalization bytes in decoding order */
+
+#define VARINT_RANS_PROB_BITS 12
+#define VARINT_RANS_STATES 4
+
+/* Largest header: count, symbols, 256 frequencies (each at most 3 bytes),
+ * and the final states. */
+#define VARINT_RANS_HEADER_MAX (9 + 2 + 256 * 3 + 4 * VARINT_RANS_STATES)
+
+/* Bytes always enough to encode 'count' symbols. */
+#define varintRansEncodeBound(count) (VARINT_RANS_HEADER_MAX + 2 * (count))
+
+/* Encode 'count' bytes of 'src' into 'dst' (room for 'dstCapacity' bytes).
+ * Returns the encoded length, or 0 if 'dst' is too small. */
+size_t varintRansEncode(const uint8_t *src, size_t count, uint8_t *dst,
+                        size_t dstCapacity);
+
+/* Number of symbols encoded in 'src' (read from its header), or false if
+ * the header is truncated. */
+bool varintRansDecodedCount(const uint8_t *src, size_t len, size_t *count);
+
+/* Decode all of 'src' ('len' bytes, as returned by varintRansEncode())
+ * into 'dst' (room for 'dstCapacity' symbols) and store the symbol count
+ * in 'count'.  Returns false if 'src' is malformed or 'dst' is too small;
+ * never reads outside [src, src + len). */
+bool varintRansDecode(const uint8_t *src, size_t len, uint8_t *dst,
+                      size_t dstCapacity, size_t *count);
+
+__END_DECLS
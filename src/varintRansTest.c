@@ -0,0 +1,163 @@
+#include "varintRans.h"
+#include "varintParallel.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 1000000
+
+static bool roundTrip(const uint8_t *src, size_t count, size_t *encodedLen) {
+    const size_t bound = varintRansEncodeBound(count);
+    uint8_t *encoded = malloc(bound);
+    uint8_t *decoded = malloc(count + 1);
+    bool ok = false;
+    size_t len = varintRansEncode(src, count, encoded, bound);
+    size_t decodedCount = 0;
+    size_t headerCount = 0;
+    if (len && varintRansDecodedCount(encoded, len, &headerCount) &&
+        headerCount == count &&
+        varintRansDecode(encoded, len, decoded, count, &decodedCount) &&
+        decodedCount == count && !memcmp(decoded, src, count)) {
+        ok = true;
+    }
+
+    /* Every truncation must be rejected */
+    for (size_t cut = len > 64 ? len - 64 : 0; ok && cut < len; cut++) {
+        if (varintRansDecode(encoded, cut, decoded, count, &decodedCount)) {
+            ok = false;
+        }
+    }
+
+    if (encodedLen) {
+        *encodedLen = len;
+    }
+
+    free(encoded);
+    free(decoded);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(41);
+
+    uint8_t *symbols = malloc(COUNT);
+
+    TEST("skewed External width stream compresses") {
+        /* Telemetry-like values: mostly 1 and 2 byte, few wider */
+        uint64_t *vals = malloc(COUNT * sizeof(*vals));
+        for (size_t i = 0; i < COUNT; i++) {
+            const uint64_t r = ctestRandom() >> 32;
+            const uint32_t pick = r % 100;
+            vals[i] = pick < 70   ? r & 0xff
+                      : pick < 95 ? r & 0xffff
+                                  : ctestRandom() >> (ctestRandom() % 32);
+        }
+
+        uint8_t *payload = malloc(COUNT * 8);
+        size_t payloadLen = 0;
+        varintParallelEncodeConfig config = {
+            .format = VARINT_PARALLEL_EXTERNAL, .widths = symbols};
+        if (!varintParallelEncode(&config, vals, COUNT, payload, COUNT * 8,
+                                  &payloadLen)) {
+            ERRR("External encode failed!");
+        }
+
+        size_t len = 0;
+        if (!roundTrip(symbols, COUNT, &len)) {
+            ERRR("Width stream round trip failed!");
+        }
+
+        /* About 1.2 bits per width instead of 8 */
+        if (len * 4 > COUNT) {
+            ERR("Width stream only compressed to %zu bytes!", len);
+        }
+
+        free(vals);
+        free(payload);
+    }
+
+    TEST("any byte distribution round trips") {
+        for (size_t i = 0; i < COUNT; i++) {
+            symbols[i] = (uint8_t)(ctestRandom() >> 56);
+        }
+
+        size_t len = 0;
+        if (!roundTrip(symbols, COUNT, &len)) {
+            ERRR("Uniform bytes failed!");
+        }
+
+        /* Uniform bytes can't compress; the quantized model costs a
+         * little on top */
+        if (len > COUNT + COUNT / 200) {
+            ERR("Uniform bytes grew to %zu!", len);
+        }
+
+        /* One common symbol plus every other byte once */
+        memset(symbols, 3, COUNT);
+        for (size_t i = 0; i < 256; i++) {
+            symbols[i * 1000] = (uint8_t)i;
+        }
+
+        if (!roundTrip(symbols, COUNT, NULL)) {
+            ERRR("Rare symbols failed!");
+        }
+
+        for (size_t count = 0; count < 40; count++) {
+            for (size_t i = 0; i < count; i++) {
+                symbols[i] = (uint8_t)(ctestRandom() % (count % 5 + 1));
+            }
+
+            if (!roundTrip(symbols, count, NULL)) {
+                ERR("Short stream of %zu failed!", count);
+            }
+        }
+
+        /* One symbol costs only its header */
+        memset(symbols, 1, COUNT);
+        size_t singleLen = 0;
+        if (!roundTrip(symbols, COUNT, &singleLen) || singleLen > 32) {
+            ERR("Single symbol stream took %zu bytes!", singleLen);
+        }
+    }
+
+    TEST("bad buffers are rejected") {
+        for (size_t i = 0; i < 10000; i++) {
+            symbols[i] = (uint8_t)(ctestRandom() % 7);
+        }
+
+        uint8_t encoded[varintRansEncodeBound(10000)];
+        const size_t len =
+            varintRansEncode(symbols, 10000, encoded, sizeof(encoded));
+        if (!len || varintRansEncode(symbols, 10000, encoded, len - 1)) {
+            ERRR("Short output not detected!");
+        }
+
+        uint8_t out[10000];
+        size_t count = 0;
+        if (varintRansDecode(encoded, len, out, 9999, &count)) {
+            ERRR("Undersized decode output accepted!");
+        }
+
+        /* Flipping any body byte must not crash, and almost always fails
+         * the final state check. */
+        size_t accepted = 0;
+        for (size_t i = len / 2; i < len; i++) {
+            encoded[i] ^= 0x5a;
+            accepted += varintRansDecode(encoded, len, out, 10000, &count);
+            encoded[i] ^= 0x5a;
+        }
+
+        if (accepted > 2) {
+            ERR("%zu corrupted streams accepted!", accepted);
+        }
+    }
+
+    free(symbols);
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,319 @@
+#include "varintRope.h"
+#include "varintScan.h"
+#include "varintTagged.h"
+
+#include <stdlib.h>
+
+/* Neighbouring chunks are merged after a delete once together they fill
+ * no more than this, so a chunk always has room to grow after a merge. */
+#define VARINT_ROPE_MERGE_BYTES (VARINT_ROPE_CHUNK_BYTES / 2)
+
+varintRope *varintRopeNew(void) {
+    return calloc(1, sizeof(varintRope));
+}
+
+void varintRopeFree(varintRope *r) {
+    if (!r) {
+        return;
+    }
+
+    for (size_t i = 0; i < r->chunkCount; i++) {
+        free(r->chunks[i]);
+    }
+
+    free(r->chunks);
+    free(r->starts);
+    free(r);
+}
+
+/* ====================================================================
+ * Chunk index
+ * ==================================================================== */
+/* Find the chunk holding position 'index' (or, for 'index' equal to the
+ * count, the last chunk) and set 'local' to the position inside it. */
+static size_t varintRopeFind_(const varintRope *r, size_t index,
+                              size_t *local) {
+    size_t lo = 0;
+    size_t hi = r->chunkCount;
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (r->starts[mid] <= index) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    *local = index - r->starts[lo];
+    return lo;
+}
+
+/* Byte offset of value 'local' inside 'c' */
+static size_t varintRopeOffset_(const varintRopeChunk *c, size_t local) {
+    return varintScanSkip(VARINT_SCAN_TAGGED, c->data, c->used, local, NULL);
+}
+
+static void varintRopeShiftStarts_(varintRope *r, size_t after,
+                                   ptrdiff_t delta) {
+    for (size_t i = after + 1; i < r->chunkCount; i++) {
+        r->starts[i] += delta;
+    }
+}
+
+/* Insert an empty slot for a chunk at 'at' */
+static bool varintRopeIndexInsert_(varintRope *r, size_t at) {
+    if (r->chunkCount == r->chunkSlots) {
+        const size_t slots = r->chunkSlots ? r->chunkSlots * 2 : 8;
+        varintRopeChunk **chunks =
+            realloc(r->chunks, slots * sizeof(*r->chunks));
+        if (!chunks) {
+            return false;
+        }
+
+        r->chunks = chunks;
+
+        size_t *starts = realloc(r->starts, slots * sizeof(*r->starts));
+        if (!starts) {
+            return false;
+        }
+
+        r->starts = starts;
+        r->chunkSlots = slots;
+    }
+
+    memmove(r->chunks + at + 1, r->chunks + at,
+            (r->chunkCount - at) * sizeof(*r->chunks));
+    memmove(r->starts + at + 1, r->starts + at,
+            (r->chunkCount - at) * sizeof(*r->starts));
+    r->chunkCount++;
+    return true;
+}
+
+static void varintRopeIndexRemove_(varintRope *r, size_t at) {
+    free(r->chunks[at]);
+    r->chunkCount--;
+    memmove(r->chunks + at, r->chunks + at + 1,
+            (r->chunkCount - at) * sizeof(*r->chunks));
+    memmove(r->starts + at, r->starts + at + 1,
+            (r->chunkCount - at) * sizeof(*r->starts));
+}
+
+/* ====================================================================
+ * Chunk splitting
+ * ==================================================================== */
+/* Guarantee chunk '*ci' has 'need' free bytes, splitting it in half if it
+ * doesn't.  '*ci' and '*local' are updated if position '*local' moves to
+ * the new second half. */
+static bool varintRopeMakeRoom_(varintRope *r, size_t *ci, size_t *local,
+                                size_t need) {
+    varintRopeChunk *c = r->chunks[*ci];
+    if (c->used + need <= VARINT_ROPE_CHUNK_BYTES) {
+        return true;
+    }
+
+    varintRopeChunk *next = malloc(sizeof(*next));
+    if (!next || !varintRopeIndexInsert_(r, *ci + 1)) {
+        free(next);
+        return false;
+    }
+
+    /* Keep whole values totalling at least half the bytes in 'c' */
+    size_t keepBytes = 0;
+    size_t keepCount = 0;
+    while (keepBytes < c->used / 2) {
+        keepBytes += varintTaggedGetLenQuick_(c->data + keepBytes);
+        keepCount++;
+    }
+
+    next->used = c->used - keepBytes;
+    next->count = c->count - keepCount;
+    memcpy(next->data, c->data + keepBytes, next->used);
+    c->used = keepBytes;
+    c->count = keepCount;
+
+    r->chunks[*ci + 1] = next;
+    r->starts[*ci + 1] = r->starts[*ci] + keepCount;
+
+    /* A position between the halves goes to the front of the new chunk,
+     * which is the emptier one. */
+    if (*local >= keepCount) {
+        *local -= keepCount;
+        (*ci)++;
+    }
+
+    return true;
+}
+
+/* ====================================================================
+ * Value access
+ * ==================================================================== */
+bool varintRopeGet(const varintRope *r, size_t index, uint64_t *value) {
+    if (index >= r->count) {
+        return false;
+    }
+
+    size_t local;
+    const varintRopeChunk *c = r->chunks[varintRopeFind_(r, index, &local)];
+    varintTaggedGet64(c->data + varintRopeOffset_(c, local), value);
+    return true;
+}
+
+/* Replace the value at 'local' in chunk 'ci', moving only the bytes after
+ * it inside its chunk when its width changes. */
+static bool varintRopeReplace_(varintRope *r, size_t ci, size_t local,
+                               uint64_t value) {
+    uint8_t encoded[9];
+    const size_t newLen = varintTaggedPut64(encoded, value);
+
+    varintRopeChunk *c = r->chunks[ci];
+    size_t offset = varintRopeOffset_(c, local);
+    const size_t oldLen = varintTaggedGetLenQuick_(c->data + offset);
+    if (newLen > oldLen) {
+        if (!varintRopeMakeRoom_(r, &ci, &local, newLen - oldLen)) {
+            return false;
+        }
+
+        c = r->chunks[ci];
+        offset = varintRopeOffset_(c, local);
+    }
+
+    if (newLen != oldLen) {
+        memmove(c->data + offset + newLen, c->data + offset + oldLen,
+                c->used - offset - oldLen);
+        c->used = c->used - oldLen + newLen;
+        r->bytes = r->bytes - oldLen + newLen;
+    }
+
+    memcpy(c->data + offset, encoded, newLen);
+    return true;
+}
+
+bool varintRopeSet(varintRope *r, size_t index, uint64_t value) {
+    if (index >= r->count) {
+        return false;
+    }
+
+    size_t local;
+    const size_t ci = varintRopeFind_(r, index, &local);
+    return varintRopeReplace_(r, ci, local, value);
+}
+
+bool varintRopeAdd(varintRope *r, size_t index, int64_t add,
+                   uint64_t *result) {
+    if (index >= r->count) {
+        return false;
+    }
+
+    size_t local;
+    const size_t ci = varintRopeFind_(r, index, &local);
+    const varintRopeChunk *c = r->chunks[ci];
+    uint64_t value;
+    varintTaggedGet64(c->data + varintRopeOffset_(c, local), &value);
+
+    if (add < 0) {
+        const uint64_t sub = (uint64_t)0 - (uint64_t)add;
+        if (sub > value) {
+            return false;
+        }
+
+        value -= sub;
+    } else {
+        if ((uint64_t)add > UINT64_MAX - value) {
+            return false;
+        }
+
+        value += (uint64_t)add;
+    }
+
+    if (!varintRopeReplace_(r, ci, local, value)) {
+        return false;
+    }
+
+    if (result) {
+        *result = value;
+    }
+
+    return true;
+}
+
+/* ====================================================================
+ * Insert and delete
+ * ==================================================================== */
+bool varintRopeInsert(varintRope *r, size_t index, uint64_t value) {
+    if (index > r->count) {
+        return false;
+    }
+
+    if (!r->chunkCount) {
+        varintRopeChunk *c = malloc(sizeof(*c));
+        if (!c || !varintRopeIndexInsert_(r, 0)) {
+            free(c);
+            return false;
+        }
+
+        c->used = 0;
+        c->count = 0;
+        r->chunks[0] = c;
+        r->starts[0] = 0;
+    }
+
+    uint8_t encoded[9];
+    const size_t len = varintTaggedPut64(encoded, value);
+
+    size_t local;
+    size_t ci = varintRopeFind_(r, index, &local);
+    if (!varintRopeMakeRoom_(r, &ci, &local, len)) {
+        return false;
+    }
+
+    varintRopeChunk *c = r->chunks[ci];
+    const size_t offset = varintRopeOffset_(c, local);
+    memmove(c->data + offset + len, c->data + offset, c->used - offset);
+    memcpy(c->data + offset, encoded, len);
+    c->used += len;
+    c->count++;
+
+    varintRopeShiftStarts_(r, ci, 1);
+    r->count++;
+    r->bytes += len;
+    return true;
+}
+
+bool varintRopeDelete(varintRope *r, size_t index) {
+    if (index >= r->count) {
+        return false;
+    }
+
+    size_t local;
+    const size_t ci = varintRopeFind_(r, index, &local);
+    varintRopeChunk *c = r->chunks[ci];
+    const size_t offset = varintRopeOffset_(c, local);
+    const size_t len = varintTaggedGetLenQuick_(c->data + offset);
+    memmove(c->data + offset, c->data + offset + len,
+            c->used - offset - len);
+    c->used -= len;
+    c->count--;
+
+    varintRopeShiftStarts_(r, ci, -1);
+    r->count--;
+    r->bytes -= len;
+
+    if (!c->count) {
+        varintRopeIndexRemove_(r, ci);
+        return true;
+    }
+
+    /* Fold a small next chunk into this one so deletes don't leave long
+     * runs of nearly empty chunks. */
+    if (ci + 1 < r->chunkCount) {
+        varintRopeChunk *next = r->chunks[ci + 1];
+        if (c->used + next->used <= VARINT_ROPE_MERGE_BYTES) {
+            memcpy(c->data + c->used, next->data, next->used);
+            c->used += next->used;
+            c->count += next->count;
+            varintRopeIndexRemove_(r, ci + 1);
+        }
+    }
+
+    return true;
+}
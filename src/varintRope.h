@@ -0,0 +1,61 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Editable sequence of Tagged varints
+ * ==================================================================== */
+/* varint model Rope Container:
+ *   Type encoded inside: each value is a Tagged varint
+ *   Size: 1 byte to 9 bytes per value plus per-chunk slack
+ *   Layout: values stored back to back in fixed size chunks; an index of
+ *           the first position held by each chunk maps positions to chunks.
+ *   Meaning: a value changing width only moves the bytes after it inside
+ *            its own chunk.  A chunk without room is split in half.
+ *   Pro: insert, delete, and width-changing updates anywhere in a sequence
+ *        of millions of values touch at most one or two 4 KB chunks instead
+ *        of rebuilding one large buffer.
+ *   Con: finding a position inside a chunk walks the chunk's varints (with
+ *        varintScanSkip(), so runs of one byte values are skipped a SIMD
+ *        chunk at a time). */
+
+/* Chunk header plus data fills exactly 4 KB. */
+#define VARINT_ROPE_CHUNK_BYTES (4096 - 2 * sizeof(uint32_t))
+
+typedef struct varintRopeChunk {
+    uint32_t used;  /* bytes of data[] holding values */
+    uint32_t count; /* values in data[] */
+    uint8_t data[VARINT_ROPE_CHUNK_BYTES];
+} varintRopeChunk;
+
+typedef struct varintRope {
+    varintRopeChunk **chunks;
+    size_t *starts;    /* position of the first value in each chunk */
+    size_t chunkCount; /* chunks in use (none are ever empty) */
+    size_t chunkSlots; /* entries allocated in chunks[] and starts[] */
+    size_t count;      /* values in the rope */
+    size_t bytes;      /* encoded bytes across all chunks */
+} varintRope;
+
+varintRope *varintRopeNew(void);
+void varintRopeFree(varintRope *r);
+
+#define varintRopeCount(r) ((r)->count)
+#define varintRopeBytes(r) ((r)->bytes)
+
+/* Each function returns false (and leaves the rope unchanged) if 'index'
+ * is out of range or an allocation fails.  Insert accepts an 'index' equal
+ * to the count to append. */
+bool varintRopeGet(const varintRope *r, size_t index, uint64_t *value);
+bool varintRopeSet(varintRope *r, size_t index, uint64_t value);
+bool varintRopeInsert(varintRope *r, size_t index, uint64_t value);
+bool varintRopeDelete(varintRope *r, size_t index);
+
+/* Add signed 'add' to the value at 'index', growing or shrinking its
+ * encoding as needed.  Also returns false if the result would fall below
+ * zero or above UINT64_MAX.  'result' (if not NULL) receives the new value. */
+bool varintRopeAdd(varintRope *r, size_t index, int64_t add,
+                   uint64_t *result);
+
+__END_DECLS
@@ -0,0 +1,162 @@
+#include "varintRope.h"
+#include "varintChained.h"
+#include "varintExternal.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define OPS 200000
+#define MAX_COUNT 60000
+
+static uint64_t randomValue(void) {
+    /* Mostly counters near the one/two byte boundary, some wide values */
+    return ctestRandom() % 8 ? ctestRandom() % 300 : ctestRandomWidth();
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(17);
+
+    TEST("in-place add returns the new width") {
+        uint8_t buf[16] = {0};
+        varintTaggedPut64(buf, 200);
+        if (varintTaggedAddNoGrow(buf, 40) != 1 ||
+            varintTaggedGet64ReturnValue(buf) != 240) {
+            ERRR("Tagged add within width failed!");
+        }
+
+        if (varintTaggedAddNoGrow(buf, 1) != 2 ||
+            varintTaggedGet64ReturnValue(buf) != 240) {
+            ERRR("Tagged add needing growth wrote anyway!");
+        }
+
+        if (varintTaggedAddGrow(buf, 1) != 2 ||
+            varintTaggedGet64ReturnValue(buf) != 241) {
+            ERRR("Tagged add with growth failed!");
+        }
+
+        varintTaggedPut64(buf, INT64_MAX);
+        if (varintTaggedAddGrow(buf, 1) != VARINT_WIDTH_INVALID) {
+            ERRR("Tagged add didn't detect overflow!");
+        }
+
+        uint64_t value;
+        varintChainedPutVarint(buf, 127);
+        if (varintChainedVarintAddNoGrow(buf, 1) != 2 ||
+            varintChainedVarintAddGrow(buf, 1) != 2 ||
+            (varintChainedGetVarint(buf, &value), value != 128)) {
+            ERRR("Chained add failed!");
+        }
+
+        varintExternalPutFixedWidth(buf, 255, 1);
+        if (varintExternalAddNoGrow(buf, 1, 1) != 2 ||
+            varintExternalGet(buf, 1) != 255 ||
+            varintExternalAddGrow(buf, 1, 1) != 2 ||
+            varintExternalGet(buf, 2) != 256) {
+            ERRR("External add didn't size the new value!");
+        }
+    }
+
+    TEST("random edits match a flat array") {
+        static uint64_t ref[MAX_COUNT];
+        size_t count = 0;
+        varintRope *r = varintRopeNew();
+        for (size_t op = 0; op < OPS; op++) {
+            /* Grow to MAX_COUNT then shrink back to exercise chunk merging */
+            const bool growing = op < OPS * 3 / 4;
+            const uint64_t kind = ctestRandom() % 10;
+            if ((growing ? kind < 5 : kind < 2) && count < MAX_COUNT) {
+                const size_t at = ctestRandom() % (count + 1);
+                const uint64_t value = randomValue();
+                memmove(ref + at + 1, ref + at, (count - at) * sizeof(*ref));
+                ref[at] = value;
+                count++;
+                if (!varintRopeInsert(r, at, value)) {
+                    ERR("Insert at %zu failed!", at);
+                }
+            } else if (!count) {
+                continue;
+            } else if (kind < 6) {
+                const size_t at = ctestRandom() % count;
+                memmove(ref + at, ref + at + 1,
+                        (count - at - 1) * sizeof(*ref));
+                count--;
+                if (!varintRopeDelete(r, at)) {
+                    ERR("Delete at %zu failed!", at);
+                }
+            } else if (kind < 8) {
+                const size_t at = ctestRandom() % count;
+                const int64_t add = (int64_t)(ctestRandom() % 600) - 300;
+                uint64_t result = 0;
+                const bool ok = varintRopeAdd(r, at, add, &result);
+                const bool expectOk = add >= 0 || (uint64_t)-add <= ref[at];
+                if (ok != expectOk || (ok && result != ref[at] + add)) {
+                    ERR("Add %" PRId64 " at %zu wrong!", add, at);
+                }
+
+                if (ok) {
+                    ref[at] += add;
+                }
+            } else {
+                const size_t at = ctestRandom() % count;
+                ref[at] = randomValue();
+                if (!varintRopeSet(r, at, ref[at])) {
+                    ERR("Set at %zu failed!", at);
+                }
+            }
+
+            if (varintRopeCount(r) != count) {
+                ERR("Op %zu: count %zu, expected %zu!", op,
+                    varintRopeCount(r), count);
+                break;
+            }
+
+            /* Spot check one value per op, everything periodically */
+            uint64_t value;
+            if (count) {
+                const size_t at = ctestRandom() % count;
+                if (!varintRopeGet(r, at, &value) || value != ref[at]) {
+                    ERR("Op %zu: value %zu mismatch!", op, at);
+                    break;
+                }
+            }
+
+            if (op % 20000 == 0 || op == OPS - 1) {
+                size_t bytes = 0;
+                for (size_t i = 0; i < count; i++) {
+                    bytes += varintTaggedLen(ref[i]);
+                    if (!varintRopeGet(r, i, &value) || value != ref[i]) {
+                        ERR("Op %zu: value %zu mismatch!", op, i);
+                        break;
+                    }
+                }
+
+                if (varintRopeBytes(r) != bytes) {
+                    ERR("Op %zu: %zu bytes, expected %zu!", op,
+                        varintRopeBytes(r), bytes);
+                }
+
+                /* Chunks stay reasonably full */
+                if (r->chunkCount > 1 + bytes / (VARINT_ROPE_CHUNK_BYTES / 4)) {
+                    ERR("Op %zu: %zu chunks for %zu bytes!", op,
+                        r->chunkCount, bytes);
+                }
+            }
+        }
+
+        uint64_t value;
+        if (varintRopeGet(r, count, &value) || varintRopeSet(r, count, 1) ||
+            varintRopeDelete(r, count) || varintRopeInsert(r, count + 1, 1)) {
+            ERRR("Out of range index accepted!");
+        }
+
+        varintRopeFree(r);
+    }
+
+    TEST_FINAL_RESULT;
+}
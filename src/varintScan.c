@@ -0,0 +1,254 @@
+#include "varintScan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* ====================================================================
+ * Chunk masks
+ * ==================================================================== */
+/* One bit per byte of a chunk, bit i for byte i. */
+#if defined(__AVX2__)
+#define VARINT_SCAN_CHUNK 32
+#define VARINT_SCAN_CHUNK_MASK 0xffffffffULL
+
+static inline uint64_t varintScanHighBits_(const uint8_t *p) {
+    return (uint32_t)_mm256_movemask_epi8(
+        _mm256_loadu_si256((const __m256i *)p));
+}
+
+/* Unsigned b <= max iff max(b, max) == max */
+static inline uint64_t varintScanAtMost_(const uint8_t *p, uint8_t max) {
+    const __m256i limit = _mm256_set1_epi8((char)max);
+    const __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+    return (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, limit), limit));
+}
+#elif defined(__SSE2__)
+#define VARINT_SCAN_CHUNK 16
+#define VARINT_SCAN_CHUNK_MASK 0xffffULL
+
+static inline uint64_t varintScanHighBits_(const uint8_t *p) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline uint64_t varintScanAtMost_(const uint8_t *p, uint8_t max) {
+    const __m128i limit = _mm_set1_epi8((char)max);
+    const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_max_epu8(chunk, limit), limit));
+}
+#endif
+
+/* ====================================================================
+ * Formats sized by their first byte
+ * ==================================================================== */
+/* Encoded length of each first byte; 0 for bytes the format never uses. */
+#define R8_(x) x, x, x, x, x, x, x, x
+#define R16_(x) R8_(x), R8_(x)
+#define R64_(x) R16_(x), R16_(x), R16_(x), R16_(x)
+
+/* 0..240 one byte, 241..248 two bytes, 249 three, 250..255 four to nine */
+static const uint8_t varintScanTaggedLen_[256] = {
+    R64_(1), R64_(1), R64_(1), R16_(1), R16_(1), R16_(1), 1,
+    R8_(2),  3,       4,       5,       6,       7,       8, 9};
+
+/* 00XXXXXX one byte, 01XXXXXX two bytes, 0x81..0x88 two to nine bytes */
+static const uint8_t varintScanSplitLen_[256] = {
+    R64_(1), R64_(2), 0, 2, 3, 4, 5, 6, 7, 8, 9};
+
+/* 00XXXXXX, 01XXXXXX, 10XXXXXX one to three bytes; 0xC1..0xC8 external.
+ * SplitFullNoZero uses the same type bytes. */
+static const uint8_t varintScanSplitFullLen_[256] = {
+    R64_(1), R64_(2), R64_(3), 0, 2, 3, 4, 5, 6, 7, 8, 9};
+
+/* 00XXXXXX, 01XXXXXX, 10XXXXXX two to four bytes; 0xC1..0xC8 external */
+static const uint8_t varintScanSplitFull16Len_[256] = {
+    R64_(2), R64_(3), R64_(4), 0, 2, 3, 4, 5, 6, 7, 8, 9};
+
+#undef R8_
+#undef R16_
+#undef R64_
+
+/* Walk at most 'n' varints sized by 'table'.  First bytes <= 'singleMax'
+ * are one byte varints; runs of them are skipped a chunk at a time
+ * ('singleMax' < 0 if the format has no one byte varints).
+ * Returns the offset after the last whole varint walked. */
+static size_t varintScanTable_(const uint8_t *table, int singleMax,
+                               const uint8_t *src, size_t len, size_t n,
+                               size_t *count) {
+    size_t offset = 0;
+    size_t found = 0;
+    while (found < n && offset < len) {
+#ifdef VARINT_SCAN_CHUNK
+        if (singleMax >= 0 && len - offset >= VARINT_SCAN_CHUNK) {
+            const uint64_t single =
+                varintScanAtMost_(src + offset, (uint8_t)singleMax);
+
+            /* Bits above the chunk are clear, so ~single is never zero */
+            size_t run = __builtin_ctzll(~single);
+            if (run > n - found) {
+                run = n - found;
+            }
+
+            offset += run;
+            found += run;
+            if (run == VARINT_SCAN_CHUNK || found == n) {
+                continue;
+            }
+        }
+#endif
+
+        const size_t width = table[src[offset]];
+        if (!width || width > len - offset) {
+            break;
+        }
+
+        offset += width;
+        found++;
+    }
+
+    *count = found;
+    return offset;
+}
+
+/* ====================================================================
+ * Chained formats
+ * ==================================================================== */
+/* Both chained formats end a varint at the first byte without its high
+ * bit set, or at the ninth byte regardless of its high bit. */
+#define VARINT_SCAN_CHAINED_MAX 9
+
+/* Walk at most 'n' chained varints.  Returns the offset after the last
+ * whole varint walked. */
+static size_t varintScanChained_(const uint8_t *src, size_t len, size_t n,
+                                 size_t *count) {
+    size_t found = 0;
+    size_t end = 0;     /* offset after the last whole varint */
+    size_t pending = 0; /* bytes of the current unfinished varint */
+    size_t offset = 0;
+
+#ifdef VARINT_SCAN_CHUNK
+    while (found < n && len - offset >= VARINT_SCAN_CHUNK) {
+        const uint64_t high = varintScanHighBits_(src + offset);
+        const uint64_t terminators = ~high & VARINT_SCAN_CHUNK_MASK;
+
+        /* Every terminator in the chunk ends a varint (and nothing else
+         * does) unless some varint runs past nine bytes: either the one
+         * carried in, or a run of nine high bits inside the chunk. */
+        uint64_t run9 = high & (high >> 1);
+        run9 &= run9 >> 2;
+        run9 &= run9 >> 4;
+        run9 &= high >> 8;
+        if (terminators && !run9 &&
+            pending + __builtin_ctzll(terminators) < VARINT_SCAN_CHAINED_MAX) {
+            const size_t ends = __builtin_popcountll(terminators);
+            if (ends >= n - found) {
+                /* Target is inside this chunk: find its terminator */
+                uint64_t t = terminators;
+                for (size_t i = 1; i < n - found; i++) {
+                    t &= t - 1;
+                }
+
+                end = offset + __builtin_ctzll(t) + 1;
+                found = n;
+                break;
+            }
+
+            const size_t last = 63 - __builtin_clzll(terminators);
+            found += ends;
+            end = offset + last + 1;
+            pending = VARINT_SCAN_CHUNK - 1 - last;
+            offset += VARINT_SCAN_CHUNK;
+            continue;
+        }
+
+        /* Long varints here; walk the chunk byte by byte */
+        for (size_t i = 0; i < VARINT_SCAN_CHUNK && found < n; i++) {
+            pending++;
+            if (!(src[offset + i] & 0x80) ||
+                pending == VARINT_SCAN_CHAINED_MAX) {
+                found++;
+                end = offset + i + 1;
+                pending = 0;
+            }
+        }
+
+        offset += VARINT_SCAN_CHUNK;
+    }
+
+    if (found == n) {
+        *count = found;
+        return end;
+    }
+#endif
+
+    for (; offset < len && found < n; offset++) {
+        pending++;
+        if (!(src[offset] & 0x80) || pending == VARINT_SCAN_CHAINED_MAX) {
+            found++;
+            end = offset + 1;
+            pending = 0;
+        }
+    }
+
+    *count = found;
+    return end;
+}
+
+/* ====================================================================
+ * Public API
+ * ==================================================================== */
+static size_t varintScan_(varintScanFormat format, const uint8_t *src,
+                          size_t len, size_t n, size_t *count) {
+    switch (format) {
+    case VARINT_SCAN_TAGGED:
+        return varintScanTable_(varintScanTaggedLen_, 240, src, len, n,
+                                count);
+    case VARINT_SCAN_CHAINED:
+    case VARINT_SCAN_CHAINED_SIMPLE:
+        return varintScanChained_(src, len, n, count);
+    case VARINT_SCAN_SPLIT:
+        return varintScanTable_(varintScanSplitLen_, 0x3f, src, len, n,
+                                count);
+    case VARINT_SCAN_SPLIT_FULL:
+    case VARINT_SCAN_SPLIT_FULL_NO_ZERO:
+        return varintScanTable_(varintScanSplitFullLen_, 0x3f, src, len, n,
+                                count);
+    case VARINT_SCAN_SPLIT_FULL_16:
+        return varintScanTable_(varintScanSplitFull16Len_, -1, src, len, n,
+                                count);
+    }
+
+    *count = 0;
+    return 0;
+}
+
+size_t varintScanPrefix(varintScanFormat format, const uint8_t *src,
+                        size_t len, size_t *count) {
+    size_t found;
+    const size_t prefix = varintScan_(format, src, len, SIZE_MAX, &found);
+    if (count) {
+        *count = found;
+    }
+
+    return prefix;
+}
+
+bool varintScanValidate(varintScanFormat format, const uint8_t *src,
+                        size_t len, size_t *count) {
+    return varintScanPrefix(format, src, len, count) == len;
+}
+
+size_t varintScanSkip(varintScanFormat format, const uint8_t *src, size_t len,
+                      size_t n, size_t *skipped) {
+    size_t found;
+    const size_t offset = varintScan_(format, src, len, n, &found);
+    if (skipped) {
+        *skipped = found;
+    }
+
+    return offset;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "varint.h"
+
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Bounds-checked scanning of untrusted buffers
+ * ==================================================================== */
+/* Decoders trust the type byte (or continuation bits) of each varint and
+ * read however many bytes it claims, so a truncated or malicious buffer
+ * makes them read past its end.  These scanners never read outside
+ * [src, src + len) and report how much of a buffer is a whole sequence of
+ * well-formed varints, so untrusted input can be checked once up front and
+ * then decoded with the unchecked decoders.
+ *
+ * Checks are structural: every type byte is one the format defines and
+ * every varint fits inside the buffer.  Non-canonical encodings (a value
+ * stored wider than needed) are accepted since they decode correctly.
+ *
+ * Runs of one byte varints (and, for chained formats, all terminator
+ * bytes) are counted 32 bytes at a time with AVX2, 16 with SSE2. */
+
+typedef enum varintScanFormat {
+    VARINT_SCAN_TAGGED = 0,         /* varintTaggedPut64() */
+    VARINT_SCAN_CHAINED,            /* varintChainedPutVarint() */
+    VARINT_SCAN_CHAINED_SIMPLE,     /* varintChainedSimpleEncode64() */
+    VARINT_SCAN_SPLIT,              /* varintSplitPut_() */
+    VARINT_SCAN_SPLIT_FULL,         /* varintSplitFullPut_() */
+    VARINT_SCAN_SPLIT_FULL_NO_ZERO, /* varintSplitFullNoZeroPut_() */
+    VARINT_SCAN_SPLIT_FULL_16,      /* varintSplitFull16Put_() */
+} varintScanFormat;
+
+/* Returns the length of the longest prefix of 'src' made of whole,
+ * well-formed varints and stores the number of varints in it in 'count'
+ * (if not NULL).  The first malformed or truncated varint (if any) starts
+ * at the returned offset. */
+size_t varintScanPrefix(varintScanFormat format, const uint8_t *src,
+                        size_t len, size_t *count);
+
+/* Returns true if all 'len' bytes of 'src' are whole, well-formed varints.
+ * 'count' (if not NULL) receives the number of varints validated. */
+bool varintScanValidate(varintScanFormat format, const uint8_t *src,
+                        size_t len, size_t *count);
+
+/* Returns the offset just past the first 'n' varints of 'src', stopping
+ * early at the end of the buffer or at a malformed varint.  'skipped' (if
+ * not NULL) receives the number of varints actually skipped, so a result
+ * with *skipped < n means the buffer ran out or is invalid there. */
+size_t varintScanSkip(varintScanFormat format, const uint8_t *src, size_t len,
+                      size_t n, size_t *skipped);
+
+__END_DECLS
@@ -0,0 +1,181 @@
+#include "varintScan.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintSplit.h"
+#include "varintSplitFull.h"
+#include "varintSplitFull16.h"
+#include "varintSplitFullNoZero.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#define COUNT 3000
+#define FORMATS 7
+
+static size_t encode(varintScanFormat format, uint8_t *dst, uint64_t val) {
+    varintWidth len = 0;
+    switch (format) {
+    case VARINT_SCAN_TAGGED:
+        len = varintTaggedPut64(dst, val);
+        break;
+    case VARINT_SCAN_CHAINED:
+        len = varintChainedPutVarint(dst, val);
+        break;
+    case VARINT_SCAN_CHAINED_SIMPLE:
+        len = varintChainedSimpleEncode64(dst, val);
+        break;
+    case VARINT_SCAN_SPLIT:
+        varintSplitPut_(dst, len, val);
+        break;
+    case VARINT_SCAN_SPLIT_FULL:
+        varintSplitFullPut_(dst, len, val);
+        break;
+    case VARINT_SCAN_SPLIT_FULL_NO_ZERO:
+        varintSplitFullNoZeroPut_(dst, len, val ? val : 1);
+        break;
+    case VARINT_SCAN_SPLIT_FULL_16:
+        varintSplitFull16Put_(dst, len, val);
+        break;
+    }
+
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(7);
+
+    static uint64_t vals[COUNT];
+    static uint8_t stream[COUNT * 9];
+    static size_t offsets[COUNT + 1];
+    for (size_t i = 0; i < COUNT; i++) {
+        /* Long runs of one byte values broken up by every wider width */
+        vals[i] = (i / 100) % 2 ? ctestRandom() % 60 : ctestRandomWidth();
+    }
+
+    for (size_t f = 0; f < FORMATS; f++) {
+        const varintScanFormat format = (varintScanFormat)f;
+        size_t len = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            offsets[i] = len;
+            len += encode(format, stream + len, vals[i]);
+        }
+
+        offsets[COUNT] = len;
+
+        TEST("whole buffers validate and count every value") {
+            size_t count;
+            if (!varintScanValidate(format, stream, len, &count) ||
+                count != COUNT) {
+                ERR("Format %zu: validated %zu values!", f, count);
+            }
+        }
+
+        TEST("truncated buffers stop at the last whole value") {
+            size_t entry = 0;
+            for (size_t cut = 0; cut <= len; cut++) {
+                while (entry < COUNT && offsets[entry + 1] <= cut) {
+                    entry++;
+                }
+
+                size_t count;
+                const size_t prefix =
+                    varintScanPrefix(format, stream, cut, &count);
+                if (prefix != offsets[entry] || count != entry) {
+                    ERR("Format %zu cut %zu: prefix %zu count %zu!", f, cut,
+                        prefix, count);
+                    break;
+                }
+
+                if (varintScanValidate(format, stream, cut, NULL) !=
+                    (cut == offsets[entry])) {
+                    ERR("Format %zu cut %zu: wrong validation!", f, cut);
+                    break;
+                }
+            }
+        }
+
+        TEST("skip lands on value boundaries") {
+            for (size_t n = 0; n <= COUNT + 1; n += 1 + ctestRandom() % 40) {
+                size_t skipped;
+                const size_t offset =
+                    varintScanSkip(format, stream, len, n, &skipped);
+                const size_t expected = n < COUNT ? n : COUNT;
+                if (offset != offsets[expected] || skipped != expected) {
+                    ERR("Format %zu: skip %zu landed at %zu (%zu skipped)!",
+                        f, n, offset, skipped);
+                }
+            }
+        }
+    }
+
+    TEST("unused type bytes are rejected") {
+        static const struct {
+            varintScanFormat format;
+            uint8_t bad;
+        } invalid[] = {
+            {VARINT_SCAN_SPLIT, 0x80},
+            {VARINT_SCAN_SPLIT, 0x89},
+            {VARINT_SCAN_SPLIT, 0xc0},
+            {VARINT_SCAN_SPLIT_FULL, 0xc0},
+            {VARINT_SCAN_SPLIT_FULL, 0xc9},
+            {VARINT_SCAN_SPLIT_FULL_NO_ZERO, 0xff},
+            {VARINT_SCAN_SPLIT_FULL_16, 0xc0},
+            {VARINT_SCAN_SPLIT_FULL_16, 0xd0},
+        };
+
+        for (size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+            /* Bad type byte after 100 one byte values (SIMD runs) */
+            uint8_t buf[200] = {0};
+            const size_t at = invalid[i].format == VARINT_SCAN_SPLIT_FULL_16
+                                  ? 200 - 20
+                                  : 100;
+            buf[at] = invalid[i].bad;
+            size_t count;
+            if (varintScanPrefix(invalid[i].format, buf, sizeof(buf),
+                                 &count) != at) {
+                ERR("Format %d accepted type byte 0x%02x!",
+                    invalid[i].format, invalid[i].bad);
+            }
+        }
+    }
+
+    TEST("chained scanning matches a byte at a time reference") {
+        static uint8_t noise[4096];
+        for (size_t round = 0; round < 50; round++) {
+            /* Mostly high bits so varints run to the nine byte limit */
+            const uint64_t density = 1 + round % 16;
+            for (size_t i = 0; i < sizeof(noise); i++) {
+                noise[i] = (uint8_t)ctestRandom();
+                if (ctestRandom() % 16 < density) {
+                    noise[i] |= 0x80;
+                }
+            }
+
+            const size_t len = ctestRandom() % sizeof(noise);
+            size_t expectedCount = 0;
+            size_t expectedEnd = 0;
+            size_t pending = 0;
+            for (size_t i = 0; i < len; i++) {
+                if (!(noise[i] & 0x80) || ++pending == 9) {
+                    expectedCount++;
+                    expectedEnd = i + 1;
+                    pending = 0;
+                }
+            }
+
+            size_t count;
+            const size_t prefix =
+                varintScanPrefix(VARINT_SCAN_CHAINED, noise, len, &count);
+            if (prefix != expectedEnd || count != expectedCount) {
+                ERR("Round %zu: prefix %zu count %zu, expected %zu %zu!",
+                    round, prefix, count, expectedEnd, expectedCount);
+            }
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
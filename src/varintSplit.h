@@ -69,6 +69,8 @@ __BEGIN_DECLS
  *      Unsigned numeric value less than or equal to:
  *        2^64 - 1 = 18446744073709551615
  * Currently unused: |10001001| to |10011111|
+ *   (varintSplitValue.h assigns these, plus the user ranges below, to
+ *    negative integers, floats, doubles, bools, null, and strings.)
  * Note: |10100000| to |10111111| is reserved for a 'first type'
  * encoding with embedded user data as noted above. */
 
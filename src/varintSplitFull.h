@@ -279,6 +279,81 @@ typedef enum varintSplitFullByte {
         }                                                                      \
     } while (0)
 
+/* ====================================================================
+ * SplitFull128 varints
+ * ==================================================================== */
+/* varint model SplitFull128 Container:
+ *   Type encoded inside: first byte
+ *   Size: 1 byte to 17 bytes
+ *   Layout: same as SplitFull
+ *   Meaning: SplitFull extended into its unused type bytes.  Values up to
+ *            UINT64_MAX encode exactly as varintSplitFullPut_() writes
+ *            them; larger values use type bytes |11001001| to |11010000|
+ *            for 9 to 16 byte external widths.
+ *   Pro: existing SplitFull data decodes unchanged as SplitFull128.
+ *   Con: 17 bytes for a full width __uint128_t. */
+
+/* External width is the type byte minus the VAR prefix.  For widths 1 to 8
+ * that equals the low four bits SplitFull reads. */
+#define varintSplitFull128EncodingWidthBytesExternal_(p)                       \
+    (varintWidth)((p)[0] - VARINT_SPLIT_FULL_VAR)
+
+#define varintSplitFull128ExternalWidth_(width, _val)                          \
+    do {                                                                       \
+        __uint128_t _vimp_v128 = (_val);                                       \
+        (width) = VARINT_WIDTH_8B;                                             \
+        while ((_vimp_v128 >>= 8) != 0) {                                      \
+            (width)++;                                                         \
+        }                                                                      \
+    } while (0)
+
+#define varintSplitFull128Length_(encodedLen, _val)                            \
+    do {                                                                       \
+        __uint128_t _vimp_val128 = (_val);                                     \
+        if (_vimp_val128 <= UINT64_MAX) {                                      \
+            varintSplitFullLength_((encodedLen), (uint64_t)_vimp_val128);      \
+        } else {                                                               \
+            varintWidth _vimp_width128;                                        \
+            varintSplitFull128ExternalWidth_(                                  \
+                _vimp_width128, _vimp_val128 - VARINT_SPLIT_FULL_MAX_22);      \
+            (encodedLen) = 1 + _vimp_width128;                                 \
+        }                                                                      \
+    } while (0)
+
+#define varintSplitFull128Put_(dst, encodedLen, _val)                          \
+    do {                                                                       \
+        __uint128_t _vimp_val128 = (_val);                                     \
+        if (_vimp_val128 <= UINT64_MAX) {                                      \
+            varintSplitFullPut_((dst), (encodedLen), (uint64_t)_vimp_val128);  \
+        } else {                                                               \
+            _vimp_val128 -= VARINT_SPLIT_FULL_MAX_22;                          \
+            varintWidth _vimp_width128;                                        \
+            varintSplitFull128ExternalWidth_(_vimp_width128, _vimp_val128);    \
+            (dst)[0] = VARINT_SPLIT_FULL_VAR + _vimp_width128;                 \
+            varintExternalPutFixedWidthBig((dst) + 1, _vimp_val128,            \
+                                           _vimp_width128);                    \
+            (encodedLen) = 1 + _vimp_width128;                                 \
+        }                                                                      \
+    } while (0)
+
+#define varintSplitFull128GetLenQuick_(ptr)                                    \
+    (1 + (varintSplitFullEncoding2_(ptr) == VARINT_SPLIT_FULL_VAR              \
+              ? varintSplitFull128EncodingWidthBytesExternal_(ptr)             \
+              : (ptr)[0] >> 6))
+
+#define varintSplitFull128Get_(ptr, valsize, val)                              \
+    do {                                                                       \
+        if (varintSplitFullEncoding2_(ptr) == VARINT_SPLIT_FULL_VAR) {         \
+            (valsize) = 1 + varintSplitFull128EncodingWidthBytesExternal_(ptr);\
+            (val) = varintBigExternalGet((ptr) + 1, (valsize)-1);              \
+            (val) += VARINT_SPLIT_FULL_MAX_22; /* Restore MAX_22 */            \
+        } else {                                                               \
+            uint64_t _vimp_val64;                                              \
+            varintSplitFullGet_((ptr), (valsize), _vimp_val64);                \
+            (val) = _vimp_val64;                                               \
+        }                                                                      \
+    } while (0)
+
 /* ====================================================================
  * Reversed SplitFull varints
  * ==================================================================== */
@@ -0,0 +1,270 @@
+#include "varintSplitValue.h"
+
+/* Every type byte maps to exactly one value type, so decoding is a single
+ * table lookup followed by one switch.  Bytes not listed are INVALID. */
+#define U VARINT_SPLIT_VALUE_UNSIGNED
+#define N VARINT_SPLIT_VALUE_NEGATIVE
+#define S VARINT_SPLIT_VALUE_STRING
+#define X VARINT_SPLIT_VALUE_INVALID
+/* clang-format off */
+const uint8_t varintSplitValueTypeByByte[256] = {
+    /* 00pppppp: 6 bit unsigned */
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    /* 01pppppp: 14 bit unsigned */
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    /* 10000000 unused, 10000001 to 10001000 unsigned external,
+     * 10001001 to 10010000 negative external */
+    X, U, U, U, U, U, U, U, U, N, N, N, N, N, N, N,
+    /* 10010000 negative external, float, double, false, true, null,
+     * long string, then unused */
+    N, VARINT_SPLIT_VALUE_FLOAT, VARINT_SPLIT_VALUE_DOUBLE,
+    VARINT_SPLIT_VALUE_BOOL, VARINT_SPLIT_VALUE_BOOL, VARINT_SPLIT_VALUE_NULL,
+    S, X, X, X, X, X, X, X, X, X,
+    /* 101nnnnn: small negative */
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,
+    /* 11LLLLLL: short string */
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+};
+/* clang-format on */
+#undef U
+#undef N
+#undef S
+#undef X
+
+size_t varintSplitValuePutUnsigned(uint8_t *dst, uint64_t v) {
+    uint8_t len;
+    varintSplitPut_(dst, len, v);
+    return len;
+}
+
+size_t varintSplitValuePutSigned(uint8_t *dst, int64_t v) {
+    if (v >= 0) {
+        return varintSplitValuePutUnsigned(dst, (uint64_t)v);
+    }
+
+    /* Bitwise NOT maps -1 to 0, -2 to 1, ..., INT64_MIN to INT64_MAX
+     * without the overflow of negating INT64_MIN. */
+    uint64_t magnitude = ~(uint64_t)v;
+    if (magnitude <= VARINT_SPLIT_VALUE_MAX_NEG_SMALL) {
+        dst[0] = VARINT_SPLIT_VALUE_BYTE_NEG_SMALL | magnitude;
+        return 1;
+    }
+
+    magnitude -= VARINT_SPLIT_VALUE_MAX_NEG_SMALL + 1;
+
+    varintWidth width;
+    varintExternalUnsignedEncoding(magnitude, width);
+    dst[0] = VARINT_SPLIT_VALUE_BYTE_NEG_VAR_START__ + width;
+    varintExternalPutFixedWidthQuickMedium_(dst + 1, magnitude, width);
+    return 1 + width;
+}
+
+size_t varintSplitValuePutFloat(uint8_t *dst, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    dst[0] = VARINT_SPLIT_VALUE_BYTE_FLOAT;
+    varintExternalPutFixedWidth(dst + 1, bits, VARINT_WIDTH_32B);
+    return 1 + sizeof(bits);
+}
+
+size_t varintSplitValuePutDouble(uint8_t *dst, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    dst[0] = VARINT_SPLIT_VALUE_BYTE_DOUBLE;
+    varintExternalPutFixedWidth(dst + 1, bits, VARINT_WIDTH_64B);
+    return 1 + sizeof(bits);
+}
+
+size_t varintSplitValuePutBool(uint8_t *dst, bool v) {
+    dst[0] = v ? VARINT_SPLIT_VALUE_BYTE_TRUE : VARINT_SPLIT_VALUE_BYTE_FALSE;
+    return 1;
+}
+
+size_t varintSplitValuePutNull(uint8_t *dst) {
+    dst[0] = VARINT_SPLIT_VALUE_BYTE_NULL;
+    return 1;
+}
+
+size_t varintSplitValuePutString(uint8_t *dst, const void *s, size_t len) {
+    size_t headerLen;
+    if (len <= VARINT_SPLIT_VALUE_MAX_STRING_SHORT) {
+        dst[0] = VARINT_SPLIT_VALUE_BYTE_STRING_SHORT | len;
+        headerLen = 1;
+    } else {
+        uint8_t lenLen;
+        dst[0] = VARINT_SPLIT_VALUE_BYTE_STRING;
+        varintSplitPut_(dst + 1, lenLen, len);
+        headerLen = 1 + lenLen;
+    }
+
+    memcpy(dst + headerLen, s, len);
+    return headerLen + len;
+}
+
+size_t varintSplitValuePut(uint8_t *dst, const varintSplitValue *v) {
+    switch (v->type) {
+    case VARINT_SPLIT_VALUE_UNSIGNED:
+        return varintSplitValuePutUnsigned(dst, v->data.u);
+    case VARINT_SPLIT_VALUE_NEGATIVE:
+        return varintSplitValuePutSigned(dst, v->data.i);
+    case VARINT_SPLIT_VALUE_FLOAT:
+        return varintSplitValuePutFloat(dst, v->data.f);
+    case VARINT_SPLIT_VALUE_DOUBLE:
+        return varintSplitValuePutDouble(dst, v->data.d);
+    case VARINT_SPLIT_VALUE_BOOL:
+        return varintSplitValuePutBool(dst, v->data.b);
+    case VARINT_SPLIT_VALUE_NULL:
+        return varintSplitValuePutNull(dst);
+    case VARINT_SPLIT_VALUE_STRING:
+        return varintSplitValuePutString(dst, v->data.string.start,
+                                         v->data.string.len);
+    default:
+        return 0;
+    }
+}
+
+/* Return the number of bytes varintSplitValuePut() would write for 'v'. */
+size_t varintSplitValueLen(const varintSplitValue *v) {
+    size_t len;
+    switch (v->type) {
+    case VARINT_SPLIT_VALUE_UNSIGNED:
+        varintSplitLength_(len, v->data.u);
+        return len;
+    case VARINT_SPLIT_VALUE_NEGATIVE: {
+        if (v->data.i >= 0) {
+            varintSplitLength_(len, (uint64_t)v->data.i);
+            return len;
+        }
+
+        const uint64_t magnitude = ~(uint64_t)v->data.i;
+        if (magnitude <= VARINT_SPLIT_VALUE_MAX_NEG_SMALL) {
+            return 1;
+        }
+
+        varintWidth width;
+        varintExternalUnsignedEncoding(
+            magnitude - (VARINT_SPLIT_VALUE_MAX_NEG_SMALL + 1), width);
+        return 1 + width;
+    }
+    case VARINT_SPLIT_VALUE_FLOAT:
+        return 1 + sizeof(float);
+    case VARINT_SPLIT_VALUE_DOUBLE:
+        return 1 + sizeof(double);
+    case VARINT_SPLIT_VALUE_BOOL:
+    case VARINT_SPLIT_VALUE_NULL:
+        return 1;
+    case VARINT_SPLIT_VALUE_STRING:
+        if (v->data.string.len <= VARINT_SPLIT_VALUE_MAX_STRING_SHORT) {
+            return 1 + v->data.string.len;
+        }
+
+        varintSplitLength_(len, v->data.string.len);
+        return 1 + len + v->data.string.len;
+    default:
+        return 0;
+    }
+}
+
+/* Return total encoded length of the value starting at 'src', including
+ * string contents.  Returns 0 for invalid type bytes. */
+size_t varintSplitValueGetLen(const uint8_t *src) {
+    const uint8_t b = src[0];
+    switch (varintSplitValueGetType_(src)) {
+    case VARINT_SPLIT_VALUE_UNSIGNED:
+        return varintSplitGetLenQuick_(src);
+    case VARINT_SPLIT_VALUE_NEGATIVE:
+        if ((b & VARINT_SPLIT_VALUE_NEG_SMALL_MASK) ==
+            VARINT_SPLIT_VALUE_BYTE_NEG_SMALL) {
+            return 1;
+        }
+
+        return 1 + (b - VARINT_SPLIT_VALUE_BYTE_NEG_VAR_START__);
+    case VARINT_SPLIT_VALUE_FLOAT:
+        return 1 + sizeof(float);
+    case VARINT_SPLIT_VALUE_DOUBLE:
+        return 1 + sizeof(double);
+    case VARINT_SPLIT_VALUE_BOOL:
+    case VARINT_SPLIT_VALUE_NULL:
+        return 1;
+    case VARINT_SPLIT_VALUE_STRING:
+        if (b == VARINT_SPLIT_VALUE_BYTE_STRING) {
+            uint64_t len;
+            varintWidth lenLen;
+            varintSplitGet_(src + 1, lenLen, len);
+            return 1 + lenLen + len;
+        }
+
+        return 1 + (b & VARINT_SPLIT_6_MASK);
+    default:
+        return 0;
+    }
+}
+
+/* Decode the value at 'src' into 'v' and return its total encoded length.
+ * Returns 0 (and sets v->type to INVALID) for invalid type bytes. */
+size_t varintSplitValueGet(const uint8_t *src, varintSplitValue *v) {
+    const uint8_t b = src[0];
+    v->type = varintSplitValueGetType_(src);
+    switch (v->type) {
+    case VARINT_SPLIT_VALUE_UNSIGNED: {
+        varintWidth width;
+        varintSplitGet_(src, width, v->data.u);
+        return width;
+    }
+    case VARINT_SPLIT_VALUE_NEGATIVE: {
+        if ((b & VARINT_SPLIT_VALUE_NEG_SMALL_MASK) ==
+            VARINT_SPLIT_VALUE_BYTE_NEG_SMALL) {
+            v->data.i = ~(int64_t)(b & VARINT_SPLIT_VALUE_MAX_NEG_SMALL);
+            return 1;
+        }
+
+        const varintWidth width = b - VARINT_SPLIT_VALUE_BYTE_NEG_VAR_START__;
+        uint64_t magnitude;
+        varintExternalGetQuickMedium_(src + 1, width, magnitude);
+        magnitude += VARINT_SPLIT_VALUE_MAX_NEG_SMALL + 1;
+        v->data.i = (int64_t)~magnitude;
+        return 1 + width;
+    }
+    case VARINT_SPLIT_VALUE_FLOAT: {
+        const uint32_t bits = varintExternalGet(src + 1, VARINT_WIDTH_32B);
+        memcpy(&v->data.f, &bits, sizeof(bits));
+        return 1 + sizeof(bits);
+    }
+    case VARINT_SPLIT_VALUE_DOUBLE: {
+        const uint64_t bits = varintExternalGet(src + 1, VARINT_WIDTH_64B);
+        memcpy(&v->data.d, &bits, sizeof(bits));
+        return 1 + sizeof(bits);
+    }
+    case VARINT_SPLIT_VALUE_BOOL:
+        v->data.b = (b == VARINT_SPLIT_VALUE_BYTE_TRUE);
+        return 1;
+    case VARINT_SPLIT_VALUE_NULL:
+        return 1;
+    case VARINT_SPLIT_VALUE_STRING: {
+        size_t headerLen;
+        if (b == VARINT_SPLIT_VALUE_BYTE_STRING) {
+            varintWidth lenLen;
+            varintSplitGet_(src + 1, lenLen, v->data.string.len);
+            headerLen = 1 + lenLen;
+        } else {
+            v->data.string.len = b & VARINT_SPLIT_6_MASK;
+            headerLen = 1;
+        }
+
+        v->data.string.start = src + headerLen;
+        return headerLen + v->data.string.len;
+    }
+    default:
+        return 0;
+    }
+}
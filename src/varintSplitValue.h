@@ -0,0 +1,130 @@
+#pragma once
+
+#include "varint.h"
+#include "varintExternal.h"
+#include "varintSplit.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * SplitValue typed values
+ * ==================================================================== */
+/* varint model SplitValue Container:
+ *   Type encoded inside: first byte
+ *   Size: 1 byte to (1 + 9 + string length) bytes
+ *   Layout: regular Split varint for unsigned integers, plus typed values
+ *           living in the type byte ranges Split leaves for users.
+ *   Meaning: one type byte decides both the type of the value and the
+ *            width of everything following it.
+ *   Pro: mixed-type rows don't need a separate tag byte in front of each
+ *        varint.  Unsigned integers are bit-for-bit regular Split varints.
+ *   Con: unsigned integers only get the Split ranges (63 in one byte). */
+
+/* SplitValue Data Layout */
+/* ===================== */
+/*
+ * Unsigned integers (unchanged Split varint encodings)
+ * ----------------------------------------------------
+ * |00pppppp|                      0 to 63
+ * |01pppppp|qqqqqqqq|             64 to 16446
+ * |1000wwww|[w bytes]|            16447 to 2^64 - 1 (w is 1 to 8)
+ *
+ * Negative integers
+ * -----------------
+ * |101nnnnn|                      -1 to -32 (value is -(n + 1))
+ * |1000wwww|[w bytes]| with type bytes |10001001| to |10010000|
+ *      w is (type byte - 10001000); the w little endian bytes store
+ *      (-(value + 1) - 32), so -33 is stored as the one byte 0x00.
+ *
+ * Fixed types
+ * -----------
+ * |10010001|[4 bytes]|            IEEE float (little endian bit pattern)
+ * |10010010|[8 bytes]|            IEEE double (little endian bit pattern)
+ * |10010011|                      false
+ * |10010100|                      true
+ * |10010101|                      null
+ * |10010110|[Split varint length]|[bytes]|
+ *                                 string longer than 63 bytes
+ *
+ * Short strings
+ * -------------
+ * |11LLLLLL|[L bytes]|            string of 0 to 63 bytes
+ *
+ * Currently unused: |10000000| and |10010111| to |10011111| */
+
+typedef enum varintSplitValueByte {
+    VARINT_SPLIT_VALUE_BYTE_NEG_VAR_START__ = VARINT_SPLIT_BYTE_8, /* 10001000 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_1, /* 32 + uint8_t;  10001001 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_2, /* 32 + uint16_t; 10001010 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_3, /* 32 + uint24_t; 10001011 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_4, /* 32 + uint32_t; 10001100 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_5, /* 32 + uint40_t; 10001101 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_6, /* 32 + uint48_t; 10001110 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_7, /* 32 + uint56_t; 10001111 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_8, /* 32 + uint64_t; 10010000 */
+    VARINT_SPLIT_VALUE_BYTE_FLOAT,  /* 10010001 */
+    VARINT_SPLIT_VALUE_BYTE_DOUBLE, /* 10010010 */
+    VARINT_SPLIT_VALUE_BYTE_FALSE,  /* 10010011 */
+    VARINT_SPLIT_VALUE_BYTE_TRUE,   /* 10010100 */
+    VARINT_SPLIT_VALUE_BYTE_NULL,   /* 10010101 */
+    VARINT_SPLIT_VALUE_BYTE_STRING, /* 10010110 */
+    VARINT_SPLIT_VALUE_BYTE_NEG_SMALL = 0xa0,    /* 101nnnnn */
+    VARINT_SPLIT_VALUE_BYTE_STRING_SHORT = 0xc0, /* 11LLLLLL */
+} varintSplitValueByte;
+
+/* Mask to grab the top three bits of a type byte for small negatives. */
+#define VARINT_SPLIT_VALUE_NEG_SMALL_MASK 0xe0 /* MASK: 11100000 */
+
+/* Max magnitude offset stored directly in the type byte: 2^5 - 1 */
+#define VARINT_SPLIT_VALUE_MAX_NEG_SMALL (0x1f)
+
+/* Max length of a string stored with its length in the type byte. */
+#define VARINT_SPLIT_VALUE_MAX_STRING_SHORT (0x3f)
+
+typedef enum varintSplitValueType {
+    VARINT_SPLIT_VALUE_INVALID = 0,
+    VARINT_SPLIT_VALUE_UNSIGNED,
+    VARINT_SPLIT_VALUE_NEGATIVE,
+    VARINT_SPLIT_VALUE_FLOAT,
+    VARINT_SPLIT_VALUE_DOUBLE,
+    VARINT_SPLIT_VALUE_BOOL,
+    VARINT_SPLIT_VALUE_NULL,
+    VARINT_SPLIT_VALUE_STRING,
+} varintSplitValueType;
+
+/* A decoded value.  For VARINT_SPLIT_VALUE_STRING, 'data.string.start'
+ * points into the encoded buffer (strings are never copied). */
+typedef struct varintSplitValue {
+    varintSplitValueType type;
+    union {
+        uint64_t u;
+        int64_t i;
+        float f;
+        double d;
+        bool b;
+        struct {
+            const uint8_t *start;
+            size_t len;
+        } string;
+    } data;
+} varintSplitValue;
+
+/* Type lookup by first byte; one table load decides the value type. */
+extern const uint8_t varintSplitValueTypeByByte[256];
+
+#define varintSplitValueGetType_(p)                                            \
+    ((varintSplitValueType)varintSplitValueTypeByByte[(p)[0]])
+
+size_t varintSplitValuePutUnsigned(uint8_t *dst, uint64_t v);
+size_t varintSplitValuePutSigned(uint8_t *dst, int64_t v);
+size_t varintSplitValuePutFloat(uint8_t *dst, float v);
+size_t varintSplitValuePutDouble(uint8_t *dst, double v);
+size_t varintSplitValuePutBool(uint8_t *dst, bool v);
+size_t varintSplitValuePutNull(uint8_t *dst);
+size_t varintSplitValuePutString(uint8_t *dst, const void *s, size_t len);
+size_t varintSplitValuePut(uint8_t *dst, const varintSplitValue *v);
+
+size_t varintSplitValueLen(const varintSplitValue *v);
+size_t varintSplitValueGetLen(const uint8_t *src);
+size_t varintSplitValueGet(const uint8_t *src, varintSplitValue *v);
+
+__END_DECLS
@@ -0,0 +1,157 @@
+#include "varintSplitValue.h"
+
+#include "ctest.h"
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+
+    TEST("unsigned values are regular split varints") {
+        static const uint64_t vals[] = {0,          1,     16446,
+                                        16447,      81981, 123456789,
+                                        0xffffffff, ~0ULL, 1ULL << 40};
+        for (size_t i = 0; i < sizeof(vals) / sizeof(*vals); i++) {
+            uint8_t z[32] = {0};
+            uint8_t zs[32] = {0};
+            uint8_t splitLen;
+            varintSplitPut_(zs, splitLen, vals[i]);
+
+            const size_t len = varintSplitValuePutUnsigned(z, vals[i]);
+            if (len != splitLen || memcmp(z, zs, len)) {
+                ERR("Value %" PRIu64 " didn't encode as split varint!",
+                    vals[i]);
+            }
+
+            varintSplitValue v;
+            if (varintSplitValueGet(z, &v) != len ||
+                v.type != VARINT_SPLIT_VALUE_UNSIGNED || v.data.u != vals[i]) {
+                ERR("Didn't decode unsigned %" PRIu64 "!", vals[i]);
+            }
+        }
+    }
+
+    TEST("negative values round trip with compact widths") {
+        static const int64_t vals[] = {-1,
+                                       -32,
+                                       -33,
+                                       -288,
+                                       -289,
+                                       -70000,
+                                       -1099511627776LL,
+                                       INT64_MIN + 1,
+                                       INT64_MIN};
+        for (size_t i = 0; i < sizeof(vals) / sizeof(*vals); i++) {
+            uint8_t z[32] = {0};
+            const size_t len = varintSplitValuePutSigned(z, vals[i]);
+
+            varintSplitValue desc = {.type = VARINT_SPLIT_VALUE_NEGATIVE};
+            desc.data.i = vals[i];
+            if (varintSplitValueLen(&desc) != len ||
+                varintSplitValueGetLen(z) != len) {
+                ERR("Length mismatch for %" PRIi64 "!", vals[i]);
+            }
+
+            varintSplitValue v;
+            if (varintSplitValueGet(z, &v) != len ||
+                v.type != VARINT_SPLIT_VALUE_NEGATIVE || v.data.i != vals[i]) {
+                ERR("Didn't decode negative %" PRIi64 "!", vals[i]);
+            }
+        }
+
+        uint8_t z[16];
+        if (varintSplitValuePutSigned(z, -32) != 1 ||
+            varintSplitValuePutSigned(z, -33) != 2 ||
+            varintSplitValuePutSigned(z, INT64_MIN) != 9) {
+            ERRR("Negative encodings have wrong widths!");
+        }
+    }
+
+    TEST("floats, doubles, bools, and null") {
+        uint8_t z[64];
+        uint8_t *p = z;
+        p += varintSplitValuePutFloat(p, 3.25f);
+        p += varintSplitValuePutDouble(p, -1.0e300);
+        p += varintSplitValuePutBool(p, true);
+        p += varintSplitValuePutBool(p, false);
+        p += varintSplitValuePutNull(p);
+
+        varintSplitValue v;
+        const uint8_t *r = z;
+        r += varintSplitValueGet(r, &v);
+        if (v.type != VARINT_SPLIT_VALUE_FLOAT || v.data.f != 3.25f) {
+            ERRR("Float didn't round trip!");
+        }
+
+        r += varintSplitValueGet(r, &v);
+        if (v.type != VARINT_SPLIT_VALUE_DOUBLE || v.data.d != -1.0e300) {
+            ERRR("Double didn't round trip!");
+        }
+
+        r += varintSplitValueGet(r, &v);
+        if (v.type != VARINT_SPLIT_VALUE_BOOL || !v.data.b) {
+            ERRR("True didn't round trip!");
+        }
+
+        r += varintSplitValueGet(r, &v);
+        if (v.type != VARINT_SPLIT_VALUE_BOOL || v.data.b) {
+            ERRR("False didn't round trip!");
+        }
+
+        r += varintSplitValueGet(r, &v);
+        if (v.type != VARINT_SPLIT_VALUE_NULL) {
+            ERRR("Null didn't round trip!");
+        }
+
+        if (r != p) {
+            ERR("Decoded %zu bytes, but encoded %zu!", (size_t)(r - z),
+                (size_t)(p - z));
+        }
+    }
+
+    TEST("short and long strings") {
+        uint8_t str[300];
+        for (size_t i = 0; i < sizeof(str); i++) {
+            str[i] = (uint8_t)i;
+        }
+
+        static const size_t lens[] = {0, 1, 63, 64, 299};
+        for (size_t i = 0; i < sizeof(lens) / sizeof(*lens); i++) {
+            uint8_t z[320];
+            const size_t len = varintSplitValuePutString(z, str, lens[i]);
+            if (lens[i] <= VARINT_SPLIT_VALUE_MAX_STRING_SHORT &&
+                len != 1 + lens[i]) {
+                ERR("Short string of %zu bytes used %zu bytes!", lens[i], len);
+            }
+
+            varintSplitValue v;
+            if (varintSplitValueGet(z, &v) != len ||
+                v.type != VARINT_SPLIT_VALUE_STRING ||
+                v.data.string.len != lens[i] ||
+                memcmp(v.data.string.start, str, lens[i]) ||
+                varintSplitValueGetLen(z) != len ||
+                varintSplitValueLen(&v) != len) {
+                ERR("String of %zu bytes didn't round trip!", lens[i]);
+            }
+        }
+    }
+
+    TEST("every type byte has exactly one meaning") {
+        uint8_t z[16] = {0};
+        z[0] = 0x80;
+        if (varintSplitValueGetType_(z) != VARINT_SPLIT_VALUE_INVALID) {
+            ERRR("0x80 should be invalid!");
+        }
+
+        for (int b = 0x97; b <= 0x9f; b++) {
+            z[0] = b;
+            varintSplitValue v;
+            if (varintSplitValueGet(z, &v) != 0) {
+                ERR("Unused type byte %02x decoded as a value!", b);
+            }
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,174 @@
+#include "varintStream.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintTagged.h"
+
+/* ====================================================================
+ * Resumable stream decoding
+ * ==================================================================== */
+void varintStreamDecoderInit(varintStreamDecoder *d,
+                             varintStreamFormat format) {
+    d->format = format;
+    d->have = 0;
+}
+
+/* Return the encoded length of the varint starting at 'p' if it can be
+ * determined from the 'avail' bytes present, otherwise 0. */
+static size_t varintStreamLen_(varintStreamFormat format, const uint8_t *p,
+                               size_t avail) {
+    if (format == VARINT_STREAM_TAGGED) {
+        return varintTaggedGetLen(p);
+    }
+
+    /* Both chained formats end at the first byte without its high bit set,
+     * or after 9 bytes. */
+    const size_t limit = avail < 9 ? avail : 9;
+    for (size_t i = 0; i < limit; i++) {
+        if (!(p[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+
+    return avail >= 9 ? 9 : 0;
+}
+
+static void varintStreamDecode_(varintStreamFormat format, const uint8_t *p,
+                                uint64_t *value) {
+    switch (format) {
+    case VARINT_STREAM_TAGGED:
+        varintTaggedGet64(p, value);
+        break;
+    case VARINT_STREAM_CHAINED:
+        varintChainedGetVarint(p, value);
+        break;
+    case VARINT_STREAM_CHAINED_SIMPLE:
+        varintChainedSimpleDecode64(p, value);
+        break;
+    }
+}
+
+varintStreamResult varintStreamDecoderFeed(varintStreamDecoder *d,
+                                           const uint8_t **src,
+                                           const uint8_t *end,
+                                           uint64_t *value) {
+    const uint8_t *s = *src;
+
+    /* Fast path: nothing buffered and the whole varint is in the input,
+     * so decode in place without copying. */
+    if (d->have == 0 && s < end) {
+        const size_t len = varintStreamLen_(d->format, s, end - s);
+        if (len && len <= (size_t)(end - s)) {
+            varintStreamDecode_(d->format, s, value);
+            *src = s + len;
+            return VARINT_STREAM_OK;
+        }
+    }
+
+    /* Slow path: the varint straddles input pieces, so collect its bytes
+     * until the length is known and satisfied. */
+    while (s < end) {
+        d->buf[d->have++] = *s++;
+        const size_t len = varintStreamLen_(d->format, d->buf, d->have);
+        if (len && len == d->have) {
+            varintStreamDecode_(d->format, d->buf, value);
+            d->have = 0;
+            *src = s;
+            return VARINT_STREAM_OK;
+        }
+    }
+
+    *src = s;
+    return VARINT_STREAM_NEED_MORE;
+}
+
+/* ====================================================================
+ * Length prefixed framing
+ * ==================================================================== */
+size_t varintStreamFrameIov(struct iovec *iov, uint8_t *header,
+                            const void *payload, size_t len) {
+    iov[0].iov_base = header;
+    iov[0].iov_len = varintTaggedPut64(header, len);
+    if (!len) {
+        return 1;
+    }
+
+    iov[1].iov_base = (void *)payload;
+    iov[1].iov_len = len;
+    return 2;
+}
+
+size_t varintStreamFrameIovBatch(struct iovec *iov, uint8_t *headers,
+                                 const struct iovec *payloads, size_t count) {
+    size_t used = 0;
+    bool lastIsHeader = false;
+    for (size_t i = 0; i < count; i++) {
+        const size_t headerLen =
+            varintTaggedPut64(headers, payloads[i].iov_len);
+
+        /* Headers are written back to back, so a header following an
+         * empty payload's header extends the same iovec. */
+        if (lastIsHeader) {
+            iov[used - 1].iov_len += headerLen;
+        } else {
+            iov[used].iov_base = headers;
+            iov[used].iov_len = headerLen;
+            used++;
+        }
+
+        headers += headerLen;
+
+        if (payloads[i].iov_len) {
+            iov[used++] = payloads[i];
+            lastIsHeader = false;
+        } else {
+            lastIsHeader = true;
+        }
+    }
+
+    return used;
+}
+
+void varintStreamFrameReaderInit(varintStreamFrameReader *r) {
+    varintStreamDecoderInit(&r->header, VARINT_STREAM_TAGGED);
+    r->frameLen = 0;
+    r->remaining = 0;
+    r->inPayload = false;
+}
+
+varintStreamResult varintStreamFrameRead(varintStreamFrameReader *r,
+                                         const uint8_t **src,
+                                         const uint8_t *end,
+                                         varintStreamSpan *span) {
+    if (!r->inPayload) {
+        uint64_t frameLen;
+        if (varintStreamDecoderFeed(&r->header, src, end, &frameLen) ==
+            VARINT_STREAM_NEED_MORE) {
+            return VARINT_STREAM_NEED_MORE;
+        }
+
+        r->frameLen = frameLen;
+        r->remaining = frameLen;
+        r->inPayload = true;
+    }
+
+    const size_t avail = end - *src;
+    const size_t take = r->remaining < avail ? r->remaining : avail;
+    if (!take && r->remaining) {
+        return VARINT_STREAM_NEED_MORE;
+    }
+
+    span->data = *src;
+    span->len = take;
+    span->offset = r->frameLen - r->remaining;
+    span->frameLen = r->frameLen;
+
+    r->remaining -= take;
+    *src += take;
+
+    span->frameEnd = !r->remaining;
+    if (span->frameEnd) {
+        r->inPayload = false;
+    }
+
+    return VARINT_STREAM_OK;
+}
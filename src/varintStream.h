@@ -0,0 +1,101 @@
+#pragma once
+
+#include "varint.h"
+
+#include <sys/uio.h>
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Resumable stream decoding
+ * ==================================================================== */
+/* A decoder accepts input in arbitrary pieces (as returned by read()),
+ * so a varint may be split across any number of calls.  Bytes of a
+ * partial varint are held in the decoder (at most 9 bytes); complete
+ * varints inside a piece are decoded directly from the caller's buffer. */
+
+typedef enum varintStreamFormat {
+    VARINT_STREAM_TAGGED = 0,     /* varintTaggedPut64() */
+    VARINT_STREAM_CHAINED,        /* varintChainedPutVarint() */
+    VARINT_STREAM_CHAINED_SIMPLE, /* varintChainedSimpleEncode64() */
+} varintStreamFormat;
+
+typedef enum varintStreamResult {
+    VARINT_STREAM_NEED_MORE = 0, /* input exhausted; feed more bytes */
+    VARINT_STREAM_OK,            /* one result produced */
+} varintStreamResult;
+
+typedef struct varintStreamDecoder {
+    varintStreamFormat format;
+    uint8_t have; /* bytes of a partial varint held in 'buf' */
+    uint8_t buf[9];
+} varintStreamDecoder;
+
+void varintStreamDecoderInit(varintStreamDecoder *d, varintStreamFormat format);
+
+/* Consume bytes from '*src' (up to 'end') until one value completes.
+ * Returns VARINT_STREAM_OK with the value in 'value', or
+ * VARINT_STREAM_NEED_MORE after consuming every byte up to 'end'.
+ * '*src' is advanced past every consumed byte either way. */
+varintStreamResult varintStreamDecoderFeed(varintStreamDecoder *d,
+                                           const uint8_t **src,
+                                           const uint8_t *end,
+                                           uint64_t *value);
+
+/* ====================================================================
+ * Length prefixed framing
+ * ==================================================================== */
+/* A frame is a Tagged varint payload length followed by the payload.
+ *
+ * Writing builds an iovec chain for writev() pointing at the caller's
+ * payloads, so payload bytes are never copied; only the 1 to 9 byte
+ * length headers are written (into caller provided storage).
+ *
+ * Reading returns spans pointing into the caller's input buffer.  A frame
+ * split across reads is returned as several spans, so no reassembly
+ * buffer is needed unless the caller wants one. */
+
+#define VARINT_STREAM_FRAME_HEADER_MAX 9
+
+/* Fill 'iov' with the frame for 'payload' using 'header' (at least
+ * VARINT_STREAM_FRAME_HEADER_MAX bytes) for the length prefix.
+ * Returns iovecs used: 2, or 1 for an empty payload. */
+size_t varintStreamFrameIov(struct iovec *iov, uint8_t *header,
+                            const void *payload, size_t len);
+
+/* Frame 'count' payloads into 'iov' (which must hold 2 * count entries)
+ * with length prefixes written back to back into 'headers' (which must
+ * hold count * VARINT_STREAM_FRAME_HEADER_MAX bytes).  Adjacent headers of
+ * empty payloads share one iovec.  Returns iovecs used; callers must split
+ * the chain across writev() calls if it exceeds IOV_MAX. */
+size_t varintStreamFrameIovBatch(struct iovec *iov, uint8_t *headers,
+                                 const struct iovec *payloads, size_t count);
+
+typedef struct varintStreamFrameReader {
+    varintStreamDecoder header;
+    uint64_t frameLen;
+    uint64_t remaining;
+    bool inPayload;
+} varintStreamFrameReader;
+
+/* A piece of one frame's payload.  'offset' is the position of 'data'
+ * inside the frame; 'frameEnd' is set on the last piece of a frame. */
+typedef struct varintStreamSpan {
+    const uint8_t *data;
+    size_t len;
+    uint64_t offset;
+    uint64_t frameLen;
+    bool frameEnd;
+} varintStreamSpan;
+
+void varintStreamFrameReaderInit(varintStreamFrameReader *r);
+
+/* Produce the next payload span from '*src' (up to 'end').  Returns
+ * VARINT_STREAM_OK with 'span' filled in, or VARINT_STREAM_NEED_MORE once
+ * every byte up to 'end' is consumed.  Empty frames produce one span with
+ * 'len' 0 and 'frameEnd' set. */
+varintStreamResult varintStreamFrameRead(varintStreamFrameReader *r,
+                                         const uint8_t **src,
+                                         const uint8_t *end,
+                                         varintStreamSpan *span);
+
+__END_DECLS
@@ -0,0 +1,178 @@
+#include "varintStream.h"
+#include "varintChained.h"
+#include "varintChainedSimple.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 2000
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(5);
+
+    static uint64_t vals[COUNT];
+    static uint8_t stream[COUNT * 9];
+    for (size_t i = 0; i < COUNT; i++) {
+        vals[i] = ctestRandomWidth();
+    }
+
+    TEST("values split across arbitrary input pieces") {
+        static const varintStreamFormat formats[] = {
+            VARINT_STREAM_TAGGED, VARINT_STREAM_CHAINED,
+            VARINT_STREAM_CHAINED_SIMPLE};
+        for (size_t f = 0; f < 3; f++) {
+            size_t len = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                switch (formats[f]) {
+                case VARINT_STREAM_TAGGED:
+                    len += varintTaggedPut64(stream + len, vals[i]);
+                    break;
+                case VARINT_STREAM_CHAINED:
+                    len += varintChainedPutVarint(stream + len, vals[i]);
+                    break;
+                case VARINT_STREAM_CHAINED_SIMPLE:
+                    len += varintChainedSimpleEncode64(stream + len, vals[i]);
+                    break;
+                }
+            }
+
+            /* Piece sizes of 1 byte (every varint split) up to 17 bytes */
+            for (size_t maxPiece = 1; maxPiece <= 17; maxPiece += 4) {
+                varintStreamDecoder d;
+                varintStreamDecoderInit(&d, formats[f]);
+                size_t decoded = 0;
+                size_t pos = 0;
+                while (pos < len) {
+                    size_t piece = 1 + ctestRandom() % maxPiece;
+                    if (piece > len - pos) {
+                        piece = len - pos;
+                    }
+
+                    const uint8_t *src = stream + pos;
+                    const uint8_t *end = src + piece;
+                    uint64_t value;
+                    while (varintStreamDecoderFeed(&d, &src, end, &value) ==
+                           VARINT_STREAM_OK) {
+                        if (decoded >= COUNT || value != vals[decoded]) {
+                            ERR("Format %zu piece %zu: value %zu mismatch!",
+                                f, maxPiece, decoded);
+                        }
+                        decoded++;
+                    }
+
+                    if (src != end) {
+                        ERRR("NEED_MORE returned without consuming input!");
+                    }
+
+                    pos += piece;
+                }
+
+                if (decoded != COUNT || d.have) {
+                    ERR("Format %zu piece %zu: decoded %zu values!", f,
+                        maxPiece, decoded);
+                }
+            }
+        }
+    }
+
+    TEST("framing round trips through iovecs and split reads") {
+        enum { FRAMES = 200 };
+        static uint8_t payloadBytes[FRAMES * 300];
+        struct iovec payloads[FRAMES];
+        size_t used = 0;
+        for (size_t i = 0; i < FRAMES; i++) {
+            /* Include empty frames, some adjacent */
+            const size_t len = i % 7 < 2 ? 0 : ctestRandom() % 300;
+            for (size_t j = 0; j < len; j++) {
+                payloadBytes[used + j] = (uint8_t)ctestRandom();
+            }
+
+            payloads[i].iov_base = payloadBytes + used;
+            payloads[i].iov_len = len;
+            used += len;
+        }
+
+        struct iovec iov[2 * FRAMES];
+        uint8_t headers[FRAMES * VARINT_STREAM_FRAME_HEADER_MAX];
+        const size_t iovCount =
+            varintStreamFrameIovBatch(iov, headers, payloads, FRAMES);
+
+        /* Flatten the chain as writev() would */
+        static uint8_t wire[FRAMES * (300 + 9)];
+        size_t wireLen = 0;
+        for (size_t i = 0; i < iovCount; i++) {
+            memcpy(wire + wireLen, iov[i].iov_base, iov[i].iov_len);
+            wireLen += iov[i].iov_len;
+        }
+
+        /* Payload iovecs must point at the caller's bytes, not copies */
+        for (size_t i = 0; i < iovCount; i++) {
+            const uint8_t *base = iov[i].iov_base;
+            if (base >= headers && base < headers + sizeof(headers)) {
+                continue;
+            }
+
+            if (base < payloadBytes || base >= payloadBytes + used) {
+                ERR("iovec %zu points at a copy!", i);
+            }
+        }
+
+        for (size_t maxPiece = 1; maxPiece <= 1001; maxPiece += 250) {
+            varintStreamFrameReader r;
+            varintStreamFrameReaderInit(&r);
+            static uint8_t frame[300];
+            size_t frameIdx = 0;
+            size_t pos = 0;
+            while (pos < wireLen) {
+                size_t piece = 1 + ctestRandom() % maxPiece;
+                if (piece > wireLen - pos) {
+                    piece = wireLen - pos;
+                }
+
+                const uint8_t *src = wire + pos;
+                const uint8_t *end = src + piece;
+                varintStreamSpan span;
+                while (varintStreamFrameRead(&r, &src, end, &span) ==
+                       VARINT_STREAM_OK) {
+                    if (span.data < wire || span.data + span.len > end) {
+                        ERRR("Span doesn't point into the input!");
+                    }
+
+                    memcpy(frame + span.offset, span.data, span.len);
+                    if (span.frameEnd) {
+                        if (frameIdx >= FRAMES ||
+                            span.frameLen != payloads[frameIdx].iov_len ||
+                            memcmp(frame, payloads[frameIdx].iov_base,
+                                   span.frameLen)) {
+                            ERR("Piece %zu: frame %zu mismatch!", maxPiece,
+                                frameIdx);
+                        }
+                        frameIdx++;
+                    }
+                }
+
+                pos += piece;
+            }
+
+            if (frameIdx != FRAMES) {
+                ERR("Piece %zu: read %zu frames!", maxPiece, frameIdx);
+            }
+        }
+
+        struct iovec single[2];
+        uint8_t header[VARINT_STREAM_FRAME_HEADER_MAX];
+        if (varintStreamFrameIov(single, header, payloadBytes, 0) != 1 ||
+            varintStreamFrameIov(single, header, payloadBytes, 5000) != 2 ||
+            single[0].iov_len != 3 || single[1].iov_base != payloadBytes) {
+            ERRR("Single frame iovecs are wrong!");
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -15,7 +15,7 @@
 *************************************************************************
 **/
 
-#include "varint.h"
+#include "varintTagged.h"
 
 /*
 **
@@ -441,3 +441,144 @@ varintWidth varintTaggedAddNoGrow(uint8_t *p, int64_t add) {
 varintWidth varintTaggedAddGrow(uint8_t *p, int64_t add) {
     return varintTaggedAdd(p, add, true);
 }
+
+/* ====================================================================
+ * Tagged128
+ * ==================================================================== */
+/* Big-endian 8 byte load and store; compilers reduce these to one
+ * byte-swapped access. */
+static inline uint64_t varintTaggedLoad64BE_(const uint8_t *z) {
+    return ((uint64_t)z[0] << 56) | ((uint64_t)z[1] << 48) |
+           ((uint64_t)z[2] << 40) | ((uint64_t)z[3] << 32) |
+           ((uint64_t)z[4] << 24) | ((uint64_t)z[5] << 16) |
+           ((uint64_t)z[6] << 8) | (uint64_t)z[7];
+}
+
+static inline void varintTaggedStore64BE_(uint8_t *z, uint64_t v) {
+    z[0] = (uint8_t)(v >> 56);
+    z[1] = (uint8_t)(v >> 48);
+    z[2] = (uint8_t)(v >> 40);
+    z[3] = (uint8_t)(v >> 32);
+    z[4] = (uint8_t)(v >> 24);
+    z[5] = (uint8_t)(v >> 16);
+    z[6] = (uint8_t)(v >> 8);
+    z[7] = (uint8_t)v;
+}
+
+/* Bytes needed for 'x' as a big-endian integer (at least 1) */
+static inline varintWidth varintTaggedBytes128_(__uint128_t x) {
+    const uint64_t hi = (uint64_t)(x >> 64);
+    const uint64_t lo = (uint64_t)x;
+    if (hi) {
+        return 16 - __builtin_clzll(hi) / 8;
+    }
+
+    return lo ? 8 - __builtin_clzll(lo) / 8 : 1;
+}
+
+varintWidth varintTaggedLen128(__uint128_t x) {
+    if (x <= VARINT_TAGGED128_MAX_1) {
+        return 1;
+    }
+
+    if (x <= VARINT_TAGGED128_MAX_2) {
+        return 2;
+    }
+
+    if (x <= VARINT_TAGGED128_MAX_3) {
+        return 3;
+    }
+
+    return 1 + varintTaggedBytes128_(x);
+}
+
+varintWidth varintTaggedPut128(uint8_t *z, __uint128_t x) {
+    if (x <= VARINT_TAGGED128_MAX_1) {
+        z[0] = (uint8_t)x;
+        return 1;
+    }
+
+    if (x <= VARINT_TAGGED128_MAX_2) {
+        const uint32_t y = (uint32_t)x - (VARINT_TAGGED128_MAX_1 + 1);
+        z[0] = (uint8_t)(y / 256 + 232);
+        z[1] = (uint8_t)(y % 256);
+        return 2;
+    }
+
+    if (x <= VARINT_TAGGED128_MAX_3) {
+        const uint32_t y = (uint32_t)x - (VARINT_TAGGED128_MAX_2 + 1);
+        z[0] = 240;
+        z[1] = (uint8_t)(y / 256);
+        z[2] = (uint8_t)(y % 256);
+        return 3;
+    }
+
+    const varintWidth n = varintTaggedBytes128_(x);
+    z[0] = (uint8_t)(238 + n);
+    if (n == 16) {
+        varintTaggedStore64BE_(z + 1, (uint64_t)(x >> 64));
+        varintTaggedStore64BE_(z + 9, (uint64_t)x);
+    } else {
+        /* Write all 16 bytes to scratch space, then keep the used tail */
+        uint8_t full[16];
+        varintTaggedStore64BE_(full, (uint64_t)(x >> 64));
+        varintTaggedStore64BE_(full + 8, (uint64_t)x);
+        memcpy(z + 1, full + 16 - n, n);
+    }
+
+    return 1 + n;
+}
+
+varintWidth varintTaggedGet128(const uint8_t *z, __uint128_t *pResult) {
+    if (z[0] <= VARINT_TAGGED128_MAX_1) {
+        *pResult = z[0];
+        return 1;
+    }
+
+    if (z[0] <= 239) {
+        *pResult = (VARINT_TAGGED128_MAX_1 + 1) + 256 * (z[0] - 232) + z[1];
+        return 2;
+    }
+
+    if (z[0] == 240) {
+        *pResult = (VARINT_TAGGED128_MAX_2 + 1) + 256 * z[1] + z[2];
+        return 3;
+    }
+
+    if (z[0] == 255) {
+        return VARINT_WIDTH_INVALID;
+    }
+
+    const varintWidth n = z[0] - 238;
+    if (n == 16) {
+        *pResult = ((__uint128_t)varintTaggedLoad64BE_(z + 1) << 64) |
+                   varintTaggedLoad64BE_(z + 9);
+    } else {
+        uint8_t full[16] = {0};
+        memcpy(full + 16 - n, z + 1, n);
+        *pResult = ((__uint128_t)varintTaggedLoad64BE_(full) << 64) |
+                   varintTaggedLoad64BE_(full + 8);
+    }
+
+    return 1 + n;
+}
+
+size_t varintTaggedPut128Array(uint8_t *z, const __uint128_t *vals,
+                               size_t count) {
+    uint8_t *start = z;
+    for (size_t i = 0; i < count; i++) {
+        z += varintTaggedPut128(z, vals[i]);
+    }
+
+    return z - start;
+}
+
+size_t varintTaggedGet128Array(const uint8_t *z, __uint128_t *vals,
+                               size_t count) {
+    const uint8_t *start = z;
+    for (size_t i = 0; i < count; i++) {
+        z += varintTaggedGet128(z, &vals[i]);
+    }
+
+    return z - start;
+}
@@ -46,6 +46,10 @@ uint64_t varintTaggedGet64ReturnValue(const uint8_t *z);
 varintWidth varintTaggedGet32(const uint8_t *z, uint32_t *pResult);
 varintWidth varintTaggedLen(uint64_t x);
 varintWidth varintTaggedGetLen(const uint8_t *z);
+/* Add 'add' to the varint at 'z' and return its new width.  NoGrow writes
+ * nothing if the result needs more bytes; Grow writes the wider result over
+ * whatever follows 'z', so the caller must own those bytes.  To grow values
+ * inside a sequence, use varintRopeAdd() instead. */
 varintWidth varintTaggedAddNoGrow(uint8_t *z, int64_t add);
 varintWidth varintTaggedAddGrow(uint8_t *z, int64_t add);
 
@@ -88,4 +92,47 @@ varintWidth varintTaggedAddGrow(uint8_t *z, int64_t add);
                : (src)[0] == 249 ? 2288U + 256 * (src)[1] + (src)[2]           \
                                  : varintTaggedGet64ReturnValue(src))
 
+/* ====================================================================
+ * Tagged128 varints
+ * ==================================================================== */
+/* varint model Tagged128 Container:
+ *   Type encoded inside: first byte of varint
+ *   Size: 1 byte to 17 bytes
+ *   Layout: big endian (can sort compare by memcmp())
+ *   Meaning: full width known by first byte. First byte also stores value.
+ *   Pro: one varint holds a full UUID or IPv6 address (17 bytes) instead
+ *        of two 64-bit varints (up to 18 bytes and two type bytes to read).
+ *   Con: not interchangeable with Tagged; every type byte of Tagged is
+ *        already taken, so Tagged128 gives up some one byte values for
+ *        its wider type bytes.
+ *
+ * Treat each byte of the encoding as an integer between 0 and 255.
+ * Let the bytes of the encoding be called A0, A1, A2, ..., A16.
+ *
+ *   A0 between 0 and 231: the value is A0.
+ *   A0 between 232 and 239: the value is 232+256*(A0-232)+A1.
+ *   A0 of 240: the value is 2280+256*A1+A2.
+ *   A0 between 241 and 254: the value is the next A0-238 bytes as a
+ *                           big-endian integer (3 to 16 bytes).
+ *   A0 of 255: reserved. */
+
+#define VARINT_TAGGED128_MAX_1 231U
+#define VARINT_TAGGED128_MAX_2 2279U
+#define VARINT_TAGGED128_MAX_3 67815U
+
+varintWidth varintTaggedPut128(uint8_t *z, __uint128_t x);
+varintWidth varintTaggedGet128(const uint8_t *z, __uint128_t *pResult);
+varintWidth varintTaggedLen128(__uint128_t x);
+
+/* Returns 0 for the reserved type byte 255 */
+#define varintTaggedGetLen128Quick_(z)                                         \
+    ((z)[0] <= 231 ? 1 : (z)[0] <= 239 ? 2 : (z)[0] == 255 ? 0 : (z)[0] - 237)
+
+/* Bulk encode and decode of 'count' values back to back.
+ * Each returns the number of bytes written or read. */
+size_t varintTaggedPut128Array(uint8_t *z, const __uint128_t *vals,
+                               size_t count);
+size_t varintTaggedGet128Array(const uint8_t *z, __uint128_t *vals,
+                               size_t count);
+
 __END_DECLS
@@ -0,0 +1,172 @@
+#include "varintTaggedSearch.h"
+#include "varintTagged.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+int varintTaggedSearchCompare(const uint8_t *a, const uint8_t *b) {
+    if (a[0] != b[0]) {
+        return a[0] < b[0] ? -1 : 1;
+    }
+
+    /* Same first byte means same length. */
+    return memcmp(a + 1, b + 1, varintTaggedGetLenQuick_(a) - 1);
+}
+
+size_t varintTaggedSearchIndexBuild(const uint8_t *src, size_t len,
+                                    size_t stride, size_t *offsets) {
+    size_t checkpoints = 0;
+    size_t entry = 0;
+    for (size_t offset = 0; offset < len;
+         offset += varintTaggedGetLenQuick_(src + offset)) {
+        if (entry++ % stride == 0) {
+            offsets[checkpoints++] = offset;
+        }
+    }
+
+    return checkpoints;
+}
+
+/* Starting at entry 'position' (at byte 'offset'), advance past every entry
+ * smaller than the encoded 'key', stopping at byte 'end'. */
+static size_t varintTaggedSearchScan_(const uint8_t *src, size_t end,
+                                      size_t offset, const uint8_t *key,
+                                      size_t *position) {
+    size_t entry = *position;
+#if defined(__SSE2__)
+    /* Gather the first bytes of the next 16 entries and compare them all
+     * against key[0] at once.  The stream is sorted, so entries whose first
+     * byte is smaller than key[0] are a prefix of the 16 and all of them are
+     * smaller than the key; the scalar loop below resolves the entry where
+     * that prefix ends. */
+    const __m128i keyFirst = _mm_set1_epi8((char)key[0]);
+    while (offset < end) {
+        uint8_t firsts[16];
+        size_t at[16];
+        size_t n = 0;
+        size_t next = offset;
+        while (n < 16 && next < end) {
+            at[n] = next;
+            firsts[n++] = src[next];
+            next += varintTaggedGetLenQuick_(src + next);
+        }
+
+        memset(firsts + n, 0xff, 16 - n);
+        const __m128i candidates = _mm_loadu_si128((const __m128i *)firsts);
+
+        /* Unsigned first < key[0] iff max(first, key[0]) == key[0] and
+         * first != key[0] */
+        const __m128i atMost = _mm_cmpeq_epi8(
+            _mm_max_epu8(candidates, keyFirst), keyFirst);
+        const __m128i equal = _mm_cmpeq_epi8(candidates, keyFirst);
+        const uint32_t smaller =
+            (uint32_t)_mm_movemask_epi8(_mm_andnot_si128(equal, atMost)) &
+            ((1U << n) - 1);
+        const size_t skip = __builtin_popcount(smaller);
+        entry += skip;
+        if (skip < n) {
+            offset = at[skip];
+            break;
+        }
+
+        offset = next;
+    }
+#endif
+
+    while (offset < end) {
+        const uint8_t first = src[offset];
+        if (first > key[0] ||
+            (first == key[0] &&
+             varintTaggedSearchCompare(src + offset, key) >= 0)) {
+            break;
+        }
+
+        offset += varintTaggedGetLenQuick_(src + offset);
+        entry++;
+    }
+
+    *position = entry;
+    return offset < end ? offset : end;
+}
+
+size_t varintTaggedSearchLowerBound(const uint8_t *src, size_t len,
+                                    const size_t *offsets,
+                                    size_t checkpoints, size_t stride,
+                                    uint64_t key, size_t *position) {
+    uint8_t encodedKey[9];
+    varintTaggedPut64(encodedKey, key);
+
+    /* Find the last checkpoint whose entry is smaller than the key; the
+     * lower bound is between it and the next checkpoint. */
+    size_t lo = 0;
+    size_t hi = checkpoints;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (varintTaggedSearchCompare(src + offsets[mid], encodedKey) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* 'lo' is the first checkpoint >= key, so scanning starts one before
+     * and covers at most 'stride' entries, ending at checkpoint 'lo'. */
+    size_t entry = 0;
+    size_t offset = 0;
+    if (lo > 0) {
+        entry = (lo - 1) * stride;
+        offset = offsets[lo - 1];
+    }
+
+    const size_t end = lo < checkpoints ? offsets[lo] : len;
+    offset = varintTaggedSearchScan_(src, end, offset, encodedKey, &entry);
+    if (position) {
+        *position = entry;
+    }
+
+    return offset;
+}
+
+size_t varintTaggedSearchMergeJoin(const uint8_t *a, size_t aLen,
+                                   const uint8_t *b, size_t bLen,
+                                   varintTaggedSearchMatchFn *match,
+                                   void *ctx) {
+    size_t ai = 0;
+    size_t bi = 0;
+    size_t matches = 0;
+    while (ai < aLen && bi < bLen) {
+        const int cmp = varintTaggedSearchCompare(a + ai, b + bi);
+        if (cmp < 0) {
+            ai += varintTaggedGetLenQuick_(a + ai);
+        } else if (cmp > 0) {
+            bi += varintTaggedGetLenQuick_(b + bi);
+        } else {
+            /* Equal entries are byte-identical, so runs of duplicates are
+             * found by comparing against the first entry of each run. */
+            const size_t width = varintTaggedGetLenQuick_(a + ai);
+            size_t bEnd = bi;
+            while (bEnd < bLen && b[bEnd] == b[bi] &&
+                   !memcmp(b + bEnd, b + bi, width)) {
+                bEnd += width;
+            }
+
+            const uint8_t *runStart = a + ai;
+            while (ai < aLen && a[ai] == runStart[0] &&
+                   !memcmp(a + ai, runStart, width)) {
+                for (size_t bj = bi; bj < bEnd; bj += width) {
+                    matches++;
+                    if (!match(ctx, a + ai, b + bj)) {
+                        return matches;
+                    }
+                }
+
+                ai += width;
+            }
+
+            bi = bEnd;
+        }
+    }
+
+    return matches;
+}
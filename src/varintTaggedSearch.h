@@ -0,0 +1,49 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Searching sorted Tagged varint streams
+ * ==================================================================== */
+/* A sorted stream is Tagged varints written back to back in ascending
+ * order.  Because Tagged varints are big endian and their first byte
+ * determines their length, two encoded values compare by:
+ *   - first byte, then (if first bytes match, so lengths match)
+ *   - memcmp() of the remaining bytes.
+ * Nothing here decodes stored values; the search key is encoded once and
+ * compared against stored bytes directly.
+ *
+ * The checkpoint index holds the byte offset of every 'stride'-th entry
+ * (offsets[i] is the offset of entry i * stride). */
+
+/* Compare two encoded Tagged varints.  Returns <0, 0, or >0. */
+int varintTaggedSearchCompare(const uint8_t *a, const uint8_t *b);
+
+/* Write checkpoint offsets for 'src' into 'offsets' and return how many
+ * were written.  'offsets' must hold (len + stride - 1) / stride entries
+ * (every entry is at least one byte, so this is always enough). */
+size_t varintTaggedSearchIndexBuild(const uint8_t *src, size_t len,
+                                    size_t stride, size_t *offsets);
+
+/* Find the first entry >= 'key'.  Returns its byte offset (or 'len' if
+ * every entry is smaller) and, if 'position' is non-NULL, sets it to the
+ * entry's index.  'offsets', 'checkpoints', and 'stride' describe the
+ * checkpoint index built by varintTaggedSearchIndexBuild(). */
+size_t varintTaggedSearchLowerBound(const uint8_t *src, size_t len,
+                                    const size_t *offsets,
+                                    size_t checkpoints, size_t stride,
+                                    uint64_t key, size_t *position);
+
+/* Merge-join two sorted streams.  For every pair of equal entries (the
+ * cross product of equal runs), 'match' is called with pointers to the
+ * encoded entries in each stream.  If 'match' returns false the join
+ * stops early.  Returns the number of matches reported. */
+typedef bool varintTaggedSearchMatchFn(void *ctx, const uint8_t *a,
+                                       const uint8_t *b);
+size_t varintTaggedSearchMergeJoin(const uint8_t *a, size_t aLen,
+                                   const uint8_t *b, size_t bLen,
+                                   varintTaggedSearchMatchFn *match,
+                                   void *ctx);
+
+__END_DECLS
@@ -0,0 +1,157 @@
+#include "varintTaggedSearch.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+#define COUNT 3000
+
+static int cmpU64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static size_t encodeSorted(uint64_t *vals, size_t count, uint8_t *dst) {
+    qsort(vals, count, sizeof(*vals), cmpU64);
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        len += varintTaggedPut64(dst + len, vals[i]);
+    }
+
+    return len;
+}
+
+typedef struct joinState {
+    size_t matches;
+    bool mismatch;
+} joinState;
+
+static bool countJoin(void *ctx, const uint8_t *a, const uint8_t *b) {
+    joinState *state = ctx;
+    uint64_t x;
+    uint64_t y;
+    varintTaggedGet64(a, &x);
+    varintTaggedGet64(b, &y);
+    state->mismatch |= x != y;
+    state->matches++;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+
+    static uint64_t vals[COUNT];
+    static uint8_t stream[COUNT * 9];
+    static size_t offsets[COUNT];
+    ctestSeed(11);
+    for (size_t i = 0; i < COUNT; i++) {
+        /* Mostly one byte values plus every wider width */
+        vals[i] = i % 3 ? ctestRandom() % 230 : ctestRandomWidth();
+    }
+
+    const size_t len = encodeSorted(vals, COUNT, stream);
+
+    TEST("lower bound matches a linear search") {
+        static const size_t strides[] = {1, 7, 64, COUNT};
+        for (size_t s = 0; s < sizeof(strides) / sizeof(*strides); s++) {
+            const size_t checkpoints =
+                varintTaggedSearchIndexBuild(stream, len, strides[s], offsets);
+            if (checkpoints != (COUNT + strides[s] - 1) / strides[s]) {
+                ERR("Stride %zu built %zu checkpoints!", strides[s],
+                    checkpoints);
+            }
+
+            for (size_t k = 0; k < 2000; k++) {
+                uint64_t key;
+                if (k % 4 == 0) {
+                    key = vals[ctestRandom() % COUNT];
+                } else if (k % 4 == 1) {
+                    key = ctestRandom() % 250;
+                } else {
+                    key = ctestRandomWidth();
+                }
+
+                size_t expected = 0;
+                size_t expectedOffset = 0;
+                while (expected < COUNT && vals[expected] < key) {
+                    expectedOffset += varintTaggedLen(vals[expected]);
+                    expected++;
+                }
+
+                size_t position;
+                const size_t offset = varintTaggedSearchLowerBound(
+                    stream, len, offsets, checkpoints, strides[s], key,
+                    &position);
+                if (position != expected || offset != expectedOffset) {
+                    ERR("Stride %zu key %" PRIu64
+                        ": got entry %zu, expected %zu!",
+                        strides[s], key, position, expected);
+                }
+            }
+
+            size_t position;
+            if (varintTaggedSearchLowerBound(stream, len, offsets,
+                                             checkpoints, strides[s],
+                                             UINT64_MAX, &position) != len &&
+                vals[COUNT - 1] != UINT64_MAX) {
+                ERRR("Key above every entry should return len!");
+            }
+
+            if (varintTaggedSearchLowerBound(stream, len, offsets,
+                                             checkpoints, strides[s], 0,
+                                             &position) != 0 ||
+                position != 0) {
+                ERRR("Key 0 should return the first entry!");
+            }
+        }
+    }
+
+    TEST("merge join matches a nested loop join") {
+        static uint64_t other[COUNT / 2];
+        static uint8_t otherStream[COUNT / 2 * 9];
+        for (size_t i = 0; i < COUNT / 2; i++) {
+            other[i] =
+                i % 2 ? vals[ctestRandom() % COUNT] : ctestRandom() % 300;
+        }
+
+        const size_t otherLen = encodeSorted(other, COUNT / 2, otherStream);
+
+        size_t expected = 0;
+        for (size_t i = 0, j = 0; i < COUNT && j < COUNT / 2;) {
+            if (vals[i] < other[j]) {
+                i++;
+            } else if (vals[i] > other[j]) {
+                j++;
+            } else {
+                size_t iEnd = i;
+                size_t jEnd = j;
+                while (iEnd < COUNT && vals[iEnd] == vals[i]) {
+                    iEnd++;
+                }
+
+                while (jEnd < COUNT / 2 && other[jEnd] == other[j]) {
+                    jEnd++;
+                }
+
+                expected += (iEnd - i) * (jEnd - j);
+                i = iEnd;
+                j = jEnd;
+            }
+        }
+
+        joinState state = {0};
+        const size_t matches = varintTaggedSearchMergeJoin(
+            stream, len, otherStream, otherLen, countJoin, &state);
+        if (matches != expected || state.matches != expected ||
+            state.mismatch) {
+            ERR("Join found %zu matches, expected %zu!", matches, expected);
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}
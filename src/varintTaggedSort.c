@@ -0,0 +1,431 @@
+#define _GNU_SOURCE
+#include "varintTaggedSort.h"
+#include "varintTagged.h"
+#include "varintTaggedSearch.h"
+#include "varintThreads.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Buckets this small finish with insertion sort */
+#define INSERTION_MAX 32
+
+/* Fewest keys worth starting a thread for */
+#define MIN_PER_THREAD 65536
+
+/* Parallel sorts split buckets until each is at most 1 / (threads *
+ * TASKS_PER_THREAD) of all keys, so threads end up with similar loads */
+#define TASKS_PER_THREAD 8
+
+static uint32_t varintTaggedSortKeyLen_(uint8_t first) {
+    return varintTaggedGetLenQuick_(&first);
+}
+
+/* ====================================================================
+ * Serial radix sort
+ * ==================================================================== */
+/* Order of two keys whose first 'depth' bytes are equal.  Past depth 0
+ * every key in the bucket is 'len' bytes long. */
+static int varintTaggedSortCompare_(const uint8_t *a, const uint8_t *b,
+                                    uint32_t depth, uint32_t len) {
+    if (!depth) {
+        return varintTaggedSearchCompare(a, b);
+    }
+
+    return memcmp(a + depth, b + depth, len - depth);
+}
+
+static void varintTaggedSortInsertion_(const uint8_t *src, size_t *offs,
+                                       size_t n, uint32_t depth,
+                                       uint32_t len) {
+    for (size_t i = 1; i < n; i++) {
+        const size_t x = offs[i];
+        size_t j = i;
+        while (j && varintTaggedSortCompare_(src + offs[j - 1], src + x,
+                                             depth, len) > 0) {
+            offs[j] = offs[j - 1];
+            j--;
+        }
+
+        offs[j] = x;
+    }
+}
+
+/* Stable counting sort of 'offs' by the key byte at 'depth' (through
+ * 'tmp'), leaving bucket sizes in 'counts' */
+static void varintTaggedSortPartition_(const uint8_t *src, size_t *offs,
+                                       size_t *tmp, size_t n, uint32_t depth,
+                                       size_t counts[256]) {
+    memset(counts, 0, 256 * sizeof(*counts));
+    for (size_t i = 0; i < n; i++) {
+        counts[src[offs[i] + depth]]++;
+    }
+
+    size_t pos[256];
+    size_t running = 0;
+    for (uint32_t b = 0; b < 256; b++) {
+        pos[b] = running;
+        running += counts[b];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        tmp[pos[src[offs[i] + depth]]++] = offs[i];
+    }
+
+    memcpy(offs, tmp, n * sizeof(*offs));
+}
+
+/* Sort keys whose first 'depth' bytes are equal.  'len' is their length
+ * (unknown, so 0, at depth 0). */
+static void varintTaggedSortRadix_(const uint8_t *src, size_t *offs,
+                                   size_t *tmp, size_t n, uint32_t depth,
+                                   uint32_t len) {
+    if (n < 2 || (depth && depth >= len)) {
+        return;
+    }
+
+    if (n <= INSERTION_MAX) {
+        varintTaggedSortInsertion_(src, offs, n, depth, len);
+        return;
+    }
+
+    size_t counts[256];
+    varintTaggedSortPartition_(src, offs, tmp, n, depth, counts);
+
+    size_t start = 0;
+    for (uint32_t b = 0; b < 256; b++) {
+        const uint32_t bucketLen =
+            depth ? len : varintTaggedSortKeyLen_((uint8_t)b);
+        varintTaggedSortRadix_(src, offs + start, tmp + start, counts[b],
+                               depth + 1, bucketLen);
+        start += counts[b];
+    }
+}
+
+bool varintTaggedSortOffsets(const uint8_t *src, size_t *offsets,
+                             size_t count) {
+    if (count <= INSERTION_MAX) {
+        varintTaggedSortInsertion_(src, offsets, count, 0, 0);
+        return true;
+    }
+
+    size_t *tmp = malloc(count * sizeof(*tmp));
+    if (!tmp) {
+        return false;
+    }
+
+    varintTaggedSortRadix_(src, offsets, tmp, count, 0, 0);
+    free(tmp);
+    return true;
+}
+
+/* ====================================================================
+ * Threads
+ * ==================================================================== */
+typedef struct varintTaggedSortTask_ {
+    size_t start;
+    size_t n;
+    uint32_t depth;
+    uint32_t len;
+    uint32_t owner;
+} varintTaggedSortTask_;
+
+typedef struct varintTaggedSortWorker_ {
+    uint32_t id;
+    const uint8_t *src;
+    size_t *offs;
+    size_t *tmp;
+    size_t start; /* this worker's share: [start, end) */
+    size_t end;
+    uint32_t depth;
+    size_t counts[256]; /* bucket sizes, then scatter positions */
+    const varintTaggedSortTask_ *tasks;
+    size_t taskCount;
+    uint8_t *slots; /* slot permutation */
+    uint8_t *records;
+    size_t stride;
+} varintTaggedSortWorker_;
+
+/* Run 'fn' on every worker, worker 0 on the calling thread.  Workers
+ * whose threads can't be started run on the calling thread instead. */
+static void varintTaggedSortRun_(varintThreadsFn_ *fn,
+                                 varintTaggedSortWorker_ *workers,
+                                 uint32_t n) {
+    varintThreadsRun_(fn, workers, sizeof(*workers), n);
+}
+
+static void varintTaggedSortShare_(varintTaggedSortWorker_ *workers,
+                                   uint32_t n, size_t start, size_t count) {
+    for (uint32_t i = 0; i < n; i++) {
+        workers[i].start = start + count * i / n;
+        workers[i].end = start + count * (i + 1) / n;
+    }
+}
+
+static void *varintTaggedSortCount_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    memset(w->counts, 0, sizeof(w->counts));
+    for (size_t i = w->start; i < w->end; i++) {
+        w->counts[w->src[w->offs[i] + w->depth]]++;
+    }
+
+    return NULL;
+}
+
+static void *varintTaggedSortScatter_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    for (size_t i = w->start; i < w->end; i++) {
+        w->tmp[w->counts[w->src[w->offs[i] + w->depth]]++] = w->offs[i];
+    }
+
+    return NULL;
+}
+
+static void *varintTaggedSortCopyBack_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    memcpy(w->offs + w->start, w->tmp + w->start,
+           (w->end - w->start) * sizeof(*w->offs));
+    return NULL;
+}
+
+static void *varintTaggedSortTasks_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    for (size_t i = 0; i < w->taskCount; i++) {
+        const varintTaggedSortTask_ *t = &w->tasks[i];
+        if (t->owner == w->id) {
+            varintTaggedSortRadix_(w->src, w->offs + t->start,
+                                   w->tmp + t->start, t->n, t->depth, t->len);
+        }
+    }
+
+    return NULL;
+}
+
+/* varintTaggedSortPartition_() of one bucket, split across workers: each
+ * counts its share, then scatters it behind the shares before it */
+static void varintTaggedSortPartitionParallel_(
+    varintTaggedSortWorker_ *workers, uint32_t n,
+    const varintTaggedSortTask_ *t, size_t counts[256]) {
+    varintTaggedSortShare_(workers, n, t->start, t->n);
+    for (uint32_t i = 0; i < n; i++) {
+        workers[i].depth = t->depth;
+    }
+
+    varintTaggedSortRun_(varintTaggedSortCount_, workers, n);
+
+    size_t running = t->start;
+    for (uint32_t b = 0; b < 256; b++) {
+        counts[b] = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            const size_t c = workers[i].counts[b];
+            workers[i].counts[b] = running;
+            running += c;
+            counts[b] += c;
+        }
+    }
+
+    varintTaggedSortRun_(varintTaggedSortScatter_, workers, n);
+    varintTaggedSortRun_(varintTaggedSortCopyBack_, workers, n);
+}
+
+static int varintTaggedSortLargestFirst_(const void *a, const void *b) {
+    const varintTaggedSortTask_ *x = a;
+    const varintTaggedSortTask_ *y = b;
+    return x->n < y->n ? 1 : x->n > y->n ? -1 : 0;
+}
+
+/* Sort with 'tmp' as scratch on 'workers' (each with src, offs, tmp) */
+static bool varintTaggedSortParallel_(varintTaggedSortWorker_ *workers,
+                                      uint32_t threads, size_t count) {
+    const size_t target = count / ((size_t)threads * TASKS_PER_THREAD) + 1;
+    size_t capacity = 256;
+    size_t taskCount = 1;
+    varintTaggedSortTask_ *tasks = malloc(capacity * sizeof(*tasks));
+    if (!tasks) {
+        return false;
+    }
+
+    tasks[0] = (varintTaggedSortTask_){.n = count};
+
+    /* Split large buckets a level at a time; appended buckets are
+     * visited by this same loop */
+    for (size_t i = 0; i < taskCount; i++) {
+        if (tasks[i].n <= target) {
+            continue;
+        }
+
+        const varintTaggedSortTask_ t = tasks[i];
+        size_t counts[256];
+        varintTaggedSortPartitionParallel_(workers, threads, &t, counts);
+        tasks[i].n = 0;
+
+        if (taskCount + 256 > capacity) {
+            capacity *= 2;
+            varintTaggedSortTask_ *grown =
+                realloc(tasks, capacity * sizeof(*tasks));
+            if (!grown) {
+                free(tasks);
+                return false;
+            }
+
+            tasks = grown;
+        }
+
+        size_t start = t.start;
+        for (uint32_t b = 0; b < 256; b++) {
+            const uint32_t len =
+                t.depth ? t.len : varintTaggedSortKeyLen_((uint8_t)b);
+            if (counts[b] > 1 && t.depth + 1 < len) {
+                tasks[taskCount++] = (varintTaggedSortTask_){
+                    .start = start,
+                    .n = counts[b],
+                    .depth = t.depth + 1,
+                    .len = len,
+                };
+            }
+
+            start += counts[b];
+        }
+    }
+
+    /* Largest remaining bucket to the least loaded thread */
+    qsort(tasks, taskCount, sizeof(*tasks), varintTaggedSortLargestFirst_);
+    size_t stackLoads[64];
+    size_t *loads =
+        threads <= 64 ? stackLoads : malloc(threads * sizeof(*loads));
+    if (!loads) {
+        free(tasks);
+        return false;
+    }
+
+    memset(loads, 0, threads * sizeof(*loads));
+    for (size_t i = 0; i < taskCount && tasks[i].n; i++) {
+        uint32_t least = 0;
+        for (uint32_t j = 1; j < threads; j++) {
+            least = loads[j] < loads[least] ? j : least;
+        }
+
+        tasks[i].owner = least;
+        loads[least] += tasks[i].n;
+    }
+
+    if (loads != stackLoads) {
+        free(loads);
+    }
+
+    for (uint32_t i = 0; i < threads; i++) {
+        workers[i].tasks = tasks;
+        workers[i].taskCount = taskCount;
+    }
+
+    varintTaggedSortRun_(varintTaggedSortTasks_, workers, threads);
+    free(tasks);
+    return true;
+}
+
+static varintTaggedSortWorker_ *
+varintTaggedSortWorkers_(uint32_t threads, const uint8_t *src, size_t *offs,
+                         size_t *tmp) {
+    varintTaggedSortWorker_ *workers = calloc(threads, sizeof(*workers));
+    if (workers) {
+        for (uint32_t i = 0; i < threads; i++) {
+            workers[i].id = i;
+            workers[i].src = src;
+            workers[i].offs = offs;
+            workers[i].tmp = tmp;
+        }
+    }
+
+    return workers;
+}
+
+bool varintTaggedSortOffsetsParallel(const uint8_t *src, size_t *offsets,
+                                     size_t count, uint32_t threads) {
+    threads = varintThreadsFor_(threads, count, MIN_PER_THREAD);
+    if (threads == 1) {
+        return varintTaggedSortOffsets(src, offsets, count);
+    }
+
+    size_t *tmp = malloc(count * sizeof(*tmp));
+    varintTaggedSortWorker_ *workers =
+        varintTaggedSortWorkers_(threads, src, offsets, tmp);
+    const bool sorted =
+        tmp && workers && varintTaggedSortParallel_(workers, threads, count);
+
+    free(tmp);
+    free(workers);
+    return sorted;
+}
+
+/* ====================================================================
+ * Slots
+ * ==================================================================== */
+/* Slots are sorted as offsets, then moved once into sorted order */
+static void *varintTaggedSortPermute_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    for (size_t i = w->start; i < w->end; i++) {
+        memcpy(w->records + i * w->stride, w->slots + w->offs[i], w->stride);
+    }
+
+    return NULL;
+}
+
+static void *varintTaggedSortSlotsBack_(void *arg) {
+    varintTaggedSortWorker_ *w = arg;
+    memcpy(w->slots + w->start * w->stride, w->records + w->start * w->stride,
+           (w->end - w->start) * w->stride);
+    return NULL;
+}
+
+bool varintTaggedSortSlotsParallel(uint8_t *slots, size_t stride,
+                                   size_t count, uint32_t threads) {
+    if (count < 2) {
+        return true;
+    }
+
+    if (!stride || count > SIZE_MAX / stride) {
+        return false;
+    }
+
+    threads = varintThreadsFor_(threads, count, MIN_PER_THREAD);
+    size_t *offs = malloc(count * sizeof(*offs));
+    size_t *tmp = malloc(count * sizeof(*tmp));
+    uint8_t *records = malloc(count * stride);
+    varintTaggedSortWorker_ *workers =
+        varintTaggedSortWorkers_(threads, slots, offs, tmp);
+    bool sorted = offs && tmp && records && workers;
+
+    if (sorted) {
+        for (size_t i = 0; i < count; i++) {
+            offs[i] = i * stride;
+        }
+
+        if (threads == 1) {
+            varintTaggedSortRadix_(slots, offs, tmp, count, 0, 0);
+        } else {
+            sorted = varintTaggedSortParallel_(workers, threads, count);
+        }
+    }
+
+    if (sorted) {
+        varintTaggedSortShare_(workers, threads, 0, count);
+        for (uint32_t i = 0; i < threads; i++) {
+            workers[i].slots = slots;
+            workers[i].records = records;
+            workers[i].stride = stride;
+        }
+
+        varintTaggedSortRun_(varintTaggedSortPermute_, workers, threads);
+        varintTaggedSortRun_(varintTaggedSortSlotsBack_, workers, threads);
+    }
+
+    free(offs);
+    free(tmp);
+    free(records);
+    free(workers);
+    return sorted;
+}
+
+bool varintTaggedSortSlots(uint8_t *slots, size_t stride, size_t count) {
+    return varintTaggedSortSlotsParallel(slots, stride, count, 1);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Sorting encoded Tagged varints
+ * ==================================================================== */
+/* Tagged varints sort by their encoded bytes: the first byte orders (and
+ * determines the length of) a key, and keys with the same first byte
+ * have the same length and order by memcmp() of their remaining bytes.
+ * These sorts are MSD radix sorts on those bytes, so keys are never
+ * decoded (or re-encoded):
+ *   - bucket by first byte; one byte keys (values up to 240) are done
+ *   - bucket each remaining bucket by its next byte, up to the key's
+ *     length, finishing small buckets with insertion sort
+ *
+ * Keys are given either as byte offsets into one buffer or as fixed size
+ * slots, each holding a key at its start (and anything else after it,
+ * which moves with its key).  All sorts are stable and return false only
+ * if scratch space can't be allocated, leaving keys unsorted.
+ *
+ * The parallel versions split large buckets across 'threads' threads
+ * (0 for one per online CPU) at every level until each bucket is small
+ * enough to hand whole to one thread, then sort those buckets
+ * concurrently.  Their results are identical to the serial versions. */
+
+/* Sort 'offsets' so src + offsets[i] are in ascending order. */
+bool varintTaggedSortOffsets(const uint8_t *src, size_t *offsets,
+                             size_t count);
+bool varintTaggedSortOffsetsParallel(const uint8_t *src, size_t *offsets,
+                                     size_t count, uint32_t threads);
+
+/* Sort 'count' slots of 'stride' bytes by the key at the start of each. */
+bool varintTaggedSortSlots(uint8_t *slots, size_t stride, size_t count);
+bool varintTaggedSortSlotsParallel(uint8_t *slots, size_t stride,
+                                   size_t count, uint32_t threads);
+
+__END_DECLS
@@ -0,0 +1,154 @@
+#include "varintTaggedSort.h"
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <stdlib.h>
+
+/* Enough keys for 4 threads to each get MIN_PER_THREAD */
+#define COUNT 300007
+#define STRIDE 16
+
+static int compareU64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Keys of every width, with many duplicates; 'wide' makes nearly all of
+ * them 9 bytes so they share one first byte bucket */
+static void makeKeys(uint64_t *vals, bool wide) {
+    for (size_t i = 0; i < COUNT; i++) {
+        const uint64_t v = ctestRandom();
+        vals[i] = wide ? v | (1ULL << 63) >> (v % 3)
+                       : v >> (ctestRandom() % 64) >> (i % 2 ? 40 : 0);
+    }
+}
+
+/* Keys in 'offsets' order must decode to the sorted values */
+static bool offsetsSorted(const uint8_t *src, const size_t *offsets,
+                          const uint64_t *sorted, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t v;
+        varintTaggedGet64(src + offsets[i], &v);
+        if (v != sorted[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(79);
+
+    uint64_t *vals = malloc(COUNT * sizeof(*vals));
+    uint64_t *sorted = malloc(COUNT * sizeof(*sorted));
+    uint8_t *src = malloc(COUNT * 9);
+    size_t *offsets = malloc(COUNT * sizeof(*offsets));
+    size_t *parallelOffsets = malloc(COUNT * sizeof(*offsets));
+    uint8_t *slots = malloc(COUNT * STRIDE);
+    uint8_t *parallelSlots = malloc(COUNT * STRIDE);
+
+    for (int wide = 0; wide <= 1; wide++) {
+        makeKeys(vals, wide);
+        memcpy(sorted, vals, COUNT * sizeof(*vals));
+        qsort(sorted, COUNT, sizeof(*sorted), compareU64);
+
+        size_t len = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            offsets[i] = len;
+            len += varintTaggedPut64(src + len, vals[i]);
+        }
+
+        memcpy(parallelOffsets, offsets, COUNT * sizeof(*offsets));
+
+        TEST("offset sorts order keys without decoding them") {
+            /* Small counts take the insertion sort path */
+            const size_t counts[] = {0, 1, 2, 31, 33, 1000, COUNT};
+            for (size_t c = 0; c < sizeof(counts) / sizeof(*counts); c++) {
+                const size_t n = counts[c];
+                size_t *some = malloc(n * sizeof(*some) + 1);
+                uint64_t *someSorted = malloc(n * sizeof(*someSorted) + 1);
+                memcpy(some, offsets, n * sizeof(*some));
+                memcpy(someSorted, vals, n * sizeof(*someSorted));
+                qsort(someSorted, n, sizeof(*someSorted), compareU64);
+
+                if (!varintTaggedSortOffsets(src, some, n) ||
+                    !offsetsSorted(src, some, someSorted, n)) {
+                    ERR("Sorting %zu %s keys failed!", n,
+                        wide ? "wide" : "mixed");
+                }
+
+                free(some);
+                free(someSorted);
+            }
+        }
+
+        TEST("parallel offset sorts match serial sorts") {
+            if (!varintTaggedSortOffsets(src, offsets, COUNT) ||
+                !varintTaggedSortOffsetsParallel(src, parallelOffsets, COUNT,
+                                                 4) ||
+                memcmp(offsets, parallelOffsets, COUNT * sizeof(*offsets))) {
+                ERR("Parallel sort of %s keys differs!",
+                    wide ? "wide" : "mixed");
+            }
+        }
+
+        TEST("slot sorts are stable and move whole slots") {
+            /* Each slot is a key followed by its original position */
+            for (size_t i = 0; i < COUNT; i++) {
+                uint8_t *slot = slots + i * STRIDE;
+                memset(slot, 0, STRIDE);
+                varintTaggedPut64(slot, vals[i]);
+                memcpy(slot + 9, &i, 4);
+            }
+
+            memcpy(parallelSlots, slots, COUNT * STRIDE);
+            if (!varintTaggedSortSlots(slots, STRIDE, COUNT) ||
+                !varintTaggedSortSlotsParallel(parallelSlots, STRIDE, COUNT,
+                                               4)) {
+                ERRR("Slot sort failed!");
+            }
+
+            if (memcmp(slots, parallelSlots, COUNT * STRIDE)) {
+                ERRR("Parallel slot sort differs!");
+            }
+
+            uint32_t prevPosition = 0;
+            for (size_t i = 0; i < COUNT; i++) {
+                const uint8_t *slot = slots + i * STRIDE;
+                uint64_t v;
+                uint32_t position;
+                varintTaggedGet64(slot, &v);
+                memcpy(&position, slot + 9, 4);
+                if (v != sorted[i] || vals[position] != v) {
+                    ERR("Slot %zu holds the wrong record!", i);
+                    break;
+                }
+
+                /* Equal keys keep their original order */
+                if (i && v == sorted[i - 1] && position < prevPosition) {
+                    ERR("Slot %zu isn't stable!", i);
+                    break;
+                }
+
+                prevPosition = position;
+            }
+        }
+    }
+
+    free(vals);
+    free(sorted);
+    free(src);
+    free(offsets);
+    free(parallelOffsets);
+    free(slots);
+    free(parallelSlots);
+
+    TEST_FINAL_RESULT;
+}
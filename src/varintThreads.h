@@ -0,0 +1,60 @@
+#pragma once
+
+/* Fork/join helpers shared by the multithreaded kernels */
+/* Includers define _GNU_SOURCE (for sysconf()) before any include. */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Threads to use for 'units' of work when the caller asked for 'threads'
+ * (0: one per online CPU), so each gets at least 'minPerThread' units. */
+static inline uint32_t varintThreadsFor_(uint32_t threads, size_t units,
+                                         size_t minPerThread) {
+    if (!threads) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+
+    const size_t most = units / minPerThread;
+    if (threads > most) {
+        threads = most ? (uint32_t)most : 1;
+    }
+
+    return threads;
+}
+
+typedef void *varintThreadsFn_(void *arg);
+
+/* Run 'fn' over 'n' work items of 'size' bytes each, item 0 on the
+ * calling thread.  Items whose thread can't be started also run on the
+ * calling thread, so every item has completed on return.  Returns false
+ * if any thread couldn't be started. */
+static inline bool varintThreadsRun_(varintThreadsFn_ *fn, void *items,
+                                     size_t size, uint32_t n) {
+    pthread_t stackThreads[64];
+    pthread_t *tids = n <= 64 ? stackThreads : malloc(n * sizeof(*tids));
+
+    uint32_t started = 1;
+    for (; tids && started < n; started++) {
+        if (pthread_create(&tids[started], NULL, fn,
+                           (uint8_t *)items + started * size)) {
+            break;
+        }
+    }
+
+    fn(items);
+    for (uint32_t i = started; i < n; i++) {
+        fn((uint8_t *)items + i * size);
+    }
+
+    for (uint32_t i = 1; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+
+    if (tids != stackThreads) {
+        free(tids);
+    }
+
+    return started == n;
+}
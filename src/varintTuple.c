@@ -0,0 +1,515 @@
+#include "varintTuple.h"
+#include "varintExternalBigEndian.h"
+#include "varintTagged.h"
+
+/* Signed integers in [MIN, MAX] are stored in the type byte itself. */
+#define VARINT_TUPLE_SIGNED_IMMEDIATE_MIN (-64)
+#define VARINT_TUPLE_SIGNED_IMMEDIATE_MAX 175
+#define VARINT_TUPLE_SIGNED_IMMEDIATE_BIAS 72 /* -64 is stored as 0x08 */
+#define VARINT_TUPLE_SIGNED_NEG_BASE 0x08     /* 0x08 - width */
+#define VARINT_TUPLE_SIGNED_POS_BASE 0xf7     /* 0xf7 + width */
+
+#define VARINT_TUPLE_DOUBLE_SIGN (1ULL << 63)
+#define VARINT_TUPLE_DOUBLE_NAN 0x7ff8000000000000ULL
+
+#define VARINT_TUPLE_BYTES_ESCAPE 0xff     /* 0x00 0xff is a literal 0x00 */
+#define VARINT_TUPLE_BYTES_TERMINATOR 0x01 /* 0x00 0x01 ends the string */
+
+/* Rows encoded together by varintTuplePutBatch() */
+#define VARINT_TUPLE_BATCH_BLOCK 64
+
+static void varintTupleInvert_(uint8_t *p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        p[i] = ~p[i];
+    }
+}
+
+/* ====================================================================
+ * Unsigned
+ * ==================================================================== */
+size_t varintTuplePutUnsigned(uint8_t *dst, uint64_t v,
+                              varintTupleOrder order) {
+    const size_t len = varintTaggedPut64(dst, v);
+    if (order == VARINT_TUPLE_DESC) {
+        varintTupleInvert_(dst, len);
+    }
+
+    return len;
+}
+
+size_t varintTupleGetUnsigned(const uint8_t *src, uint64_t *v,
+                              varintTupleOrder order) {
+    if (order == VARINT_TUPLE_ASC) {
+        return varintTaggedGet64(src, v);
+    }
+
+    uint8_t ascending[9];
+    ascending[0] = ~src[0];
+    const size_t len = varintTaggedGetLen(ascending);
+    for (size_t i = 1; i < len; i++) {
+        ascending[i] = ~src[i];
+    }
+
+    return varintTaggedGet64(ascending, v);
+}
+
+/* ====================================================================
+ * Signed
+ * ==================================================================== */
+size_t varintTupleLenSigned(int64_t v) {
+    varintWidth width;
+    if (v < VARINT_TUPLE_SIGNED_IMMEDIATE_MIN) {
+        varintExternalBigEndianUnsignedEncoding(~(uint64_t)v, width);
+    } else if (v <= VARINT_TUPLE_SIGNED_IMMEDIATE_MAX) {
+        return 1;
+    } else {
+        varintExternalBigEndianUnsignedEncoding((uint64_t)v, width);
+    }
+
+    return 1 + width;
+}
+
+size_t varintTuplePutSigned(uint8_t *dst, int64_t v, varintTupleOrder order) {
+    size_t len;
+    if (v < VARINT_TUPLE_SIGNED_IMMEDIATE_MIN) {
+        /* Larger magnitudes need more bytes and get smaller type bytes.
+         * For a given width, the truncated two's complement bytes already
+         * sort in value order. */
+        varintWidth width;
+        varintExternalBigEndianUnsignedEncoding(~(uint64_t)v, width);
+        dst[0] = VARINT_TUPLE_SIGNED_NEG_BASE - width;
+        varintExternalBigEndianPutFixedWidth(dst + 1, (uint64_t)v, width);
+        len = 1 + width;
+    } else if (v <= VARINT_TUPLE_SIGNED_IMMEDIATE_MAX) {
+        dst[0] = v + VARINT_TUPLE_SIGNED_IMMEDIATE_BIAS;
+        len = 1;
+    } else {
+        varintWidth width;
+        varintExternalBigEndianUnsignedEncoding((uint64_t)v, width);
+        dst[0] = VARINT_TUPLE_SIGNED_POS_BASE + width;
+        varintExternalBigEndianPutFixedWidth(dst + 1, (uint64_t)v, width);
+        len = 1 + width;
+    }
+
+    if (order == VARINT_TUPLE_DESC) {
+        varintTupleInvert_(dst, len);
+    }
+
+    return len;
+}
+
+size_t varintTupleGetSigned(const uint8_t *src, int64_t *v,
+                            varintTupleOrder order) {
+    const uint8_t flip = order == VARINT_TUPLE_DESC ? 0xff : 0x00;
+    const uint8_t b = src[0] ^ flip;
+
+    if (b < VARINT_TUPLE_SIGNED_NEG_BASE) {
+        const varintWidth width = VARINT_TUPLE_SIGNED_NEG_BASE - b;
+        uint8_t ascending[8];
+        for (size_t i = 0; i < width; i++) {
+            ascending[i] = src[1 + i] ^ flip;
+        }
+
+        uint64_t low = varintExternalBigEndianGet(ascending, width);
+        if (width < VARINT_WIDTH_64B) {
+            /* Sign extend the truncated two's complement value */
+            low |= ~0ULL << (width * 8);
+        }
+
+        *v = (int64_t)low;
+        return 1 + width;
+    }
+
+    if (b <= VARINT_TUPLE_SIGNED_POS_BASE) {
+        *v = (int64_t)b - VARINT_TUPLE_SIGNED_IMMEDIATE_BIAS;
+        return 1;
+    }
+
+    const varintWidth width = b - VARINT_TUPLE_SIGNED_POS_BASE;
+    uint8_t ascending[8];
+    for (size_t i = 0; i < width; i++) {
+        ascending[i] = src[1 + i] ^ flip;
+    }
+
+    *v = (int64_t)varintExternalBigEndianGet(ascending, width);
+    return 1 + width;
+}
+
+/* ====================================================================
+ * Double
+ * ==================================================================== */
+size_t varintTuplePutDouble(uint8_t *dst, double v, varintTupleOrder order) {
+    uint64_t bits;
+    if (v != v) {
+        bits = VARINT_TUPLE_DOUBLE_NAN;
+    } else {
+        /* Adding 0.0 turns -0.0 into +0.0 */
+        v += 0.0;
+        memcpy(&bits, &v, sizeof(bits));
+    }
+
+    /* Negative values: invert everything so larger magnitudes sort first.
+     * Positive values: set the sign bit so they sort after negatives. */
+    if (bits & VARINT_TUPLE_DOUBLE_SIGN) {
+        bits = ~bits;
+    } else {
+        bits ^= VARINT_TUPLE_DOUBLE_SIGN;
+    }
+
+    if (order == VARINT_TUPLE_DESC) {
+        bits = ~bits;
+    }
+
+    varintExternalBigEndianPutFixedWidth(dst, bits, VARINT_WIDTH_64B);
+    return sizeof(bits);
+}
+
+size_t varintTupleGetDouble(const uint8_t *src, double *v,
+                            varintTupleOrder order) {
+    uint64_t bits = varintExternalBigEndianGet(src, VARINT_WIDTH_64B);
+    if (order == VARINT_TUPLE_DESC) {
+        bits = ~bits;
+    }
+
+    if (bits & VARINT_TUPLE_DOUBLE_SIGN) {
+        bits ^= VARINT_TUPLE_DOUBLE_SIGN;
+    } else {
+        bits = ~bits;
+    }
+
+    memcpy(v, &bits, sizeof(bits));
+    return sizeof(bits);
+}
+
+/* ====================================================================
+ * Bytes
+ * ==================================================================== */
+size_t varintTupleLenBytes(const void *src, size_t len) {
+    const uint8_t *s = src;
+    const uint8_t *end = s + len;
+    size_t escapes = 0;
+    while ((s = memchr(s, 0x00, end - s))) {
+        escapes++;
+        s++;
+    }
+
+    return len + escapes + 2;
+}
+
+size_t varintTuplePutBytes(uint8_t *dst, const void *src, size_t len,
+                           varintTupleOrder order) {
+    const uint8_t *s = src;
+    const uint8_t *end = s + len;
+    uint8_t *d = dst;
+
+    /* Copy runs between 0x00 bytes whole instead of byte-at-a-time. */
+    const uint8_t *zero;
+    while ((zero = memchr(s, 0x00, end - s))) {
+        const size_t run = zero - s;
+        memcpy(d, s, run);
+        d += run;
+        *d++ = 0x00;
+        *d++ = VARINT_TUPLE_BYTES_ESCAPE;
+        s = zero + 1;
+    }
+
+    memcpy(d, s, end - s);
+    d += end - s;
+    *d++ = 0x00;
+    *d++ = VARINT_TUPLE_BYTES_TERMINATOR;
+
+    if (order == VARINT_TUPLE_DESC) {
+        varintTupleInvert_(dst, d - dst);
+    }
+
+    return d - dst;
+}
+
+size_t varintTupleGetBytes(const uint8_t *src, size_t srcLen, uint8_t *dst,
+                           size_t *len, varintTupleOrder order) {
+    const uint8_t flip = order == VARINT_TUPLE_DESC ? 0xff : 0x00;
+    const uint8_t *s = src;
+    const uint8_t *end = src + srcLen;
+    uint8_t *d = dst;
+
+    const uint8_t *marker;
+    while ((marker = memchr(s, flip, end - s))) {
+        const size_t run = marker - s;
+        if (flip) {
+            for (size_t i = 0; i < run; i++) {
+                d[i] = ~s[i];
+            }
+        } else {
+            memcpy(d, s, run);
+        }
+
+        d += run;
+
+        if (marker + 1 >= end) {
+            break;
+        }
+
+        const uint8_t next = marker[1] ^ flip;
+        if (next == VARINT_TUPLE_BYTES_TERMINATOR) {
+            *len = d - dst;
+            return marker + 2 - src;
+        }
+
+        if (next != VARINT_TUPLE_BYTES_ESCAPE) {
+            break;
+        }
+
+        *d++ = 0x00;
+        s = marker + 2;
+    }
+
+    /* Unterminated or badly escaped */
+    *len = 0;
+    return 0;
+}
+
+/* ====================================================================
+ * Tuples
+ * ==================================================================== */
+size_t varintTupleLen(const varintTupleField *fields, size_t count) {
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        const varintTupleField *f = &fields[i];
+        switch (f->type) {
+        case VARINT_TUPLE_UNSIGNED:
+            len += varintTaggedLenQuick(f->data.u);
+            break;
+        case VARINT_TUPLE_SIGNED:
+            len += varintTupleLenSigned(f->data.i);
+            break;
+        case VARINT_TUPLE_DOUBLE:
+            len += sizeof(double);
+            break;
+        case VARINT_TUPLE_BYTES:
+            len += varintTupleLenBytes(f->data.bytes.start, f->data.bytes.len);
+            break;
+        }
+    }
+
+    return len;
+}
+
+size_t varintTuplePut(uint8_t *dst, const varintTupleField *fields,
+                      size_t count) {
+    uint8_t *d = dst;
+    for (size_t i = 0; i < count; i++) {
+        const varintTupleField *f = &fields[i];
+        switch (f->type) {
+        case VARINT_TUPLE_UNSIGNED:
+            d += varintTuplePutUnsigned(d, f->data.u, f->order);
+            break;
+        case VARINT_TUPLE_SIGNED:
+            d += varintTuplePutSigned(d, f->data.i, f->order);
+            break;
+        case VARINT_TUPLE_DOUBLE:
+            d += varintTuplePutDouble(d, f->data.d, f->order);
+            break;
+        case VARINT_TUPLE_BYTES:
+            d += varintTuplePutBytes(d, f->data.bytes.start,
+                                     f->data.bytes.len, f->order);
+            break;
+        }
+    }
+
+    return d - dst;
+}
+
+size_t varintTupleGet(const uint8_t *src, size_t srcLen,
+                      varintTupleField *fields, size_t count,
+                      uint8_t *bytesBuf) {
+    const uint8_t *s = src;
+    const uint8_t *end = src + srcLen;
+    for (size_t i = 0; i < count; i++) {
+        varintTupleField *f = &fields[i];
+        if (s >= end) {
+            return 0;
+        }
+
+        switch (f->type) {
+        case VARINT_TUPLE_UNSIGNED: {
+            const uint8_t first = f->order == VARINT_TUPLE_DESC ? ~s[0] : s[0];
+            if ((size_t)(end - s) < varintTaggedGetLen(&first)) {
+                return 0;
+            }
+
+            s += varintTupleGetUnsigned(s, &f->data.u, f->order);
+            break;
+        }
+        case VARINT_TUPLE_SIGNED: {
+            const uint8_t b = f->order == VARINT_TUPLE_DESC ? ~s[0] : s[0];
+            size_t len = 1;
+            if (b < VARINT_TUPLE_SIGNED_NEG_BASE) {
+                len += VARINT_TUPLE_SIGNED_NEG_BASE - b;
+            } else if (b > VARINT_TUPLE_SIGNED_POS_BASE) {
+                len += b - VARINT_TUPLE_SIGNED_POS_BASE;
+            }
+
+            if ((size_t)(end - s) < len) {
+                return 0;
+            }
+
+            s += varintTupleGetSigned(s, &f->data.i, f->order);
+            break;
+        }
+        case VARINT_TUPLE_DOUBLE:
+            if ((size_t)(end - s) < sizeof(double)) {
+                return 0;
+            }
+
+            s += varintTupleGetDouble(s, &f->data.d, f->order);
+            break;
+        case VARINT_TUPLE_BYTES: {
+            size_t len;
+            const size_t consumed =
+                varintTupleGetBytes(s, end - s, bytesBuf, &len, f->order);
+            if (!consumed) {
+                return 0;
+            }
+
+            f->data.bytes.start = bytesBuf;
+            f->data.bytes.len = len;
+            bytesBuf += len;
+            s += consumed;
+            break;
+        }
+        }
+    }
+
+    return s - src;
+}
+
+/* ====================================================================
+ * Batch tuples
+ * ==================================================================== */
+/* Add the encoded length of rows [start, start + n) of 'col' to 'rowLen' */
+static void varintTupleColumnLens_(const varintTupleColumn *col, size_t start,
+                                   size_t n, size_t *rowLen) {
+    switch (col->type) {
+    case VARINT_TUPLE_UNSIGNED: {
+        const uint64_t *u = col->values.u + start;
+        for (size_t r = 0; r < n; r++) {
+            rowLen[r] += varintTaggedLenQuick(u[r]);
+        }
+        break;
+    }
+    case VARINT_TUPLE_SIGNED: {
+        const int64_t *i = col->values.i + start;
+        for (size_t r = 0; r < n; r++) {
+            rowLen[r] += varintTupleLenSigned(i[r]);
+        }
+        break;
+    }
+    case VARINT_TUPLE_DOUBLE:
+        for (size_t r = 0; r < n; r++) {
+            rowLen[r] += sizeof(double);
+        }
+        break;
+    case VARINT_TUPLE_BYTES: {
+        const varintTupleBytes *b = col->values.bytes + start;
+        for (size_t r = 0; r < n; r++) {
+            rowLen[r] += varintTupleLenBytes(b[r].start, b[r].len);
+        }
+        break;
+    }
+    }
+}
+
+size_t varintTupleLenBatch(const varintTupleColumn *columns, size_t colCount,
+                           size_t rows) {
+    size_t total = 0;
+    for (size_t start = 0; start < rows; start += VARINT_TUPLE_BATCH_BLOCK) {
+        size_t rowLen[VARINT_TUPLE_BATCH_BLOCK] = {0};
+        const size_t n = rows - start < VARINT_TUPLE_BATCH_BLOCK
+                             ? rows - start
+                             : VARINT_TUPLE_BATCH_BLOCK;
+        for (size_t c = 0; c < colCount; c++) {
+            varintTupleColumnLens_(&columns[c], start, n, rowLen);
+        }
+
+        for (size_t r = 0; r < n; r++) {
+            total += rowLen[r];
+        }
+    }
+
+    return total;
+}
+
+/* Batch encoding works on blocks of rows: first compute every row's length
+ * column by column (to place each row), then write each column into every
+ * row of the block.  Type dispatch happens once per column per block and
+ * descending columns are inverted in one pass after writing. */
+size_t varintTuplePutBatch(uint8_t *dst, size_t *offsets,
+                           const varintTupleColumn *columns, size_t colCount,
+                           size_t rows) {
+    offsets[0] = 0;
+    for (size_t start = 0; start < rows; start += VARINT_TUPLE_BATCH_BLOCK) {
+        size_t cursor[VARINT_TUPLE_BATCH_BLOCK] = {0};
+        size_t fieldStart[VARINT_TUPLE_BATCH_BLOCK];
+        const size_t n = rows - start < VARINT_TUPLE_BATCH_BLOCK
+                             ? rows - start
+                             : VARINT_TUPLE_BATCH_BLOCK;
+
+        for (size_t c = 0; c < colCount; c++) {
+            varintTupleColumnLens_(&columns[c], start, n, cursor);
+        }
+
+        for (size_t r = 0; r < n; r++) {
+            offsets[start + r + 1] = offsets[start + r] + cursor[r];
+            cursor[r] = offsets[start + r];
+        }
+
+        for (size_t c = 0; c < colCount; c++) {
+            const varintTupleColumn *col = &columns[c];
+            memcpy(fieldStart, cursor, n * sizeof(*cursor));
+
+            switch (col->type) {
+            case VARINT_TUPLE_UNSIGNED: {
+                const uint64_t *u = col->values.u + start;
+                for (size_t r = 0; r < n; r++) {
+                    cursor[r] += varintTaggedPut64(dst + cursor[r], u[r]);
+                }
+                break;
+            }
+            case VARINT_TUPLE_SIGNED: {
+                const int64_t *i = col->values.i + start;
+                for (size_t r = 0; r < n; r++) {
+                    cursor[r] += varintTuplePutSigned(dst + cursor[r], i[r],
+                                                      VARINT_TUPLE_ASC);
+                }
+                break;
+            }
+            case VARINT_TUPLE_DOUBLE: {
+                const double *d = col->values.d + start;
+                for (size_t r = 0; r < n; r++) {
+                    cursor[r] += varintTuplePutDouble(dst + cursor[r], d[r],
+                                                      VARINT_TUPLE_ASC);
+                }
+                break;
+            }
+            case VARINT_TUPLE_BYTES: {
+                const varintTupleBytes *b = col->values.bytes + start;
+                for (size_t r = 0; r < n; r++) {
+                    cursor[r] += varintTuplePutBytes(
+                        dst + cursor[r], b[r].start, b[r].len,
+                        VARINT_TUPLE_ASC);
+                }
+                break;
+            }
+            }
+
+            if (col->order == VARINT_TUPLE_DESC) {
+                for (size_t r = 0; r < n; r++) {
+                    varintTupleInvert_(dst + fieldStart[r],
+                                       cursor[r] - fieldStart[r]);
+                }
+            }
+        }
+    }
+
+    return offsets[rows];
+}
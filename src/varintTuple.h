@@ -0,0 +1,143 @@
+#pragma once
+
+#include "varint.h"
+__BEGIN_DECLS
+
+/* ====================================================================
+ * Tuple keys (memcmp-sortable composite keys)
+ * ==================================================================== */
+/* varint model Tuple Container:
+ *   Type encoded inside: nothing; the caller supplies the field types
+ *   Size: 1 byte to 9 bytes per integer, 8 bytes per double,
+ *         2 bytes to (2 * length + 2) bytes per byte string
+ *   Layout: big endian, every field self-delimiting
+ *   Meaning: memcmp() order of two encoded tuples with the same field types
+ *            equals field-by-field tuple order (honoring each field's
+ *            ascending/descending order).
+ *   Pro: keys compare with a single memcmp() regardless of field count.
+ *   Con: byte strings containing 0x00 grow by one byte per 0x00. */
+
+/* Tuple Field Layouts */
+/* =================== */
+/*
+ * Unsigned integers
+ * -----------------
+ * Tagged varints (already big endian and memcmp-sortable).
+ *
+ * Signed integers
+ * ---------------
+ * |00000nnn|[8 - n bytes]|  -2^63 to -65: low (8 - n) bytes of the two's
+ *                           complement value, big endian
+ * |B|                       -64 to 175 stored as B = value + 72
+ *                           (B is 0x08 to 0xf7)
+ * |11111nnn|[n + 1 bytes]|  176 to 2^63 - 1: value, big endian
+ *
+ * Doubles
+ * -------
+ * IEEE bits, big endian, with the sign bit flipped for positive values and
+ * all bits flipped for negative values.  -0.0 is stored as +0.0 and every
+ * NaN is stored as the canonical quiet NaN (sorting after +infinity).
+ *
+ * Byte strings
+ * ------------
+ * Every 0x00 is written as |00000000|11111111| and the string ends with
+ * |00000000|00000001|, so a string sorts before every string it prefixes.
+ *
+ * Descending fields
+ * -----------------
+ * Every byte of the field's ascending encoding is inverted.  Because each
+ * field encoding is self-delimiting, inverting it exactly reverses its
+ * order without affecting the fields after it. */
+
+typedef enum varintTupleType {
+    VARINT_TUPLE_UNSIGNED = 0,
+    VARINT_TUPLE_SIGNED,
+    VARINT_TUPLE_DOUBLE,
+    VARINT_TUPLE_BYTES,
+} varintTupleType;
+
+typedef enum varintTupleOrder {
+    VARINT_TUPLE_ASC = 0,
+    VARINT_TUPLE_DESC,
+} varintTupleOrder;
+
+typedef struct varintTupleBytes {
+    const void *start;
+    size_t len;
+} varintTupleBytes;
+
+typedef struct varintTupleField {
+    varintTupleType type;
+    varintTupleOrder order;
+    union {
+        uint64_t u;
+        int64_t i;
+        double d;
+        varintTupleBytes bytes;
+    } data;
+} varintTupleField;
+
+/* Single fields.  Each Put returns bytes written; each Get returns bytes
+ * consumed (0 if the field is malformed). */
+size_t varintTuplePutUnsigned(uint8_t *dst, uint64_t v,
+                              varintTupleOrder order);
+size_t varintTuplePutSigned(uint8_t *dst, int64_t v, varintTupleOrder order);
+size_t varintTuplePutDouble(uint8_t *dst, double v, varintTupleOrder order);
+size_t varintTuplePutBytes(uint8_t *dst, const void *src, size_t len,
+                           varintTupleOrder order);
+
+size_t varintTupleGetUnsigned(const uint8_t *src, uint64_t *v,
+                              varintTupleOrder order);
+size_t varintTupleGetSigned(const uint8_t *src, int64_t *v,
+                            varintTupleOrder order);
+size_t varintTupleGetDouble(const uint8_t *src, double *v,
+                            varintTupleOrder order);
+/* Unescapes into 'dst' (which must hold at least as many bytes as the
+ * encoded field) and sets 'len' to the decoded length. */
+size_t varintTupleGetBytes(const uint8_t *src, size_t srcLen, uint8_t *dst,
+                           size_t *len, varintTupleOrder order);
+
+size_t varintTupleLenSigned(int64_t v);
+size_t varintTupleLenBytes(const void *src, size_t len);
+
+/* Whole tuples. */
+size_t varintTupleLen(const varintTupleField *fields, size_t count);
+size_t varintTuplePut(uint8_t *dst, const varintTupleField *fields,
+                      size_t count);
+/* Decode 'count' fields whose 'type' and 'order' are already set.  Decoded
+ * byte strings are written back to back into 'bytesBuf' (at most 'srcLen'
+ * bytes total) and each field's 'data.bytes' points into it.
+ * Returns bytes consumed, or 0 if 'src' is malformed. */
+size_t varintTupleGet(const uint8_t *src, size_t srcLen,
+                      varintTupleField *fields, size_t count,
+                      uint8_t *bytesBuf);
+
+/* ====================================================================
+ * Batch tuple encoding
+ * ==================================================================== */
+/* Batch encoding takes values column by column so the per-field type and
+ * order decisions are made once per column per block of rows instead of
+ * once per value. */
+typedef struct varintTupleColumn {
+    varintTupleType type;
+    varintTupleOrder order;
+    union {
+        const uint64_t *u;
+        const int64_t *i;
+        const double *d;
+        const varintTupleBytes *bytes;
+    } values;
+} varintTupleColumn;
+
+/* Exact number of bytes varintTuplePutBatch() writes for 'rows' rows. */
+size_t varintTupleLenBatch(const varintTupleColumn *columns, size_t colCount,
+                           size_t rows);
+
+/* Encode 'rows' tuples back to back into 'dst'.  Row 'r' is stored at
+ * dst[offsets[r]] through dst[offsets[r + 1] - 1], so 'offsets' must hold
+ * 'rows' + 1 entries.  Returns total bytes written. */
+size_t varintTuplePutBatch(uint8_t *dst, size_t *offsets,
+                           const varintTupleColumn *columns, size_t colCount,
+                           size_t rows);
+
+__END_DECLS
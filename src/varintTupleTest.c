@@ -0,0 +1,297 @@
+#include "varintTuple.h"
+
+#include "ctest.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define FIELDS 4
+#define ROWS 600
+
+/* Values clustered around type and width boundaries so neighboring keys
+ * frequently share prefixes. */
+static int64_t randomSigned(void) {
+    static const int64_t edges[] = {INT64_MIN, -65536, -257, -256, -65, -64,
+                                    -1,        0,      1,    175,  176, 255,
+                                    256,       65535,  65536, INT64_MAX};
+    const int64_t edge =
+        edges[ctestRandom() % (sizeof(edges) / sizeof(*edges))];
+    const int64_t jitter = (int64_t)(ctestRandom() % 5) - 2;
+    if ((edge == INT64_MIN && jitter < 0) ||
+        (edge == INT64_MAX && jitter > 0)) {
+        return edge;
+    }
+
+    return edge + jitter;
+}
+
+static int cmpBytes(const varintTupleBytes *a, const varintTupleBytes *b) {
+    const size_t min = a->len < b->len ? a->len : b->len;
+    const int c = memcmp(a->start, b->start, min);
+    if (c) {
+        return c;
+    }
+
+    return (a->len > b->len) - (a->len < b->len);
+}
+
+static int cmpFields(const varintTupleField *a, const varintTupleField *b,
+                     size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int c = 0;
+        switch (a[i].type) {
+        case VARINT_TUPLE_UNSIGNED:
+            c = (a[i].data.u > b[i].data.u) - (a[i].data.u < b[i].data.u);
+            break;
+        case VARINT_TUPLE_SIGNED:
+            c = (a[i].data.i > b[i].data.i) - (a[i].data.i < b[i].data.i);
+            break;
+        case VARINT_TUPLE_DOUBLE:
+            c = (a[i].data.d > b[i].data.d) - (a[i].data.d < b[i].data.d);
+            break;
+        case VARINT_TUPLE_BYTES:
+            c = cmpBytes(&a[i].data.bytes, &b[i].data.bytes);
+            c = (c > 0) - (c < 0);
+            break;
+        }
+
+        if (a[i].order == VARINT_TUPLE_DESC) {
+            c = -c;
+        }
+
+        if (c) {
+            return c;
+        }
+    }
+
+    return 0;
+}
+
+static int cmpKeys(const uint8_t *a, size_t aLen, const uint8_t *b,
+                   size_t bLen) {
+    const size_t min = aLen < bLen ? aLen : bLen;
+    const int c = memcmp(a, b, min);
+    if (c) {
+        return (c > 0) - (c < 0);
+    }
+
+    return (aLen > bLen) - (aLen < bLen);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(1);
+
+    TEST("signed integers round trip and sort in both orders") {
+        for (int64_t v = -70000; v <= 70000; v += 7) {
+            for (int order = 0; order < 2; order++) {
+                uint8_t a[16];
+                uint8_t b[16];
+                const size_t aLen = varintTuplePutSigned(a, v, order);
+                const size_t bLen = varintTuplePutSigned(b, v + 7, order);
+                if (aLen != varintTupleLenSigned(v)) {
+                    ERR("Length of %" PRIi64 " mismatch!", v);
+                }
+
+                int64_t got;
+                if (varintTupleGetSigned(a, &got, order) != aLen || got != v) {
+                    ERR("Signed %" PRIi64 " didn't round trip!", v);
+                }
+
+                const int expected = order == VARINT_TUPLE_ASC ? -1 : 1;
+                if (cmpKeys(a, aLen, b, bLen) != expected) {
+                    ERR("Signed %" PRIi64 " sorted wrong!", v);
+                }
+            }
+        }
+
+        static const int64_t extremes[] = {INT64_MIN, INT64_MIN + 1, -257,
+                                           -256,      -65,           -64,
+                                           175,       176,           INT64_MAX};
+        for (size_t i = 0; i + 1 < sizeof(extremes) / sizeof(*extremes);
+             i++) {
+            uint8_t a[16];
+            uint8_t b[16];
+            const size_t aLen =
+                varintTuplePutSigned(a, extremes[i], VARINT_TUPLE_ASC);
+            const size_t bLen =
+                varintTuplePutSigned(b, extremes[i + 1], VARINT_TUPLE_ASC);
+            int64_t got;
+            varintTupleGetSigned(a, &got, VARINT_TUPLE_ASC);
+            if (got != extremes[i] || cmpKeys(a, aLen, b, bLen) != -1) {
+                ERR("Signed extreme %" PRIi64 " failed!", extremes[i]);
+            }
+        }
+    }
+
+    TEST("doubles sort like numbers") {
+        static const double vals[] = {-INFINITY, -1e300, -2.5, -1.0, -1e-300,
+                                      0.0,       1e-300, 1.0,  2.5,  1e300,
+                                      INFINITY,  NAN};
+        for (size_t i = 0; i + 1 < sizeof(vals) / sizeof(*vals); i++) {
+            uint8_t a[8];
+            uint8_t b[8];
+            varintTuplePutDouble(a, vals[i], VARINT_TUPLE_ASC);
+            varintTuplePutDouble(b, vals[i + 1], VARINT_TUPLE_ASC);
+            double got;
+            varintTupleGetDouble(a, &got, VARINT_TUPLE_ASC);
+            if (memcmp(a, b, 8) >= 0 || got != vals[i]) {
+                ERR("Double %g failed!", vals[i]);
+            }
+        }
+
+        uint8_t a[8];
+        uint8_t b[8];
+        varintTuplePutDouble(a, -0.0, VARINT_TUPLE_DESC);
+        varintTuplePutDouble(b, 0.0, VARINT_TUPLE_DESC);
+        if (memcmp(a, b, 8)) {
+            ERRR("-0.0 and 0.0 should encode identically!");
+        }
+    }
+
+    TEST("byte strings with embedded zeros") {
+        static const struct {
+            const char *s;
+            size_t len;
+        } strs[] = {{"", 0},      {"\0", 1},    {"\0\0", 2}, {"\0\x01", 2},
+                    {"\x01", 1},  {"a", 1},     {"a\0", 2},  {"a\0b", 3},
+                    {"a\x01", 2}, {"ab", 2},    {"b", 1},    {"\xff", 1},
+                    {"\xff\xff", 2}};
+        const size_t count = sizeof(strs) / sizeof(*strs);
+        for (int order = 0; order < 2; order++) {
+            for (size_t i = 0; i + 1 < count; i++) {
+                uint8_t a[16];
+                uint8_t b[16];
+                uint8_t out[16];
+                const size_t aLen =
+                    varintTuplePutBytes(a, strs[i].s, strs[i].len, order);
+                const size_t bLen = varintTuplePutBytes(b, strs[i + 1].s,
+                                                        strs[i + 1].len, order);
+                if (aLen != varintTupleLenBytes(strs[i].s, strs[i].len)) {
+                    ERR("String %zu length mismatch!", i);
+                }
+
+                size_t outLen;
+                if (varintTupleGetBytes(a, aLen, out, &outLen, order) !=
+                        aLen ||
+                    outLen != strs[i].len || memcmp(out, strs[i].s, outLen)) {
+                    ERR("String %zu didn't round trip!", i);
+                }
+
+                const int expected = order == VARINT_TUPLE_ASC ? -1 : 1;
+                if (cmpKeys(a, aLen, b, bLen) != expected) {
+                    ERR("String %zu sorted wrong!", i);
+                }
+            }
+        }
+
+        uint8_t unterminated[] = {'a', 0x00};
+        size_t outLen;
+        uint8_t out[4];
+        if (varintTupleGetBytes(unterminated, sizeof(unterminated), out,
+                                &outLen, VARINT_TUPLE_ASC)) {
+            ERRR("Unterminated string decoded!");
+        }
+    }
+
+    TEST("mixed tuples: memcmp order equals tuple order") {
+        static const varintTupleType types[FIELDS] = {
+            VARINT_TUPLE_SIGNED, VARINT_TUPLE_BYTES, VARINT_TUPLE_UNSIGNED,
+            VARINT_TUPLE_DOUBLE};
+        static const varintTupleOrder orders[FIELDS] = {
+            VARINT_TUPLE_ASC, VARINT_TUPLE_DESC, VARINT_TUPLE_DESC,
+            VARINT_TUPLE_ASC};
+        static const char *words[] = {"", "a", "a\0", "ab", "b\0c", "zz"};
+        static const size_t wordLens[] = {0, 1, 2, 2, 3, 2};
+
+        static varintTupleField rows[ROWS][FIELDS];
+        static int64_t colI[ROWS];
+        static varintTupleBytes colB[ROWS];
+        static uint64_t colU[ROWS];
+        static double colD[ROWS];
+
+        for (size_t r = 0; r < ROWS; r++) {
+            const size_t w = ctestRandom() % 6;
+            colI[r] = randomSigned() % 3;
+            colB[r] = (varintTupleBytes){words[w], wordLens[w]};
+            colU[r] = ctestRandom() % 3
+                          ? ctestRandom() % 300
+                          : (ctestRandom() >> 11) >> (ctestRandom() % 53);
+            colD[r] = (double)((int64_t)(ctestRandom() % 7) - 3) / 2;
+            if (r % 5 == 0) {
+                colI[r] = randomSigned();
+            }
+
+            for (size_t f = 0; f < FIELDS; f++) {
+                rows[r][f].type = types[f];
+                rows[r][f].order = orders[f];
+            }
+
+            rows[r][0].data.i = colI[r];
+            rows[r][1].data.bytes = colB[r];
+            rows[r][2].data.u = colU[r];
+            rows[r][3].data.d = colD[r];
+        }
+
+        const varintTupleColumn columns[FIELDS] = {
+            {.type = types[0], .order = orders[0], .values.i = colI},
+            {.type = types[1], .order = orders[1], .values.bytes = colB},
+            {.type = types[2], .order = orders[2], .values.u = colU},
+            {.type = types[3], .order = orders[3], .values.d = colD}};
+
+        const size_t total = varintTupleLenBatch(columns, FIELDS, ROWS);
+        uint8_t *batch = malloc(total);
+        size_t *offsets = malloc((ROWS + 1) * sizeof(*offsets));
+        if (varintTuplePutBatch(batch, offsets, columns, FIELDS, ROWS) !=
+            total) {
+            ERRR("Batch wrote unexpected length!");
+        }
+
+        for (size_t r = 0; r < ROWS; r++) {
+            uint8_t key[64];
+            const size_t len = varintTuplePut(key, rows[r], FIELDS);
+            if (len != varintTupleLen(rows[r], FIELDS) ||
+                len != offsets[r + 1] - offsets[r] ||
+                memcmp(key, batch + offsets[r], len)) {
+                ERR("Row %zu batch encoding differs from single encoding!", r);
+            }
+
+            varintTupleField decoded[FIELDS];
+            uint8_t bytesBuf[64];
+            for (size_t f = 0; f < FIELDS; f++) {
+                decoded[f].type = types[f];
+                decoded[f].order = orders[f];
+            }
+
+            if (varintTupleGet(key, len, decoded, FIELDS, bytesBuf) != len ||
+                cmpFields(decoded, rows[r], FIELDS) != 0) {
+                ERR("Row %zu didn't decode!", r);
+            }
+
+            if (varintTupleGet(key, len - 1, decoded, FIELDS, bytesBuf)) {
+                ERR("Truncated row %zu decoded!", r);
+            }
+        }
+
+        for (size_t a = 0; a < ROWS; a++) {
+            for (size_t b = a; b < ROWS; b += 7) {
+                const int expected = cmpFields(rows[a], rows[b], FIELDS);
+                const int got = cmpKeys(
+                    batch + offsets[a], offsets[a + 1] - offsets[a],
+                    batch + offsets[b], offsets[b + 1] - offsets[b]);
+                if (expected != got) {
+                    ERR("Rows %zu and %zu: tuple order %d, memcmp order %d!",
+                        a, b, expected, got);
+                }
+            }
+        }
+
+        free(batch);
+        free(offsets);
+    }
+
+    TEST_FINAL_RESULT;
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+/* ====================================================================
+ * Owning containers for packed and tagged sequences
+ * ==================================================================== */
+/* varint::packed_vector<Bits, Slot> and varint::tagged_vector own their
+ * storage through std::pmr allocators, so they can live in arenas
+ * (e.g. std::pmr::monotonic_buffer_resource) instead of each caller
+ * wrapping the raw void * APIs and reallocating by hand.
+ *
+ * packed_vector: values of exactly 'Bits' bits in the varintPacked.h
+ *                layout; O(1) random access.  data() is a valid
+ *                varintPacked<Bits>Get() array.
+ * tagged_vector: values as back to back Tagged varints; data() is a valid
+ *                varintTaggedGet64() stream.  Random access finds the
+ *                nearest sampled offset (one every sample_interval values)
+ *                and skips forward from there, so lookup walks at most
+ *                sample_interval - 1 varints.
+ *
+ * Both grow geometrically (at least doubling), iterate with range-for,
+ * and bulk append from pointer + count or std::span under C++20. */
+
+#include "varint.hpp"
+#include "varintPacked.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <vector>
+
+namespace varint {
+
+namespace detail {
+/* Make room for 'need' elements, at least doubling capacity */
+template <typename T>
+void growFor(std::pmr::vector<T> &v, std::size_t need) {
+    if (need > v.capacity()) {
+        const std::size_t twice = v.capacity() * 2;
+        v.reserve(need > twice ? need : twice);
+    }
+}
+} // namespace detail
+
+/* ====================================================================
+ * Packed
+ * ==================================================================== */
+template <unsigned Bits, typename Slot = std::uint32_t>
+class packed_vector {
+  public:
+    using kernel = packed<Bits, Slot>;
+    using value_type = typename kernel::value_type;
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<Slot>;
+
+    /* Random access iterator yielding values (not references) */
+    class const_iterator {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename kernel::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator() noexcept = default;
+        const_iterator(const Slot *slots, std::size_t i) noexcept
+            : slots_(slots), i_(i) {
+        }
+
+        value_type operator*() const noexcept {
+            return kernel::get(slots_, i_);
+        }
+
+        value_type operator[](difference_type n) const noexcept {
+            return kernel::get(slots_, i_ + n);
+        }
+
+        const_iterator &operator++() noexcept {
+            i_++;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator prev = *this;
+            i_++;
+            return prev;
+        }
+
+        const_iterator &operator--() noexcept {
+            i_--;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept {
+            const_iterator prev = *this;
+            i_--;
+            return prev;
+        }
+
+        const_iterator &operator+=(difference_type n) noexcept {
+            i_ += n;
+            return *this;
+        }
+
+        const_iterator &operator-=(difference_type n) noexcept {
+            i_ -= n;
+            return *this;
+        }
+
+        friend const_iterator operator+(const_iterator it,
+                                        difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend const_iterator operator+(difference_type n,
+                                        const_iterator it) noexcept {
+            return it += n;
+        }
+
+        friend const_iterator operator-(const_iterator it,
+                                        difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const const_iterator &a,
+                                         const const_iterator &b) noexcept {
+            return difference_type(a.i_) - difference_type(b.i_);
+        }
+
+        friend bool operator==(const const_iterator &a,
+                               const const_iterator &b) noexcept {
+            return a.i_ == b.i_;
+        }
+
+        friend bool operator!=(const const_iterator &a,
+                               const const_iterator &b) noexcept {
+            return a.i_ != b.i_;
+        }
+
+        friend bool operator<(const const_iterator &a,
+                              const const_iterator &b) noexcept {
+            return a.i_ < b.i_;
+        }
+
+        friend bool operator>(const const_iterator &a,
+                              const const_iterator &b) noexcept {
+            return a.i_ > b.i_;
+        }
+
+        friend bool operator<=(const const_iterator &a,
+                               const const_iterator &b) noexcept {
+            return a.i_ <= b.i_;
+        }
+
+        friend bool operator>=(const const_iterator &a,
+                               const const_iterator &b) noexcept {
+            return a.i_ >= b.i_;
+        }
+
+      private:
+        const Slot *slots_ = nullptr;
+        std::size_t i_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    packed_vector() = default;
+    explicit packed_vector(const allocator_type &alloc) : slots_(alloc) {
+    }
+
+    packed_vector(const packed_vector &other, const allocator_type &alloc)
+        : slots_(other.slots_, alloc), size_(other.size_) {
+    }
+
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return !size_;
+    }
+
+    /* Values storable without reallocating */
+    size_type capacity() const noexcept {
+        return slots_.capacity() * kernel::slot_bits / Bits;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return slots_.get_allocator();
+    }
+
+    /* Backing slots, usable with varintPacked<Bits>Get() and friends */
+    const Slot *data() const noexcept {
+        return slots_.data();
+    }
+
+    void reserve(size_type n) {
+        slots_.reserve(kernel::slots_for(n));
+    }
+
+    void clear() noexcept {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    /* Grow (with zeros) or shrink to 'n' values */
+    void resize(size_type n) {
+        if (n < size_) {
+            /* Zero the dropped tail so regrowing reads zeros */
+            for (size_type i = n; i < size_; i++) {
+                kernel::set(slots_.data(), i, 0);
+            }
+
+            slots_.resize(kernel::slots_for(n));
+        } else {
+            detail::growFor(slots_, kernel::slots_for(n));
+            slots_.resize(kernel::slots_for(n));
+        }
+
+        size_ = n;
+    }
+
+    value_type operator[](size_type i) const noexcept {
+        return kernel::get(slots_.data(), i);
+    }
+
+    value_type get(size_type i) const noexcept {
+        return kernel::get(slots_.data(), i);
+    }
+
+    /* 'v' is truncated to Bits bits */
+    void set(size_type i, value_type v) noexcept {
+        kernel::set(slots_.data(), i, v);
+    }
+
+    void push_back(value_type v) {
+        grow(size_ + 1);
+        kernel::set(slots_.data(), size_, v);
+        size_++;
+    }
+
+    void append(const value_type *values, size_type count) {
+        grow(size_ + count);
+        kernel::pack(slots_.data(), size_, values, count);
+        size_ += count;
+    }
+
+#ifdef VARINT_HPP_SPAN
+    void append(std::span<const value_type> values) {
+        append(values.data(), values.size());
+    }
+#endif
+
+    /* Read 'count' values starting at 'first' with the unrolled kernel */
+    void copy_out(size_type first, value_type *out, size_type count) const {
+        kernel::unpack(slots_.data(), first, out, count);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(slots_.data(), 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(slots_.data(), size_);
+    }
+
+  private:
+    void grow(size_type count) {
+        const size_type need = kernel::slots_for(count);
+        if (need > slots_.size()) {
+            detail::growFor(slots_, need);
+            slots_.resize(need);
+        }
+    }
+
+    std::pmr::vector<Slot> slots_;
+    size_type size_ = 0;
+};
+
+/* ====================================================================
+ * Tagged
+ * ==================================================================== */
+class tagged_vector {
+  public:
+    using codec_type = codec<tagged>;
+    using value_type = std::uint64_t;
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<std::uint8_t>;
+    using const_iterator = decode_iterator<tagged>;
+    using iterator = const_iterator;
+
+    /* Values between recorded byte offsets */
+    static constexpr size_type sample_interval = 64;
+
+    tagged_vector() = default;
+    explicit tagged_vector(const allocator_type &alloc)
+        : bytes_(alloc), samples_(alloc) {
+    }
+
+    tagged_vector(const tagged_vector &other, const allocator_type &alloc)
+        : bytes_(other.bytes_, alloc), samples_(other.samples_, alloc),
+          size_(other.size_) {
+    }
+
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return !size_;
+    }
+
+    /* Encoded bytes */
+    size_type bytes() const noexcept {
+        return bytes_.size();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return bytes_.get_allocator();
+    }
+
+    /* Encoded stream, usable with varintTaggedGet64() and friends */
+    const std::uint8_t *data() const noexcept {
+        return bytes_.data();
+    }
+
+    /* Reserve for 'count' values averaging 'bytesPerValue' bytes each */
+    void reserve(size_type count, size_type bytesPerValue = 2) {
+        bytes_.reserve(count * bytesPerValue);
+        samples_.reserve(count / sample_interval + 1);
+    }
+
+    void clear() noexcept {
+        bytes_.clear();
+        samples_.clear();
+        size_ = 0;
+    }
+
+    /* Value at position 'i' (which must be less than size()) */
+    value_type operator[](size_type i) const noexcept {
+        const std::uint8_t *p = bytes_.data() + samples_[i / sample_interval];
+        for (size_type skip = i % sample_interval; skip; skip--) {
+            p += codec_type::length_of(p);
+        }
+
+        value_type v;
+        codec_type::decode(p, v);
+        return v;
+    }
+
+    void push_back(value_type v) {
+        std::uint8_t encoded[codec_type::max_length];
+        const size_type len = codec_type::encode(encoded, v);
+        sample();
+        detail::growFor(bytes_, bytes_.size() + len);
+        bytes_.insert(bytes_.end(), encoded, encoded + len);
+        size_++;
+    }
+
+    void append(const value_type *values, size_type count) {
+        /* Size exactly, then encode in place: worst case space would be
+         * stranded in monotonic resources */
+        size_type offset = bytes_.size();
+        size_type encoded = 0;
+        for (size_type i = 0; i < count; i++) {
+            encoded += codec_type::length(values[i]);
+        }
+
+        detail::growFor(bytes_, offset + encoded);
+        detail::growFor(samples_, (size_ + count) / sample_interval + 1);
+        bytes_.resize(offset + encoded);
+        for (size_type i = 0; i < count; i++) {
+            if (!((size_ + i) % sample_interval)) {
+                samples_.push_back(offset);
+            }
+
+            offset += codec_type::encode(bytes_.data() + offset, values[i]);
+        }
+
+        size_ += count;
+    }
+
+#ifdef VARINT_HPP_SPAN
+    void append(std::span<const value_type> values) {
+        append(values.data(), values.size());
+    }
+#endif
+
+    const_iterator begin() const noexcept {
+        return const_iterator(bytes_.data());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(bytes_.data() + bytes_.size());
+    }
+
+  private:
+    /* Record the offset of the next value if it starts a sample */
+    void sample() {
+        if (!(size_ % sample_interval)) {
+            detail::growFor(samples_, samples_.size() + 1);
+            samples_.push_back(bytes_.size());
+        }
+    }
+
+    std::pmr::vector<std::uint8_t> bytes_;
+    std::pmr::vector<size_type> samples_;
+    size_type size_ = 0;
+};
+
+} // namespace varint
@@ -0,0 +1,176 @@
+#include "varintVector.hpp"
+
+#include "varintTagged.h"
+
+#include "ctest.h"
+
+#include <algorithm>
+#include <vector>
+
+#define COUNT 100000
+
+/* Upstream resource counting the allocations reaching it */
+class countingResource : public std::pmr::memory_resource {
+  public:
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+  private:
+    void *do_allocate(size_t n, size_t align) override {
+        allocations++;
+        bytes += n;
+        return std::pmr::new_delete_resource()->allocate(n, align);
+    }
+
+    void do_deallocate(void *p, size_t n, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, n, align);
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    int32_t err = 0;
+    ctestSeed(29);
+
+    TEST("packed_vector matches a flat array") {
+        countingResource counter;
+        varint::packed_vector<13> v{
+            varint::packed_vector<13>::allocator_type(&counter)};
+        std::vector<uint16_t> ref;
+        for (size_t i = 0; i < COUNT; i++) {
+            const uint16_t value = ctestRandom() & 0x1fff;
+            v.push_back(value);
+            ref.push_back(value);
+        }
+
+        /* Geometric growth: a logarithmic number of reallocations */
+        if (counter.allocations > 40) {
+            ERR("%zu allocations for %d pushes!", counter.allocations, COUNT);
+        }
+
+        std::vector<uint16_t> bulk(COUNT / 2);
+        for (auto &value : bulk) {
+            value = ctestRandom() & 0x1fff;
+        }
+
+        v.append(bulk.data(), bulk.size());
+        ref.insert(ref.end(), bulk.begin(), bulk.end());
+
+        if (v.size() != ref.size()) {
+            ERR("Size %zu, expected %zu!", v.size(), ref.size());
+        }
+
+        size_t i = 0;
+        for (const uint16_t value : v) {
+            if (value != ref[i] || v[i] != ref[i] ||
+                varint::packed<13>::get(v.data(), i) != ref[i]) {
+                ERR("Value %zu wrong!", i);
+                break;
+            }
+
+            i++;
+        }
+
+        v.set(7, 1234);
+        ref[7] = 1234;
+        if (*(v.begin() + 7) != 1234 || v.end() - v.begin() != (long)v.size()) {
+            ERRR("Iterator arithmetic failed!");
+        }
+
+        std::vector<uint16_t> out(ref.size() - 5);
+        v.copy_out(5, out.data(), out.size());
+        if (!std::equal(out.begin(), out.end(), ref.begin() + 5)) {
+            ERRR("copy_out differs!");
+        }
+
+        /* Shrinking then growing reads zeros, not stale bits */
+        v.resize(10);
+        v.resize(20);
+        for (size_t j = 10; j < 20; j++) {
+            if (v[j]) {
+                ERR("Regrown value %zu not zero!", j);
+            }
+        }
+    }
+
+    TEST("tagged_vector matches C encoding and samples positions") {
+        countingResource counter;
+        std::pmr::monotonic_buffer_resource arena(&counter);
+        varint::tagged_vector v{varint::tagged_vector::allocator_type(&arena)};
+        std::vector<uint64_t> ref;
+        std::vector<uint8_t> encoded;
+        for (size_t i = 0; i < COUNT; i++) {
+            const uint64_t value = ctestRandomWidth();
+            ref.push_back(value);
+            v.push_back(value);
+        }
+
+        std::vector<uint64_t> bulk(COUNT / 2 + 17);
+        for (auto &value : bulk) {
+            value = ctestRandomWidth();
+        }
+
+#ifdef VARINT_HPP_SPAN
+        v.append(std::span<const uint64_t>(bulk));
+#else
+        v.append(bulk.data(), bulk.size());
+#endif
+        ref.insert(ref.end(), bulk.begin(), bulk.end());
+
+        for (const uint64_t value : ref) {
+            uint8_t z[9];
+            const varintWidth len = varintTaggedPut64(z, value);
+            encoded.insert(encoded.end(), z, z + len);
+        }
+
+        if (v.size() != ref.size() || v.bytes() != encoded.size() ||
+            !std::equal(encoded.begin(), encoded.end(), v.data())) {
+            ERRR("Encoded stream differs from varintTaggedPut64()!");
+        }
+
+        for (size_t i = 0; i < ref.size(); i += 1 + ctestRandom() % 50) {
+            if (v[i] != ref[i]) {
+                ERR("Sampled lookup %zu wrong!", i);
+                break;
+            }
+        }
+
+        size_t i = 0;
+        for (const uint64_t value : v) {
+            if (i >= ref.size() || value != ref[i]) {
+                ERR("Iterated value %zu wrong!", i);
+                break;
+            }
+
+            i++;
+        }
+
+        if (i != ref.size()) {
+            ERR("Iterated %zu values, expected %zu!", i, ref.size());
+        }
+
+        /* Everything came from the arena's upstream */
+        if (!counter.allocations || v.get_allocator().resource() != &arena) {
+            ERRR("Storage didn't come from the arena!");
+        }
+
+        /* Bulk appends size exactly instead of reserving 9 bytes a value */
+        countingResource small;
+        varint::tagged_vector ones{
+            varint::tagged_vector::allocator_type(&small)};
+        const std::vector<uint64_t> oneByte(COUNT, 1);
+        ones.append(oneByte.data(), oneByte.size());
+        if (ones.bytes() != COUNT || small.bytes > 2 * COUNT) {
+            ERR("%zu bytes allocated for %zu one byte values!", small.bytes,
+                ones.bytes());
+        }
+    }
+
+    TEST_FINAL_RESULT;
+}